@@ -7,7 +7,25 @@ Config::Config()
       stepMs_(200),
       cellSize_(10),
       toroidal_(false),
-      showGrid_(true) {
+      showGrid_(true),
+      backend_(GameEngine::Backend::BitParallel),
+      hashLife_(false),
+      threads_(1),
+      rule_(),
+      ruleGiven_(false),
+      generations_(100),
+      generationsGiven_(false),
+      untilStable_(false),
+      census_(false),
+      outputPath_(""),
+      deltaLogPath_(""),
+      keyframeInterval_(1000),
+      reportFormat_("text"),
+      soups_(0),
+      seed_(1),
+      soupSize_(16),
+      boardSize_(256),
+      density_(0.5) {
 }
 
 bool Config::parse(int argc, char* argv[]) {
@@ -47,6 +65,80 @@ void Config::parseArgument(const std::string& arg) {
     else if (key == "--grid") {
         showGrid_ = (value == "1" || value == "true");
     }
+    else if (key == "--engine") {
+        hashLife_ = value == "hashlife";
+        if (!hashLife_) {
+            backend_ = GameEngine::parseBackend(value);
+        }
+    }
+    else if (key == "--threads") {
+        threads_ = std::stoi(value);
+        if (threads_ < 0) {
+            throw std::invalid_argument("threads must be 0 (all cores) or positive");
+        }
+    }
+    else if (key == "--rule") {
+        rule_ = Rule::parse(value);
+        ruleGiven_ = true;
+    }
+    else if (key == "--generations") {
+        generations_ = std::stoi(value);
+        if (generations_ < 0) {
+            throw std::invalid_argument("generations must be 0 (no limit) or positive");
+        }
+        generationsGiven_ = true;
+    }
+    else if (key == "--until-stable") {
+        untilStable_ = (value == "1" || value == "true");
+    }
+    else if (key == "--census") {
+        census_ = (value == "1" || value == "true");
+    }
+    else if (key == "--output") {
+        outputPath_ = value;
+    }
+    else if (key == "--delta-log") {
+        deltaLogPath_ = value;
+    }
+    else if (key == "--keyframe-interval") {
+        keyframeInterval_ = std::stoi(value);
+        if (keyframeInterval_ < 1) {
+            throw std::invalid_argument("keyframe-interval must be positive");
+        }
+    }
+    else if (key == "--report") {
+        if (value != "text" && value != "json" && value != "csv") {
+            throw std::invalid_argument("report must be text, json or csv");
+        }
+        reportFormat_ = value;
+    }
+    else if (key == "--soups") {
+        soups_ = std::stoi(value);
+        if (soups_ < 0) {
+            throw std::invalid_argument("soups must be 0 (no search) or positive");
+        }
+    }
+    else if (key == "--seed") {
+        seed_ = std::stoull(value);
+    }
+    else if (key == "--soup-size") {
+        soupSize_ = std::stoi(value);
+        if (soupSize_ < 1) {
+            throw std::invalid_argument("soup-size must be positive");
+        }
+    }
+    else if (key == "--board-size") {
+        boardSize_ = std::stoi(value);
+        if (boardSize_ < 1) {
+            throw std::invalid_argument("board-size must be positive");
+        }
+    }
+    else if (key == "--density") {
+        density_ = std::stod(value);
+        if (density_ < 0.0 || density_ > 1.0) {
+            throw std::invalid_argument("density must be between 0 and 1");
+        }
+    }
     else {
         throw std::invalid_argument("Unknown argument: " + key);
     }
@@ -54,6 +146,10 @@ void Config::parseArgument(const std::string& arg) {
 
 std::pair<std::string, std::string> Config::splitArgument(const std::string& arg) {
     size_t equalPos = arg.find('=');
+    // On/off switches may be given bare, e.g. --until-stable
+    if (equalPos == std::string::npos && (arg == "--until-stable" || arg == "--census" || arg == "--toroidal" || arg == "--grid")) {
+        return {arg, "1"};
+    }
     if (equalPos == std::string::npos) {
         throw std::invalid_argument("Invalid argument format (expected key=value): " + arg);
     }
@@ -65,19 +161,76 @@ std::pair<std::string, std::string> Config::splitArgument(const std::string& arg
 }
 
 bool Config::isValid() const {
-    return true; // File is optional, we'll create a default grid
+    // File is optional, we'll create a default grid
+    if (reportFormat_ == "csv" && soups_ == 0) {
+        std::cerr << "Error: --report=csv lists soups and needs --soups\n";
+        return false;
+    }
+    if (hashLife_) {
+        // HashLife jumps straight to the last generation of an unbounded B3/S23 universe
+        if (ruleGiven_ && rule_ != Rule()) {
+            std::cerr << "Error: --engine=hashlife only runs B3/S23, not " << rule_.toString() << "\n";
+            return false;
+        }
+        if (toroidal_ || untilStable_ || census_ || soups_ > 0 || !deltaLogPath_.empty()) {
+            std::cerr << "Error: --engine=hashlife runs an unbounded plane to a fixed generation and cannot be\n"
+                      << "used with --toroidal, --until-stable, --census, --soups or --delta-log\n";
+            return false;
+        }
+        if (generations_ == 0) {
+            std::cerr << "Error: --engine=hashlife needs a positive --generations\n";
+            return false;
+        }
+    }
+    if (soups_ > 0 && !deltaLogPath_.empty()) {
+        std::cerr << "Error: --delta-log records a single run and cannot be used with --soups\n";
+        return false;
+    }
+    if (soups_ > 0 && soupSize_ > boardSize_) {
+        std::cerr << "Error: soup-size cannot exceed board-size\n";
+        return false;
+    }
+    return true;
 }
 
 std::string Config::getUsage() {
     std::ostringstream oss;
     oss << "Usage: GameOfLife.exe [OPTIONS]\n\n";
     oss << "Options:\n";
-    oss << "  --file=PATH             Input file path (optional)\n";
+    oss << "  --file=PATH             Input grid: a 0/1 matrix, RLE or macrocell pattern, or a .golb/.golz\n";
+    oss << "                          snapshot resumed at its generation (optional)\n";
     oss << "  --step-ms=INT           Milliseconds between generations (default: 200)\n";
     oss << "  --cell-size=INT         Cell size in pixels (default: 10)\n";
     oss << "  --toroidal=0|1          Enable toroidal mode (default: 0)\n";
-    oss << "  --grid=0|1              Show grid lines (default: 1)\n\n";
+    oss << "  --grid=0|1              Show grid lines (default: 1)\n";
+    oss << "  --engine=NAME           Generation kernel: reference|bitparallel|tiled|lookup|incremental (default: bitparallel),\n";
+    oss << "                          or hashlife (console only: B3/S23 on an unbounded plane, jumping\n";
+    oss << "                          --generations at once)\n";
+    oss << "  --threads=INT           Worker threads for stepping, 0 = all cores (default: 1)\n";
+    oss << "  --rule=RULE             B/S rule such as B36/S23, B2/S/C3 for multi-state Generations rules,\n";
+    oss << "                          or a name like highlife or briansbrain (default: B3/S23,\n";
+    oss << "                          or the rule in an RLE file's header)\n\n";
+    oss << "Headless options (GameOfLife_Console.exe):\n";
+    oss << "  --generations=INT       Generations to run, 0 = no limit with --until-stable (default: 100)\n";
+    oss << "  --until-stable          Stop as soon as a generation changes nothing\n";
+    oss << "  --census                Report the objects (blocks, blinkers, gliders...) of the final grid\n";
+    oss << "  --output=PATH           Save the final grid to PATH, as RLE for .rle, macrocell for .mc, a\n";
+    oss << "                          snapshot for .golb (mapped) or .golz (compressed tiles)\n";
+    oss << "  --delta-log=PATH        Record every generation to PATH (.gold) as flipped cells,\n";
+    oss << "                          with a full keyframe every --keyframe-interval generations\n";
+    oss << "  --keyframe-interval=INT Most generations between delta log keyframes (default: 1000)\n";
+    oss << "  --report=text|json|csv  Report format; csv lists every soup (default: text)\n\n";
+    oss << "Soup search (GameOfLife_Console.exe):\n";
+    oss << "  --soups=INT             Run INT random soups instead of one grid, a soup per thread\n";
+    oss << "  --seed=INT              Seed of the first soup; soup i uses seed + i (default: 1)\n";
+    oss << "  --soup-size=INT         Side of each random soup (default: 16)\n";
+    oss << "  --board-size=INT        Side of the board the soup is centred on (default: 256)\n";
+    oss << "  --density=FLOAT         Chance of each soup cell being alive (default: 0.5)\n";
+    oss << "                          Each soup stops once it dies out or repeats; --generations caps\n";
+    oss << "                          it (default: 100000) and --census is always on\n\n";
     oss << "Example:\n";
     oss << "  GameOfLife.exe --file=patterns/glider.txt --cell-size=15\n";
+    oss << "  GameOfLife_Console.exe --file=patterns/gosper_glider_gun.txt --generations=10000 --threads=0 --report=json\n";
+    oss << "  GameOfLife_Console.exe --soups=10000 --threads=0 --report=csv > soups.csv\n";
     return oss.str();
 }
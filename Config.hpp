@@ -1,6 +1,8 @@
 #ifndef CONFIG_HPP
 #define CONFIG_HPP
 
+#include "GameEngine.hpp"
+#include <cstdint>
 #include <string>
 
 class Config {
@@ -13,6 +15,30 @@ public:
     int getCellSize() const { return cellSize_; }
     bool isToroidal() const { return toroidal_; }
     bool showGrid() const { return showGrid_; }
+    GameEngine::Backend getBackend() const { return backend_; }
+    // --engine=hashlife: HashLifeEngine on an unbounded plane (console only)
+    bool useHashLife() const { return hashLife_; }
+    int getThreads() const { return threads_; }
+    const Rule& getRule() const { return rule_; }
+    bool hasRule() const { return ruleGiven_; }
+    
+    // Headless runner (GameOfLife_Console)
+    int getGenerations() const { return generations_; }
+    bool runUntilStable() const { return untilStable_; }
+    bool takeCensus() const { return census_; }
+    std::string getOutputPath() const { return outputPath_; }
+    std::string getDeltaLogPath() const { return deltaLogPath_; }
+    int getKeyframeInterval() const { return keyframeInterval_; }
+    std::string getReportFormat() const { return reportFormat_; }
+    bool hasGenerations() const { return generationsGiven_; }
+    
+    // Soup search (GameOfLife_Console --soups=N)
+    int getSoups() const { return soups_; }
+    std::uint64_t getSeed() const { return seed_; }
+    int getSoupSize() const { return soupSize_; }
+    int getBoardSize() const { return boardSize_; }
+    double getDensity() const { return density_; }
+    
     bool isValid() const;
     static std::string getUsage();
 
@@ -22,6 +48,24 @@ private:
     int cellSize_;
     bool toroidal_;
     bool showGrid_;
+    GameEngine::Backend backend_;
+    bool hashLife_;
+    int threads_;
+    Rule rule_;
+    bool ruleGiven_;
+    int generations_;
+    bool generationsGiven_;
+    bool untilStable_;
+    bool census_;
+    std::string outputPath_;
+    std::string deltaLogPath_;
+    int keyframeInterval_;
+    std::string reportFormat_;
+    int soups_;
+    std::uint64_t seed_;
+    int soupSize_;
+    int boardSize_;
+    double density_;
     
     void parseArgument(const std::string& arg);
     static std::pair<std::string, std::string> splitArgument(const std::string& arg);
@@ -24,6 +24,7 @@ EnhancedGUIRenderer::EnhancedGUIRenderer(GameEngine& engine, const Config& confi
       showCellAge_(false),
       currentTheme_(Theme::NEON),
       maxCellAge_(0),
+      ageTick_(0),
       isPanning_(false),
       isDrawing_(false),
       isErasing_(false),
@@ -57,9 +58,13 @@ EnhancedGUIRenderer::EnhancedGUIRenderer(GameEngine& engine, const Config& confi
         static_cast<float>(window_.getSize().y) / 2.0f
     ));
     
+    // Cell ages are updated from the engine's per-step change list
+    // instead of rescanning the grid
+    engine_.setChangeTracking(true);
+    
     // Initialize cell ages
     const Grid& grid = engine_.getCurrentGrid();
-    cellAges_.resize(grid.getRows(), std::vector<int>(grid.getCols(), 0));
+    cellBirthTicks_.assign(static_cast<std::size_t>(grid.getRows()) * grid.getCols(), -1);
     
     // Initialize vertex array
     cellVertices_.setPrimitiveType(sf::PrimitiveType::Triangles);
@@ -216,9 +221,7 @@ void EnhancedGUIRenderer::handleKeyPress(sf::Keyboard::Key key) {
                 ));
                 
                 stats_ = Statistics();
-                cellAges_.clear();
-                cellAges_.resize(grid.getRows(), 
-                               std::vector<int>(grid.getCols(), 0));
+                cellBirthTicks_.assign(static_cast<std::size_t>(grid.getRows()) * grid.getCols(), -1);
                 patternDetector_.reset();
                 addToHistory();
             }
@@ -375,7 +378,7 @@ void EnhancedGUIRenderer::update(float deltaTime) {
             updateCellAges();
             
             // Update pattern detector to detect oscillators!
-            patternDetector_.update(engine_.getCurrentGrid(), engine_.getGeneration());
+            patternDetector_.update(engine_);
             
             // AUTO-PAUSE when pattern becomes stable!
             if (autoPauseOnStable_ && patternDetector_.isStable()) {
@@ -415,12 +418,10 @@ void EnhancedGUIRenderer::update(float deltaTime) {
 }
 
 void EnhancedGUIRenderer::updateStatistics() {
-    const Grid& grid = engine_.getCurrentGrid();
-    int newPop = grid.countLiving();
-    
-    stats_.births = std::max(0, newPop - stats_.population);
-    stats_.deaths = std::max(0, stats_.population - newPop);
-    stats_.population = newPop;
+    // The step kernels count these while writing the generation
+    stats_.births = engine_.getBirths();
+    stats_.deaths = engine_.getDeaths();
+    stats_.population = engine_.getPopulation();
     stats_.generation = engine_.getGeneration();
     
     stats_.maxPopulation = std::max(stats_.maxPopulation, stats_.population);
@@ -443,19 +444,38 @@ void EnhancedGUIRenderer::updateStatistics() {
 }
 
 void EnhancedGUIRenderer::updateCellAges() {
-    const Grid& grid = engine_.getCurrentGrid();
-    maxCellAge_ = 0;
+    // Multi-state rules keep their own packed per-cell state, which is
+    // drawn instead of ages, so skip this per-cell pass entirely
+    if (engine_.getCellStates()) {
+        maxCellAge_ = 0;
+        return;
+    }
     
-    for (int row = 0; row < grid.getRows(); ++row) {
-        for (int col = 0; col < grid.getCols(); ++col) {
-            if (grid.getCell(row, col)) {
-                cellAges_[row][col]++;
-                maxCellAge_ = std::max(maxCellAge_, cellAges_[row][col]);
-            } else {
-                cellAges_[row][col] = 0;
+    // Ages are kept as the tick each cell was born on, so surviving cells
+    // age without being touched; only births and deaths are written
+    const Grid& grid = engine_.getCurrentGrid();
+    int cols = grid.getCols();
+    std::size_t cells = static_cast<std::size_t>(grid.getRows()) * cols;
+    if (engine_.hasCompleteChanges() && cellBirthTicks_.size() == cells) {
+        for (const GameEngine::CellChange& change : engine_.getChanges()) {
+            cellBirthTicks_[static_cast<std::size_t>(change.row) * cols + change.col] =
+                change.alive ? ageTick_ : -1;
+        }
+    } else {
+        // Edited since the last step: rescan, keeping the age of cells still alive
+        cellBirthTicks_.resize(cells, -1);
+        for (int row = 0; row < grid.getRows(); ++row) {
+            for (int col = 0; col < cols; ++col) {
+                int& birth = cellBirthTicks_[static_cast<std::size_t>(row) * cols + col];
+                if (!grid.getCell(row, col)) {
+                    birth = -1;
+                } else if (birth < 0) {
+                    birth = ageTick_;
+                }
             }
         }
     }
+    ++ageTick_;
 }
 
 void EnhancedGUIRenderer::smoothZoom(float deltaTime) {
@@ -492,7 +512,12 @@ void EnhancedGUIRenderer::renderFrame() {
 
 void EnhancedGUIRenderer::buildVertexArrays() {
     const Grid& grid = engine_.getCurrentGrid();
+    const MultiStateGrid* states = engine_.getCellStates();
     cellVertices_.clear();
+    // Ages are normalised by the oldest cell of the previous frame
+    int oldestAge = 0;
+    bool agesValid = !states && cellBirthTicks_.size() ==
+                     static_cast<std::size_t>(grid.getRows()) * grid.getCols();
     
     // Add optimization: only render visible cells
     sf::FloatRect visibleArea(sf::Vector2f(panOffset_.x, panOffset_.y), 
@@ -501,7 +526,17 @@ void EnhancedGUIRenderer::buildVertexArrays() {
     
     for (int row = 0; row < grid.getRows(); ++row) {
         for (int col = 0; col < grid.getCols(); ++col) {
-            if (!grid.getCell(row, col)) continue;
+            // Under a multi-state rule, decaying cells (state 2 and up) are drawn too
+            bool alive = grid.getCell(row, col);
+            int state = alive ? 1 : (states ? states->getState(row, col) : 0);
+            if (!alive && state <= 1) continue;
+            
+            int age = 0;
+            if (alive && agesValid) {
+                int birth = cellBirthTicks_[static_cast<std::size_t>(row) * grid.getCols() + col];
+                age = birth < 0 ? 0 : ageTick_ - birth;
+                oldestAge = std::max(oldestAge, age);
+            }
             
             float x = col * cellSize_;
             float y = row * cellSize_;
@@ -512,10 +547,18 @@ void EnhancedGUIRenderer::buildVertexArrays() {
                 continue;
             }
             
-            float ageNormalized = maxCellAge_ > 0 ? (float)cellAges_[row][col] / maxCellAge_ : 0.0f;
+            float ageNormalized = maxCellAge_ > 0 ? std::min(1.0f, (float)age / maxCellAge_) : 0.0f;
             float pulse = 0.85f + 0.15f * std::sin(animationTime_ * 3.0f + row * 0.1f + col * 0.1f);
             
-            sf::Color color = getThemeColor(pulse, showCellAge_ ? ageNormalized : 0.0f);
+            sf::Color color;
+            if (state > 1) {
+                // Fade from the theme's age colour towards the background as the cell decays
+                float decay = static_cast<float>(state - 1) / (states->getStateCount() - 1);
+                color = getThemeColor(pulse * (1.0f - 0.7f * decay), 1.0f);
+                color.a = static_cast<std::uint8_t>(255 * (1.0f - 0.6f * decay));
+            } else {
+                color = getThemeColor(pulse, showCellAge_ ? ageNormalized : 0.0f);
+            }
             
             // Two triangles to form a square (SFML 3.0 uses Triangles instead of Quads)
             // Triangle 1
@@ -528,6 +571,7 @@ void EnhancedGUIRenderer::buildVertexArrays() {
             cellVertices_.append(sf::Vertex(sf::Vector2f(x, y + cellSize_), color));
         }
     }
+    maxCellAge_ = oldestAge;
 }
 
 void EnhancedGUIRenderer::renderCells() {
@@ -847,7 +891,7 @@ void EnhancedGUIRenderer::initializeButtons() {
             engine_.step();
             updateCellAges();
             updateStatistics();
-            patternDetector_.update(engine_.getCurrentGrid(), engine_.getGeneration());
+            patternDetector_.update(engine_);
         }
     });
     buttons_.push_back(std::move(stepBtn));
@@ -61,8 +61,10 @@ private:
     bool showCellAge_;
     Theme currentTheme_;
     
-    std::vector<std::vector<int>> cellAges_;
+    // Per cell, the ageTick_ it was born on (-1 while dead)
+    std::vector<int> cellBirthTicks_;
     int maxCellAge_;
+    int ageTick_;
     
     sf::Vector2i lastMousePos_;
     bool isPanning_;
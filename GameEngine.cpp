@@ -1,33 +1,199 @@
 #include "GameEngine.hpp"
+#include "LifeKernels.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <stdexcept>
 
 GameEngine::GameEngine(const Grid& initialGrid, bool toroidal)
-    : initialGrid_(std::make_unique<Grid>(initialGrid)),
-      currentGrid_(std::make_unique<Grid>(initialGrid)),
-      previousGrid_(std::make_unique<Grid>(initialGrid.getRows(), initialGrid.getCols())),
+    : GameEngine(Grid(initialGrid), toroidal) {
+}
+
+GameEngine::GameEngine(Grid&& initialGrid, bool toroidal)
+    : currentGrid_(std::make_unique<Grid>(std::move(initialGrid))),
       generation_(0),
       toroidal_(toroidal),
-      isStable_(false) {
+      isStable_(false),
+      backend_(Backend::BitParallel),
+      deltaValid_(false),
+      tileRows_(0),
+      tileCols_(0),
+      activeWordCount_(0),
+      population_(0),
+      births_(0),
+      deaths_(0),
+      populationValid_(false),
+      stateHashValid_(false),
+      trackChanges_(false),
+      changesComplete_(false),
+      gridEdited_(true) {
+    // A mapped snapshot is stepped in place; its reset() state is a second
+    // mapping, so neither copy reads the payload up front
+    initialGrid_ = currentGrid_->reopenStorage();
+    if (!initialGrid_) {
+        initialGrid_ = std::make_unique<Grid>(*currentGrid_);
+    }
+}
+
+GameEngine::GameEngine(int rows, int cols, bool toroidal)
+    : GameEngine(Grid(rows, cols), toroidal) {
+}
+
+GameEngine::~GameEngine() = default;
+
+namespace {
+
+// Appends one change per set bit of diff, the flipped cells of word w of row
+void appendChanges(std::vector<GameEngine::CellChange>& changes, int row, int w,
+                   Grid::Word diff, Grid::Word after) {
+    while (diff) {
+        int bit = std::countr_zero(diff);
+        changes.push_back({row, w * Grid::kWordBits + bit, ((after >> bit) & 1) != 0});
+        diff &= diff - 1;
+    }
+}
+
+// Step counts summed across pool workers, one update per band or chunk
+struct SharedCounts {
+    std::atomic<std::int64_t> births{0};
+    std::atomic<std::int64_t> deaths{0};
+    
+    void add(const LifeKernels::StepCounts& counts) {
+        births.fetch_add(counts.births, std::memory_order_relaxed);
+        deaths.fetch_add(counts.deaths, std::memory_order_relaxed);
+    }
+    void addTo(LifeKernels::StepCounts& counts) const {
+        counts.births += births.load(std::memory_order_relaxed);
+        counts.deaths += deaths.load(std::memory_order_relaxed);
+    }
+};
+
+} // namespace
+
+void GameEngine::setThreadCount(int threads) {
+    int resolved = ThreadPool::resolveThreadCount(threads);
+    if (resolved == getThreadCount()) {
+        return;
+    }
+    pool_ = resolved > 1 ? std::make_unique<ThreadPool>(resolved) : nullptr;
+}
+
+void GameEngine::setRule(const Rule& rule) {
+    rule_ = rule;
+    deltaValid_ = false;
+    isStable_ = false;
+    if (!rule.isMultiState()) {
+        states_.reset();
+        nextStates_.reset();
+    } else if (!states_ || states_->getStateCount() != rule.getStateCount()) {
+        resetCellStates();
+    }
+}
+
+void GameEngine::setCellStates(const MultiStateGrid& states) {
+    if (!states_ || states.getStateCount() != rule_.getStateCount()) {
+        throw std::invalid_argument("Cell states need a multi-state rule with the same state count");
+    }
+    if (states.getRows() != currentGrid_->getRows() ||
+        states.getCols() != currentGrid_->getCols()) {
+        throw std::invalid_argument("Grid dimensions must match");
+    }
+    *states_ = states;
+    *currentGrid_ = states.toGrid();
+    markEdited();
+    isStable_ = false;
+}
+
+void GameEngine::resetCellStates() {
+    // Live cells start in state 1; any earlier decay is forgotten
+    const Grid& grid = *currentGrid_;
+    int states = rule_.getStateCount();
+    states_ = std::make_unique<MultiStateGrid>(grid, states);
+    nextStates_ = std::make_unique<MultiStateGrid>(grid.getRows(), grid.getCols(), states);
 }
 
 void GameEngine::step() {
-    *previousGrid_ = *currentGrid_;
-    auto nextGrid = computeNextGeneration();
+    ensureBufferShape();
+    bool edited = gridEdited_;
+    gridEdited_ = false;
+    bool incremental = backend_ == Backend::Incremental && !states_;
+    if (!populationValid_) {
+        population_ = currentGrid_->countLiving();
+        populationValid_ = true;
+    }
     
-    if (*nextGrid == *currentGrid_) {
-        isStable_ = true;
+    // Ping-pong: every path overwrites the older buffer with the next
+    // generation and sets isStable_
+    LifeKernels::StepCounts counts;
+    if (states_) {
+        stepMultiState(counts);
+    } else if (backend_ == Backend::Tiled) {
+        stepTiled(counts);
+    } else if (incremental) {
+        stepIncremental(counts);  // Keeps its own change list
     } else {
-        isStable_ = false;
+        isStable_ = !computeNextGeneration(*previousGrid_, counts);
     }
+    births_ = static_cast<int>(counts.births);
+    deaths_ = static_cast<int>(counts.deaths);
+    population_ += births_ - deaths_;
     
-    currentGrid_ = std::move(nextGrid);
+    if (!incremental) {
+        changes_.clear();
+        if (trackChanges_) {
+            recordChanges(*currentGrid_, *previousGrid_);
+        }
+    }
+    changesComplete_ = (incremental || trackChanges_) && !edited;
+    if (stateHashValid_ && !isStable_) {
+        if (incremental || trackChanges_) {
+            // changedWords_ lists every word that differs between the buffers
+            const Grid::Word* before = currentGrid_->data();
+            const Grid::Word* after = previousGrid_->data();
+            for (std::uint32_t index : changedWords_) {
+                stateHash_.replaceWord(index, before[index], after[index]);
+            }
+        } else {
+            stateHashValid_ = false;
+        }
+    }
+    std::swap(currentGrid_, previousGrid_);
     ++generation_;
 }
 
+const GridHash& GameEngine::getStateHash() const {
+    if (!stateHashValid_) {
+        stateHash_ = GridHash::of(*currentGrid_);
+        stateHashValid_ = true;
+    }
+    return stateHash_;
+}
+
+void GameEngine::ensureBufferShape() {
+    // Allocated on the first step rather than with the engine
+    if (!previousGrid_) {
+        previousGrid_ = std::make_unique<Grid>(currentGrid_->getRows(), currentGrid_->getCols());
+        return;
+    }
+    // Only differs after the caller resized the grid (e.g. loadFromFile)
+    if (previousGrid_->getRows() != currentGrid_->getRows() ||
+        previousGrid_->getCols() != currentGrid_->getCols()) {
+        *previousGrid_ = Grid(currentGrid_->getRows(), currentGrid_->getCols());
+        markEdited();
+        if (states_) {
+            resetCellStates();
+        }
+    }
+}
+
 void GameEngine::reset() {
     *currentGrid_ = *initialGrid_;
-    *previousGrid_ = Grid(initialGrid_->getRows(), initialGrid_->getCols());
     generation_ = 0;
     isStable_ = false;
+    markEdited();
+    if (states_) {
+        resetCellStates();
+    }
 }
 
 void GameEngine::setCurrentGrid(const Grid& grid) {
@@ -36,28 +202,334 @@ void GameEngine::setCurrentGrid(const Grid& grid) {
         throw std::invalid_argument("Grid dimensions must match");
     }
     *currentGrid_ = grid;
+    markEdited();
+    if (states_) {
+        resetCellStates();
+    }
+}
+
+void GameEngine::collectActiveTiles() {
+    activeTiles_.clear();
+    int tileCount = tileRows_ * tileCols_;
+    if (!deltaValid_) {
+        for (int tile = 0; tile < tileCount; ++tile) {
+            activeTiles_.push_back(tile);
+        }
+        return;
+    }
+    
+    // A tile needs evaluating if it or any of its 8 neighbours changed
+    for (int tileRow = 0; tileRow < tileRows_; ++tileRow) {
+        for (int tileCol = 0; tileCol < tileCols_; ++tileCol) {
+            bool active = false;
+            for (int dr = -1; dr <= 1 && !active; ++dr) {
+                for (int dc = -1; dc <= 1 && !active; ++dc) {
+                    int r = tileRow + dr;
+                    int c = tileCol + dc;
+                    if (toroidal_) {
+                        r = (r + tileRows_) % tileRows_;
+                        c = (c + tileCols_) % tileCols_;
+                    } else if (r < 0 || r >= tileRows_ || c < 0 || c >= tileCols_) {
+                        continue;
+                    }
+                    active = tileChanged_[r * tileCols_ + c] != 0;
+                }
+            }
+            if (active) {
+                activeTiles_.push_back(tileRow * tileCols_ + tileCol);
+            }
+        }
+    }
+}
+
+void GameEngine::stepTiled(LifeKernels::StepCounts& counts) {
+    const Grid& current = *currentGrid_;
+    int rows = current.getRows();
+    
+    if (!deltaValid_) {
+        tileRows_ = (rows + LifeKernels::kTileRows - 1) / LifeKernels::kTileRows;
+        tileCols_ = current.getWordsPerRow();
+        tileChanged_.assign(static_cast<std::size_t>(tileRows_) * tileCols_, 1);
+        activeTiles_.reserve(tileChanged_.size());
+    }
+    collectActiveTiles();
+    
+    // previousGrid_ holds the generation before current; every tile skipped
+    // here did not change last step, so its words there are already correct
+    Grid& next = *previousGrid_;
+    bool toroidal = toroidal_;
+    const Rule& rule = rule_;
+    auto runTile = [&](int index, LifeKernels::StepCounts& tileCounts) {
+        int tile = activeTiles_[index];
+        tileChanged_[tile] = LifeKernels::stepTile(current, next, tile / tileCols_,
+                                                   tile % tileCols_, toroidal, rule, &tileCounts);
+    };
+    int activeCount = static_cast<int>(activeTiles_.size());
+    if (pool_) {
+        SharedCounts shared;
+        pool_->parallelFor(activeCount, [&](int index) {
+            LifeKernels::StepCounts tileCounts;
+            runTile(index, tileCounts);
+            shared.add(tileCounts);
+        });
+        shared.addTo(counts);
+    } else {
+        for (int index = 0; index < activeCount; ++index) {
+            runTile(index, counts);
+        }
+    }
+    
+    isStable_ = true;
+    for (int tile : activeTiles_) {
+        if (tileChanged_[tile]) {
+            isStable_ = false;
+            break;
+        }
+    }
+    deltaValid_ = true;
+}
+
+void GameEngine::stepIncremental(LifeKernels::StepCounts& counts) {
+    const Grid& current = *currentGrid_;
+    Grid& next = *previousGrid_;
+    bool toroidal = toroidal_;
+    const Rule& rule = rule_;
+    
+    std::size_t wordCount = static_cast<std::size_t>(current.getRows()) * current.getWordsPerRow();
+    // With nothing known about the last step, or most words active anyway,
+    // the row kernel over every word beats evaluating the queue word by word
+    if (!deltaValid_ || activeWords_.size() * 4 > wordCount) {
+        forEachRowBand([&](int rowBegin, int rowEnd, LifeKernels::StepCounts& bandCounts) {
+            return LifeKernels::stepRows(current, next, rowBegin, rowEnd, toroidal, rule, &bandCounts);
+        }, counts);
+        wordQueued_.assign(wordCount, 0);
+        activeWords_.reserve(wordCount);
+        changedWords_.reserve(wordCount);
+        activeWordCount_ = static_cast<int>(wordCount);
+        recordChanges(current, next);
+    } else {
+        // previousGrid_ holds the generation before current. A word that is
+        // not queued did not change last step and neither did any cell
+        // around it, so its word there already holds the next generation
+        int count = static_cast<int>(activeWords_.size());
+        const int chunkWords = 4096;
+        if (pool_ && count > chunkWords) {
+            int chunks = (count + chunkWords - 1) / chunkWords;
+            SharedCounts shared;
+            pool_->parallelFor(chunks, [&](int chunk) {
+                int begin = chunk * chunkWords;
+                LifeKernels::StepCounts chunkCounts;
+                LifeKernels::stepWords(current, next, activeWords_.data() + begin,
+                                       std::min(chunkWords, count - begin), toroidal, rule, &chunkCounts);
+                shared.add(chunkCounts);
+            });
+            shared.addTo(counts);
+        } else {
+            LifeKernels::stepWords(current, next, activeWords_.data(), activeWords_.size(),
+                                   toroidal, rule, &counts);
+        }
+        for (std::uint32_t index : activeWords_) {
+            wordQueued_[index] = 0;
+        }
+        activeWordCount_ = count;
+        recordChanges(current, next, activeWords_);
+    }
+    
+    queueAroundChanges(current, next);
+    isStable_ = changes_.empty();
+    deltaValid_ = true;
+}
+
+void GameEngine::recordChanges(const Grid& before, const Grid& after) {
+    changes_.clear();
+    changedWords_.clear();
+    int words = before.getWordsPerRow();
+    for (int row = 0; row < before.getRows(); ++row) {
+        const Grid::Word* was = before.rowWords(row);
+        const Grid::Word* now = after.rowWords(row);
+        for (int w = 0; w < words; ++w) {
+            if (Grid::Word diff = was[w] ^ now[w]) {
+                changedWords_.push_back(static_cast<std::uint32_t>(row * words + w));
+                appendChanges(changes_, row, w, diff, now[w]);
+            }
+        }
+    }
+}
+
+void GameEngine::recordChanges(const Grid& before, const Grid& after,
+                               const std::vector<std::uint32_t>& words) {
+    changes_.clear();
+    changedWords_.clear();
+    int wordsPerRow = before.getWordsPerRow();
+    for (std::uint32_t index : words) {
+        int row = static_cast<int>(index / wordsPerRow);
+        int w = static_cast<int>(index % wordsPerRow);
+        Grid::Word now = after.rowWords(row)[w];
+        if (Grid::Word diff = before.rowWords(row)[w] ^ now) {
+            changedWords_.push_back(index);
+            appendChanges(changes_, row, w, diff, now);
+        }
+    }
+}
+
+void GameEngine::queueAroundChanges(const Grid& before, const Grid& after) {
+    int rows = before.getRows();
+    int words = before.getWordsPerRow();
+    int lastBit = (before.getCols() - 1) & 63;
+    auto queue = [&](int row, int w) {
+        std::uint32_t index = static_cast<std::uint32_t>(row * words + w);
+        if (!wordQueued_[index]) {
+            wordQueued_[index] = 1;
+            activeWords_.push_back(index);
+        }
+    };
+    
+    activeWords_.clear();
+    for (std::uint32_t index : changedWords_) {
+        int row = static_cast<int>(index / words);
+        int w = static_cast<int>(index % words);
+        Grid::Word diff = before.rowWords(row)[w] ^ after.rowWords(row)[w];
+        // A flipped first or last column also reaches the word on that side
+        int west = -1;
+        int east = -1;
+        if (diff & 1) {
+            west = w > 0 ? w - 1 : (toroidal_ ? words - 1 : -1);
+        }
+        if (w + 1 < words) {
+            east = (diff >> 63) ? w + 1 : -1;
+        } else if (toroidal_ && ((diff >> lastBit) & 1)) {
+            east = 0;
+        }
+        for (int dr = -1; dr <= 1; ++dr) {
+            int r = row + dr;
+            if (toroidal_) {
+                r = (r + rows) % rows;
+            } else if (r < 0 || r >= rows) {
+                continue;
+            }
+            queue(r, w);
+            if (west >= 0) {
+                queue(r, west);
+            }
+            if (east >= 0) {
+                queue(r, east);
+            }
+        }
+    }
+    // Row-major order keeps the next change list sorted
+    std::sort(activeWords_.begin(), activeWords_.end());
+}
+
+template <typename Fn>
+bool GameEngine::forEachRowBand(const Fn& stepBand, LifeKernels::StepCounts& counts) const {
+    int rows = currentGrid_->getRows();
+    if (!pool_) {
+        return stepBand(0, rows, counts);
+    }
+    // A few bands per thread so uneven rows still balance; bands only
+    // write their own rows, so no synchronisation is needed inside a step
+    const int minBandRows = 16;
+    int bands = std::clamp(rows / minBandRows, 1, pool_->getThreadCount() * 4);
+    std::atomic<bool> changed(false);
+    SharedCounts shared;
+    pool_->parallelFor(bands, [&](int band) {
+        int rowBegin = static_cast<int>(static_cast<long long>(rows) * band / bands);
+        int rowEnd = static_cast<int>(static_cast<long long>(rows) * (band + 1) / bands);
+        LifeKernels::StepCounts bandCounts;
+        if (stepBand(rowBegin, rowEnd, bandCounts)) {
+            changed.store(true, std::memory_order_relaxed);
+        }
+        shared.add(bandCounts);
+    });
+    shared.addTo(counts);
+    return changed.load(std::memory_order_relaxed);
+}
+
+void GameEngine::stepMultiState(LifeKernels::StepCounts& counts) {
+    const Grid& alive = *currentGrid_;
+    Grid& nextAlive = *previousGrid_;
+    const MultiStateGrid& states = *states_;
+    MultiStateGrid& nextStates = *nextStates_;
+    bool toroidal = toroidal_;
+    const Rule& rule = rule_;
+    
+    // State 1 is an ordinary Life-like plane; the packed pass then blocks
+    // births on dying cells and ages them, so it also counts the live plane
+    isStable_ = !forEachRowBand([&](int rowBegin, int rowEnd, LifeKernels::StepCounts& bandCounts) {
+        LifeKernels::stepRows(alive, nextAlive, rowBegin, rowEnd, toroidal, rule);
+        return LifeKernels::stepStateRows(alive, nextAlive, states, nextStates, rowBegin, rowEnd,
+                                          &bandCounts);
+    }, counts);
+    std::swap(states_, nextStates_);
+    deltaValid_ = false;
 }
 
-std::unique_ptr<Grid> GameEngine::computeNextGeneration() const {
+bool GameEngine::computeNextGeneration(Grid& next, LifeKernels::StepCounts& counts) const {
     int rows = currentGrid_->getRows();
     int cols = currentGrid_->getCols();
-    auto nextGrid = std::make_unique<Grid>(rows, cols);
     
+    if (backend_ == Backend::BitParallel || backend_ == Backend::Lookup) {
+        const Grid& current = *currentGrid_;
+        bool toroidal = toroidal_;
+        const Rule& rule = rule_;
+        const LifeKernels::BlockTable* table =
+            backend_ == Backend::Lookup ? &LifeKernels::blockTable(rule_) : nullptr;
+        return forEachRowBand([&](int rowBegin, int rowEnd, LifeKernels::StepCounts& bandCounts) {
+            return table ? LifeKernels::stepRowsLookup(current, next, rowBegin, rowEnd, toroidal, *table,
+                                                       &bandCounts)
+                         : LifeKernels::stepRows(current, next, rowBegin, rowEnd, toroidal, rule,
+                                                 &bandCounts);
+        }, counts);
+    }
+    
+    bool changed = false;
     for (int row = 0; row < rows; ++row) {
         for (int col = 0; col < cols; ++col) {
             int neighbors = currentGrid_->countNeighbors(row, col, toroidal_);
             bool isAlive = currentGrid_->getCell(row, col);
+            bool willBeAlive = rule_.nextState(isAlive, neighbors);
             
-            bool willBeAlive = false;
-            if (isAlive) {
-                willBeAlive = (neighbors == 2 || neighbors == 3);
-            } else {
-                willBeAlive = (neighbors == 3);
-            }
-            
-            nextGrid->setCell(row, col, willBeAlive);
+            next.setCell(row, col, willBeAlive);
+            changed = changed || willBeAlive != isAlive;
+            counts.births += willBeAlive && !isAlive;
+            counts.deaths += isAlive && !willBeAlive;
         }
     }
     
-    return nextGrid;
+    return changed;
+}
+
+GameEngine::Backend GameEngine::parseBackend(const std::string& name) {
+    if (name == "reference") {
+        return Backend::Reference;
+    }
+    if (name == "bitparallel") {
+        return Backend::BitParallel;
+    }
+    if (name == "tiled") {
+        return Backend::Tiled;
+    }
+    if (name == "lookup") {
+        return Backend::Lookup;
+    }
+    if (name == "incremental") {
+        return Backend::Incremental;
+    }
+    throw std::invalid_argument("Unknown engine backend: " + name);
+}
+
+std::string GameEngine::backendName(Backend backend) {
+    switch (backend) {
+        case Backend::Reference:
+            return "reference";
+        case Backend::BitParallel:
+            return "bitparallel";
+        case Backend::Tiled:
+            return "tiled";
+        case Backend::Lookup:
+            return "lookup";
+        case Backend::Incremental:
+            return "incremental";
+    }
+    return "unknown";
 }
@@ -2,33 +2,232 @@
 #define GAME_ENGINE_HPP
 
 #include "Grid.hpp"
+#include "GridHash.hpp"
+#include "MultiStateGrid.hpp"
+#include "Rule.hpp"
+#include "ThreadPool.hpp"
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
+
+namespace LifeKernels {
+struct StepCounts;
+}
 
 class GameEngine {
 public:
+    /**
+     * @brief Generation kernel used by step()
+     *
+     * Reference evaluates every cell through Grid::countNeighbors();
+     * BitParallel advances 64 cells per word operation; Tiled runs the
+     * same kernel on 64x64 tiles and skips tiles whose neighbourhood did
+     * not change last generation; Lookup reads each 2x2 block's next
+     * state from a 64K table indexed by its 4x4 neighbourhood;
+     * Incremental keeps the cells that flipped last generation and only
+     * re-evaluates the words around them. All produce identical grids.
+     */
+    enum class Backend {
+        Reference,
+        BitParallel,
+        Tiled,
+        Lookup,
+        Incremental
+    };
+    
+    /// A cell flipped by step()
+    struct CellChange {
+        int row;
+        int col;
+        bool alive;  // true for a birth, false for a death
+    };
+    
     explicit GameEngine(const Grid& initialGrid, bool toroidal = false);
+    // Keeps initialGrid itself as the reset() state, so a memory-mapped
+    // snapshot stays file-backed instead of being copied twice
+    explicit GameEngine(Grid&& initialGrid, bool toroidal = false);
+    GameEngine(int rows, int cols, bool toroidal = false);
+    ~GameEngine();
     
     void step();
     void reset();
     void resetGeneration() { generation_ = 0; isStable_ = false; }
+    void setGeneration(int generation) { generation_ = generation; }  // Resuming a snapshot
     const Grid& getCurrentGrid() const { return *currentGrid_; }
-    Grid& getCurrentGridMutable() { return *currentGrid_; }
+    Grid& getCurrentGridMutable() { markEdited(); return *currentGrid_; }
     const Grid& getInitialGrid() const { return *initialGrid_; }
     int getGeneration() const { return generation_; }
     bool isStable() const { return isStable_; }
-    void setToroidal(bool toroidal) { toroidal_ = toroidal; }
+    void setToroidal(bool toroidal) { toroidal_ = toroidal; deltaValid_ = false; }
     bool isToroidal() const { return toroidal_; }
     void setCurrentGrid(const Grid& grid);
+    void setBackend(Backend backend) { backend_ = backend; deltaValid_ = false; }
+    Backend getBackend() const { return backend_; }
+    
+    /**
+     * @brief Birth/survival rule applied by every backend (default B3/S23)
+     *
+     * A multi-state (Generations) rule also keeps a packed MultiStateGrid
+     * of every cell's state and steps it with the bit-parallel kernels
+     * whatever the backend; getCurrentGrid() then holds the state-1 cells.
+     */
+    void setRule(const Rule& rule);
+    const Rule& getRule() const { return rule_; }
+    
+    /// Cell states under a multi-state rule, nullptr for two-state rules.
+    /// Direct edits to the current grid take precedence over state 1.
+    const MultiStateGrid* getCellStates() const { return states_.get(); }
+    /**
+     * @brief Replaces the current generation's states, e.g. after loading a file
+     * @throws std::invalid_argument unless a multi-state rule with the same
+     *         state count is set and the dimensions match
+     */
+    void setCellStates(const MultiStateGrid& states);
+    
+    /**
+     * @brief Sets the number of threads used by the BitParallel backend
+     *
+     * The grid is split into horizontal row bands processed by a persistent
+     * pool; bands read their halo rows straight from the shared current
+     * grid, so the result is bit-identical to a serial step. 1 runs
+     * serially, 0 uses every hardware thread.
+     */
+    void setThreadCount(int threads);
+    int getThreadCount() const { return pool_ ? pool_->getThreadCount() : 1; }
+    
+    /// Tiles evaluated by the last Tiled step (all tiles after any external edit).
+    int getActiveTileCount() const { return static_cast<int>(activeTiles_.size()); }
+    
+    /// Words evaluated by the last Incremental step (all words after an edit or when most were active).
+    int getActiveWordCount() const { return activeWordCount_; }
+    
+    /**
+     * @brief Cells flipped by the last step(), in row-major order
+     *
+     * Always kept by the Incremental backend; the other backends fill it
+     * once setChangeTracking(true) is called, at the cost of one extra
+     * pass over the packed words per step. Under a multi-state rule only
+     * the live plane (state 1) is covered.
+     */
+    const std::vector<CellChange>& getChanges() const { return changes_; }
+    /**
+     * @brief True when getChanges() accounts for every difference between
+     *        the grid before the last step() and the current one
+     *
+     * False before the first step, when changes are not tracked, and after
+     * any edit, reset() or setCurrentGrid() until the next step following
+     * it; callers must then rescan the grid instead of applying the deltas.
+     */
+    bool hasCompleteChanges() const { return changesComplete_; }
+    void setChangeTracking(bool enabled) { trackChanges_ = enabled; changesComplete_ = false; }
+    bool isTrackingChanges() const { return trackChanges_; }
+    
+    /**
+     * @brief Live cells in the current grid
+     *
+     * Carried forward from the births and deaths each kernel popcounts
+     * while writing the next generation; the grid is only recounted after
+     * an edit. Under a multi-state rule this counts state-1 cells.
+     */
+    int getPopulation() const { return populationValid_ ? population_ : currentGrid_->countLiving(); }
+    /// Cells born and cells that died in the last step()
+    int getBirths() const { return births_; }
+    int getDeaths() const { return deaths_; }
+    
+    /**
+     * @brief 128-bit hash of the current grid, for cycle detection
+     *
+     * Updated from the changed words whenever the step records a change
+     * list (Incremental backend or setChangeTracking(true)) and left as is
+     * by a step that changed nothing; otherwise rehashed over the packed
+     * words on the next call.
+     */
+    const GridHash& getStateHash() const;
+    
+    static Backend parseBackend(const std::string& name);
+    static std::string backendName(Backend backend);
 
 private:
     std::unique_ptr<Grid> initialGrid_;
+    // Double buffer: step() writes into previousGrid_ and swaps, so no
+    // grid is allocated or copied per generation (previousGrid_ is null
+    // until the first step)
     std::unique_ptr<Grid> currentGrid_;
     std::unique_ptr<Grid> previousGrid_;
     int generation_;
     bool toroidal_;
     bool isStable_;
+    Backend backend_;
+    Rule rule_;
+    std::unique_ptr<ThreadPool> pool_;
+    
+    // Multi-state rules only: packed states, double-buffered like the grids
+    std::unique_ptr<MultiStateGrid> states_;
+    std::unique_ptr<MultiStateGrid> nextStates_;
+    
+    // What changed last generation is only trusted by the Tiled and
+    // Incremental backends while deltaValid_ is set; anything that edits
+    // the grid behind the engine's back clears it
+    bool deltaValid_;
+    
+    // Tiled backend: one flag per 64x64 tile that changed last generation
+    int tileRows_;
+    int tileCols_;
+    std::vector<std::uint8_t> tileChanged_;
+    std::vector<int> activeTiles_;
+    
+    // Incremental backend: words to evaluate next step (sorted, row * words
+    // + column), with a flag per word so each is queued once. All buffers
+    // are sized on the first full pass and only grow afterwards
+    std::vector<std::uint32_t> activeWords_;
+    std::vector<std::uint8_t> wordQueued_;
+    std::vector<std::uint32_t> changedWords_;
+    int activeWordCount_;
+    
+    // Running population; births_ and deaths_ are the last step's
+    int population_;
+    int births_;
+    int deaths_;
+    bool populationValid_;
+    
+    // Hash of the current grid, computed lazily while stateHashValid_ is clear
+    mutable GridHash stateHash_;
+    mutable bool stateHashValid_;
+    
+    // Change list; gridEdited_ records edits made since the last step
+    std::vector<CellChange> changes_;
+    bool trackChanges_;
+    bool changesComplete_;
+    bool gridEdited_;
     
-    std::unique_ptr<Grid> computeNextGeneration() const;
+    // Each step path writes the next generation into the older buffer and
+    // adds its births and deaths to counts; false if nothing changed
+    bool computeNextGeneration(Grid& next, LifeKernels::StepCounts& counts) const;
+    void ensureBufferShape();
+    void stepTiled(LifeKernels::StepCounts& counts);
+    void stepIncremental(LifeKernels::StepCounts& counts);
+    void stepMultiState(LifeKernels::StepCounts& counts);
+    void resetCellStates();
+    // Runs stepBand(rowBegin, rowEnd, bandCounts) over the whole grid, in
+    // parallel row bands when a pool is set, summing the bands' counts;
+    // true if any band reported a change
+    template <typename Fn>
+    bool forEachRowBand(const Fn& stepBand, LifeKernels::StepCounts& counts) const;
+    void collectActiveTiles();
+    // Lists the cells flipped between before and after, over all words or
+    // only the given ones, in changes_ and the changed words in changedWords_
+    void recordChanges(const Grid& before, const Grid& after);
+    void recordChanges(const Grid& before, const Grid& after, const std::vector<std::uint32_t>& words);
+    // Queues the words around every changed word for the next Incremental step
+    void queueAroundChanges(const Grid& before, const Grid& after);
+    void markEdited() {
+        deltaValid_ = false;
+        gridEdited_ = true;
+        changesComplete_ = false;
+        populationValid_ = false;
+        stateHashValid_ = false;
+    }
 };
 
 #endif
@@ -4,46 +4,122 @@
 #include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <bit>
 
-Grid::Grid(int rows, int cols) 
-    : rows_(rows), cols_(cols), cells_(rows, std::vector<bool>(cols, false)) {
+Grid::Grid(int rows, int cols)
+    : rows_(0), cols_(0), wordsPerRow_(0), lastWordMask_(0), words_(nullptr) {
     if (rows <= 0 || cols <= 0) {
         throw std::invalid_argument("Grid dimensions must be positive");
     }
+    resize(rows, cols);
 }
 
-Grid::Grid(const Grid& other) 
-    : rows_(other.rows_), cols_(other.cols_), cells_(other.cells_) {
+Grid::Grid(int rows, int cols, std::unique_ptr<ExternalStorage> storage)
+    : rows_(0), cols_(0), wordsPerRow_(0), lastWordMask_(0), words_(nullptr) {
+    if (rows <= 0 || cols <= 0) {
+        throw std::invalid_argument("Grid dimensions must be positive");
+    }
+    if (!storage) {
+        throw std::invalid_argument("External grid storage is missing");
+    }
+    setShape(rows, cols);
+    external_ = std::move(storage);
+    words_ = external_->words();
+}
+
+Grid::Grid(const Grid& other)
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      wordsPerRow_(other.wordsPerRow_),
+      lastWordMask_(other.lastWordMask_),
+      owned_(other.words_, other.words_ + other.bufferWords()),
+      words_(owned_.data()) {
+}
+
+Grid::Grid(Grid&& other) noexcept
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      wordsPerRow_(other.wordsPerRow_),
+      lastWordMask_(other.lastWordMask_),
+      owned_(std::move(other.owned_)),
+      external_(std::move(other.external_)),
+      words_(other.words_) {
+    other.rows_ = other.cols_ = other.wordsPerRow_ = 0;
+    other.lastWordMask_ = 0;
+    other.words_ = nullptr;
 }
 
 Grid& Grid::operator=(const Grid& other) {
-    if (this != &other) {
-        rows_ = other.rows_;
-        cols_ = other.cols_;
-        cells_ = other.cells_;
+    if (this == &other) {
+        return *this;
+    }
+    // Reuses this grid's buffer when the sizes match (engine resets, detector history)
+    setShape(other.rows_, other.cols_);
+    owned_.assign(other.words_, other.words_ + other.bufferWords());
+    external_.reset();
+    words_ = owned_.data();
+    return *this;
+}
+
+Grid& Grid::operator=(Grid&& other) noexcept {
+    if (this == &other) {
+        return *this;
     }
+    rows_ = other.rows_;
+    cols_ = other.cols_;
+    wordsPerRow_ = other.wordsPerRow_;
+    lastWordMask_ = other.lastWordMask_;
+    owned_ = std::move(other.owned_);
+    external_ = std::move(other.external_);
+    words_ = other.words_;
+    // Moved-from grids are empty (0x0) rather than sized over a null buffer
+    other.rows_ = other.cols_ = other.wordsPerRow_ = 0;
+    other.lastWordMask_ = 0;
+    other.words_ = nullptr;
     return *this;
 }
 
+void Grid::setShape(int rows, int cols) {
+    rows_ = rows;
+    cols_ = cols;
+    wordsPerRow_ = (cols + kWordBits - 1) / kWordBits;
+    int tailBits = cols % kWordBits;
+    lastWordMask_ = tailBits == 0 ? ~Word{0} : ((Word{1} << tailBits) - 1);
+}
+
+void Grid::resize(int rows, int cols) {
+    setShape(rows, cols);
+    owned_.assign(bufferWords(), 0);
+    external_.reset();
+    words_ = owned_.data();
+}
+
+std::unique_ptr<Grid> Grid::reopenStorage() const {
+    std::unique_ptr<ExternalStorage> storage = external_ ? external_->reopen() : nullptr;
+    return storage ? std::make_unique<Grid>(rows_, cols_, std::move(storage)) : nullptr;
+}
+
 bool Grid::getCell(int row, int col) const {
     if (!isValidPosition(row, col)) {
         throw std::out_of_range("Cell position out of bounds");
     }
-    return cells_[row][col];
+    return bit(row, col);
 }
 
 void Grid::setCell(int row, int col, bool alive) {
     if (!isValidPosition(row, col)) {
         throw std::out_of_range("Cell position out of bounds");
     }
-    cells_[row][col] = alive;
+    Word& word = rowWords(row)[col >> 6];
+    Word mask = Word{1} << (col & 63);
+    word = alive ? (word | mask) : (word & ~mask);
 }
 
 void Grid::toggleCell(int row, int col) {
     if (!isValidPosition(row, col)) {
         throw std::out_of_range("Cell position out of bounds");
     }
-    cells_[row][col] = !cells_[row][col];
+    rowWords(row)[col >> 6] ^= Word{1} << (col & 63);
 }
 
 int Grid::countNeighbors(int row, int col, bool toroidal) const {
@@ -62,12 +138,12 @@ int Grid::countNeighbors(int row, int col, bool toroidal) const {
             if (toroidal) {
                 neighborRow = (neighborRow + rows_) % rows_;
                 neighborCol = (neighborCol + cols_) % cols_;
-                if (cells_[neighborRow][neighborCol]) {
+                if (bit(neighborRow, neighborCol)) {
                     ++count;
                 }
             } else {
                 if (isValidPosition(neighborRow, neighborCol) && 
-                    cells_[neighborRow][neighborCol]) {
+                    bit(neighborRow, neighborCol)) {
                     ++count;
                 }
             }
@@ -77,31 +153,29 @@ int Grid::countNeighbors(int row, int col, bool toroidal) const {
 }
 
 void Grid::clear() {
-    for (auto& row : cells_) {
-        std::fill(row.begin(), row.end(), false);
-    }
+    std::fill(words_, words_ + wordCount(), Word{0});
 }
 
 int Grid::countLiving() const {
-    int count = 0;
-    for (const auto& row : cells_) {
-        count += std::count(row.begin(), row.end(), true);
+    std::int64_t count = 0;
+    for (std::size_t i = 0; i < wordCount(); ++i) {
+        count += std::popcount(words_[i]);
     }
-    return count;
+    return static_cast<int>(count);
 }
 
 bool Grid::operator==(const Grid& other) const {
     if (rows_ != other.rows_ || cols_ != other.cols_) {
         return false;
     }
-    return cells_ == other.cells_;
+    return std::equal(words_, words_ + wordCount(), other.words_);
 }
 
 std::string Grid::toString() const {
     std::ostringstream oss;
     for (int row = 0; row < rows_; ++row) {
         for (int col = 0; col < cols_; ++col) {
-            oss << (cells_[row][col] ? "█" : ".");
+            oss << (bit(row, col) ? "█" : ".");
         }
         if (row < rows_ - 1) {
             oss << "\n";
@@ -133,27 +207,24 @@ bool Grid::loadFromFile(const std::string& filename) {
         return false;
     }
     
-    // Resize grid to new dimensions
-    rows_ = newRows;
-    cols_ = newCols;
-    cells_.resize(rows_);
-    for (auto& row : cells_) {
-        row.resize(cols_, false);
-    }
-    
-    // Read cell states
-    for (int row = 0; row < rows_; ++row) {
-        for (int col = 0; col < cols_; ++col) {
+    // Read into a fresh grid so a truncated file leaves this one untouched
+    Grid loaded(newRows, newCols);
+    for (int row = 0; row < newRows; ++row) {
+        Word* words = loaded.rowWords(row);
+        for (int col = 0; col < newCols; ++col) {
             int value;
             if (!(file >> value)) {
                 std::cerr << "Error: Not enough cell values in file" << std::endl;
                 return false;
             }
-            cells_[row][col] = (value == 1);
+            if (value == 1) {
+                words[col >> 6] |= Word{1} << (col & 63);
+            }
         }
     }
     
     file.close();
+    *this = std::move(loaded);
     return true;
 }
 
@@ -170,7 +241,7 @@ bool Grid::saveToFile(const std::string& filename) const {
     // Write cell states
     for (int row = 0; row < rows_; ++row) {
         for (int col = 0; col < cols_; ++col) {
-            file << (cells_[row][col] ? "1" : "0");
+            file << (bit(row, col) ? "1" : "0");
             if (col < cols_ - 1) {
                 file << " ";
             }
@@ -185,7 +256,7 @@ bool Grid::saveToFile(const std::string& filename) const {
 void Grid::printGrid() const {
     for (int row = 0; row < rows_; ++row) {
         for (int col = 0; col < cols_; ++col) {
-            std::cout << (cells_[row][col] ? "█" : ".");
+            std::cout << (bit(row, col) ? "█" : ".");
         }
         std::cout << "\n";
     }
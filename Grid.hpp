@@ -4,13 +4,51 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <cstddef>
+#include <cstdint>
 
+/**
+ * @class Grid
+ * @brief Bounded 2D cell grid stored as bit-packed, row-aligned 64-bit words
+ *
+ * Each row occupies getWordsPerRow() consecutive words of one contiguous
+ * buffer. Bit b of word w holds column w * 64 + b. Padding bits past the
+ * last column are always zero, so kernels may operate on whole words and
+ * popcount them directly. One extra all-dead row is kept after the last
+ * row so kernels can read "outside" a bounded grid without scratch memory.
+ *
+ * The buffer is normally owned, but may instead be ExternalStorage such as
+ * a memory-mapped snapshot (see BinarySnapshot), used in place.
+ */
 class Grid {
 public:
+    using Word = std::uint64_t;
+    static constexpr int kWordBits = 64;
+
+    /**
+     * @brief Words the grid uses in place of its own buffer
+     *
+     * Holds (rows + 1) * getWordsPerRow() writable words in the grid's
+     * layout, padding bits and the extra row zero, and stays valid until
+     * destroyed. Copies of the grid get an owned buffer.
+     */
+    class ExternalStorage {
+    public:
+        virtual ~ExternalStorage() = default;
+        virtual Word* words() = 0;
+        /// A second storage holding the words as first loaded, without the
+        /// edits made through this one; nullptr if it cannot make one
+        virtual std::unique_ptr<ExternalStorage> reopen() const { return nullptr; }
+    };
+
     Grid(int rows, int cols);
+    /// @throws std::invalid_argument for non-positive dimensions or missing storage
+    Grid(int rows, int cols, std::unique_ptr<ExternalStorage> storage);
     Grid(const Grid& other);
+    Grid(Grid&& other) noexcept;
     Grid& operator=(const Grid& other);
-    
+    Grid& operator=(Grid&& other) noexcept;
+
     int getRows() const { return rows_; }
     int getCols() const { return cols_; }
     bool getCell(int row, int col) const;
@@ -21,8 +59,24 @@ public:
     int countLiving() const;
     bool operator==(const Grid& other) const;
     std::string toString() const;
-    
-    // File I/O methods for console mode
+
+    // Word-level access for generation kernels (no bounds checks).
+    // Writers must keep the padding bits selected by ~lastWordMask() clear.
+    int getWordsPerRow() const { return wordsPerRow_; }
+    Word lastWordMask() const { return lastWordMask_; }
+    const Word* rowWords(int row) const { return words_ + static_cast<std::size_t>(row) * wordsPerRow_; }
+    Word* rowWords(int row) { return words_ + static_cast<std::size_t>(row) * wordsPerRow_; }
+    const Word* data() const { return words_; }
+    Word* data() { return words_; }
+    std::size_t wordCount() const { return static_cast<std::size_t>(rows_) * wordsPerRow_; }
+    const Word* zeroRow() const { return rowWords(rows_); }
+    bool hasExternalStorage() const { return external_ != nullptr; }
+    /// The grid as its external storage first held it (a file-backed grid
+    /// maps the file again), or nullptr for owned grids
+    std::unique_ptr<Grid> reopenStorage() const;
+
+    // File I/O methods for console mode, 0/1 matrix text only: TextFileIO
+    // reads and writes every format (RLE, macrocell, snapshots)
     bool loadFromFile(const std::string& filename);
     bool saveToFile(const std::string& filename) const;
     void printGrid() const;  // Console display
@@ -30,8 +84,18 @@ public:
 private:
     int rows_;
     int cols_;
-    std::vector<std::vector<bool>> cells_;
+    int wordsPerRow_;
+    Word lastWordMask_;
+    std::vector<Word> owned_;
+    std::unique_ptr<ExternalStorage> external_;
+    Word* words_;  // owned_.data() or external_->words()
     bool isValidPosition(int row, int col) const;
+    void setShape(int rows, int cols);
+    std::size_t bufferWords() const { return static_cast<std::size_t>(rows_ + 1) * wordsPerRow_; }
+    void resize(int rows, int cols);
+    bool bit(int row, int col) const {
+        return (rowWords(row)[col >> 6] >> (col & 63)) & 1u;
+    }
 };
 
 #endif
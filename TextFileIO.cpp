@@ -1,55 +1,598 @@
 #include "TextFileIO.hpp"
+#include "BinarySnapshot.hpp"
+#include "CompressedSnapshot.hpp"
+#include "FileFormat.hpp"
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
 #include <fstream>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
+
+namespace {
+
+using Word = Grid::Word;
+
+// Chunked input: one read() per megabyte instead of a stream call per token
+class BufferedReader {
+public:
+    explicit BufferedReader(std::ifstream& file) : file_(file), buffer_(kBufferBytes) {}
+
+    // Next byte, or -1 at the end of the file
+    int get() {
+        if (pos_ == end_ && !refill()) {
+            return -1;
+        }
+        return static_cast<unsigned char>(buffer_[pos_++]);
+    }
+    int peek() {
+        if (pos_ == end_ && !refill()) {
+            return -1;
+        }
+        return static_cast<unsigned char>(buffer_[pos_]);
+    }
+    void skipLine() {
+        for (int c = get(); c != -1 && c != '\n'; c = get()) {
+        }
+    }
+
+private:
+    static constexpr std::size_t kBufferBytes = std::size_t{1} << 20;
+
+    std::ifstream& file_;
+    std::vector<char> buffer_;
+    std::size_t pos_ = 0;
+    std::size_t end_ = 0;
+
+    bool refill() {
+        file_.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        end_ = static_cast<std::size_t>(file_.gcount());
+        pos_ = 0;
+        return end_ > 0;
+    }
+};
+
+// Chunked output that breaks lines before they pass 70 characters, as RLE asks
+class RleWriter {
+public:
+    explicit RleWriter(std::ofstream& file) : file_(file), buffer_(kBufferBytes) {}
+    ~RleWriter() { flush(); }
+
+    void text(const char* begin, std::size_t length) {
+        if (used_ + length > buffer_.size()) {
+            flush();
+        }
+        std::copy(begin, begin + length, buffer_.data() + used_);
+        used_ += length;
+    }
+    // "<count><tag>", the count left out when it is 1
+    void run(std::int64_t count, const char* tag, std::size_t tagLength) {
+        char token[24];
+        char* end = token;
+        if (count > 1) {
+            end = std::to_chars(token, token + 20, count).ptr;
+        }
+        end = std::copy(tag, tag + tagLength, end);
+        std::size_t length = static_cast<std::size_t>(end - token);
+        if (lineLength_ + length > kLineLength) {
+            text("\n", 1);
+            lineLength_ = 0;
+        }
+        text(token, length);
+        lineLength_ += length;
+    }
+    void flush() {
+        file_.write(buffer_.data(), static_cast<std::streamsize>(used_));
+        used_ = 0;
+    }
+
+private:
+    static constexpr std::size_t kBufferBytes = std::size_t{1} << 16;
+    static constexpr std::size_t kLineLength = 70;
+
+    std::ofstream& file_;
+    std::vector<char> buffer_;
+    std::size_t used_ = 0;
+    std::size_t lineLength_ = 0;
+};
+
+struct RleHeader {
+    int rows = 0;
+    int cols = 0;
+    std::string rule;
+};
+
+std::string trim(const std::string& text) {
+    std::size_t begin = text.find_first_not_of(" \t\r");
+    std::size_t end = text.find_last_not_of(" \t\r");
+    return begin == std::string::npos ? std::string() : text.substr(begin, end - begin + 1);
+}
+
+// Skips '#' comment lines (keeping a legacy "#r" rule) and parses "x = m, y = n, rule = r"
+RleHeader readRleHeader(BufferedReader& reader, const std::string& filename) {
+    RleHeader header;
+    std::string line;
+    for (;;) {
+        line.clear();
+        for (int c = reader.get(); c != -1 && c != '\n'; c = reader.get()) {
+            line += static_cast<char>(c);
+        }
+        if (line.empty() && reader.peek() == -1) {
+            throw std::runtime_error("Missing RLE header line in file: " + filename);
+        }
+        if (line.rfind("#r", 0) == 0) {
+            header.rule = trim(line.substr(2));
+        } else if (!trim(line).empty() && line[0] != '#') {
+            break;
+        }
+    }
+
+    bool haveCols = false;
+    bool haveRows = false;
+    std::istringstream fields(line);
+    std::string field;
+    while (std::getline(fields, field, ',')) {
+        std::size_t equals = field.find('=');
+        if (equals == std::string::npos) {
+            throw std::runtime_error("Invalid RLE header field '" + trim(field) + "' in file: " + filename);
+        }
+        std::string key = trim(field.substr(0, equals));
+        std::string value = trim(field.substr(equals + 1));
+        if (key == "x" || key == "y") {
+            int size = 0;
+            auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), size);
+            if (error != std::errc() || end != value.data() + value.size() || size <= 0) {
+                throw std::runtime_error("Invalid grid dimensions in file: " + filename);
+            }
+            (key == "x" ? header.cols : header.rows) = size;
+            (key == "x" ? haveCols : haveRows) = true;
+        } else if (key == "rule") {
+            // Last field; Golly's ":T100,100" topology suffix may hold commas
+            std::string rest;
+            std::getline(fields, rest);
+            header.rule = rest.empty() ? value : trim(value + "," + rest);
+            break;
+        }
+    }
+    if (!haveCols || !haveRows) {
+        throw std::runtime_error("RLE header needs x and y in file: " + filename);
+    }
+    header.rule = header.rule.substr(0, header.rule.find(':'));
+    return header;
+}
+
+/**
+ * Single pass over the RLE body, handing each run of non-dead cells to
+ * sink(row, col, count, state). Runs must fit inside the header's x by y;
+ * a missing '!' at the end of the file is tolerated, as Golly does.
+ */
+template <typename Sink>
+void readRleBody(BufferedReader& reader, const RleHeader& header, const std::string& filename, Sink&& sink) {
+    constexpr std::int64_t kMaxCount = std::numeric_limits<int>::max();
+    std::int64_t count = 0;
+    std::int64_t row = 0;
+    std::int64_t col = 0;
+    for (int c = reader.get(); c != -1 && c != '!'; c = reader.get()) {
+        if (c >= '0' && c <= '9') {
+            count = count * 10 + (c - '0');
+            if (count > kMaxCount) {
+                throw std::runtime_error("RLE run count too large in file: " + filename);
+            }
+            continue;
+        }
+        if (std::isspace(c)) {
+            continue;
+        }
+        if (c == '#') {
+            reader.skipLine();
+            continue;
+        }
+        std::int64_t length = count ? count : 1;
+        count = 0;
+        if (c == '$') {
+            row += length;
+            col = 0;
+            continue;
+        }
+
+        int state;
+        if (c == 'b' || c == '.') {
+            state = 0;
+        } else if (c == 'o') {
+            state = 1;
+        } else if (c >= 'A' && c <= 'X') {
+            state = c - 'A' + 1;
+        } else if (c >= 'p' && c <= 'y') {
+            int next = reader.get();
+            if (next < 'A' || next > 'X') {
+                throw std::runtime_error("Invalid RLE state prefix in file: " + filename);
+            }
+            state = (c - 'p' + 1) * 24 + next - 'A' + 1;
+        } else {
+            throw std::runtime_error("Invalid RLE character '" + std::string(1, static_cast<char>(c)) +
+                                     "' in file: " + filename);
+        }
+        if (state != 0) {
+            if (row >= header.rows || col + length > header.cols) {
+                throw std::runtime_error("RLE pattern extends past its x/y size in file: " + filename);
+            }
+            sink(static_cast<int>(row), static_cast<int>(col), static_cast<int>(length), state);
+        }
+        col += length;
+    }
+}
+
+// Sets cells [col, col + count) of a packed row
+void fillRun(Word* words, int col, int count) {
+    int last = col + count - 1;
+    int first = col >> 6;
+    int lastWord = last >> 6;
+    Word head = ~Word{0} << (col & 63);
+    Word tail = ~Word{0} >> (63 - (last & 63));
+    if (first == lastWord) {
+        words[first] |= head & tail;
+        return;
+    }
+    words[first] |= head;
+    std::fill(words + first + 1, words + lastWord, ~Word{0});
+    words[lastWord] |= tail;
+}
+
+// First column at or after col whose bit equals want, or cols if none
+int nextColumn(const Word* words, int wordsPerRow, int col, int cols, bool want) {
+    int index = col >> 6;
+    if (index >= wordsPerRow) {
+        return cols;
+    }
+    Word word = (want ? words[index] : ~words[index]) & (~Word{0} << (col & 63));
+    while (word == 0) {
+        if (++index == wordsPerRow) {
+            return cols;
+        }
+        word = want ? words[index] : ~words[index];
+    }
+    return std::min(cols, index * Grid::kWordBits + std::countr_zero(word));
+}
+
+// Skips leading whitespace and returns the first character, EOF if none
+int peekContent(std::ifstream& file) {
+    int c = file.peek();
+    while (c != EOF && std::isspace(c)) {
+        file.get();
+        c = file.peek();
+    }
+    return c;
+}
+
+bool isRle(std::ifstream& file) {
+    int c = peekContent(file);
+    return c == '#' || c == 'x';
+}
+
+bool isMacrocell(std::ifstream& file) {
+    return peekContent(file) == '[';
+}
+
+// "#R" rule of a macrocell file, read from the lines before the first node
+std::string readMacrocellRule(std::ifstream& file) {
+    std::string line;
+    std::string rule;
+    std::getline(file, line);  // "[M2] ..."
+    while (std::getline(file, line) && (line.empty() || line[0] == '#')) {
+        if (line.compare(0, 2, "#R") == 0) {
+            std::size_t begin = line.find_first_not_of(" \t", 2);
+            std::size_t end = line.find_last_not_of(" \t\r");
+            rule = begin == std::string::npos || end < begin ? "" : line.substr(begin, end - begin + 1);
+        }
+    }
+    return rule;
+}
+
+// Window around every live cell; an empty universe expands to one dead cell
+std::unique_ptr<Grid> expandMacrocell(const HashLifeEngine& engine, const std::string& filename) {
+    HashLifeEngine::Bounds bounds = engine.getBounds();
+    if (bounds.rows == 0) {
+        return std::make_unique<Grid>(1, 1);
+    }
+    if (bounds.rows > std::numeric_limits<int>::max() || bounds.cols > std::numeric_limits<int>::max()) {
+        throw std::runtime_error("Macrocell pattern is too large to expand into a grid: " + filename);
+    }
+    return std::make_unique<Grid>(engine.toGrid(static_cast<int>(bounds.rows), static_cast<int>(bounds.cols),
+                                                bounds.top, bounds.left));
+}
+
+void writeRleHeader(RleWriter& writer, int rows, int cols, const Rule& rule) {
+    std::string header = "x = " + std::to_string(cols) + ", y = " + std::to_string(rows) +
+                         ", rule = " + rule.toString() + "\n";
+    writer.text(header.data(), header.size());
+}
+
+// Letters of a multi-state cell: ".", "A".."X", then "pA".."yO"
+std::size_t stateTag(int state, char* tag) {
+    if (state == 0) {
+        tag[0] = '.';
+        return 1;
+    }
+    if (state <= 24) {
+        tag[0] = static_cast<char>('A' + state - 1);
+        return 1;
+    }
+    tag[0] = static_cast<char>('p' + (state - 1) / 24 - 1);
+    tag[1] = static_cast<char>('A' + (state - 1) % 24);
+    return 2;
+}
+
+// "rows cols", or "rows cols states" for multi-state grids
+void readHeader(std::ifstream& file, const std::string& filename, int& rows, int& cols, int& states) {
+    std::string line;
+    std::getline(file, line);
+    std::istringstream header(line);
+    header >> rows >> cols;
+    if (header.fail() || rows <= 0 || cols <= 0) {
+        throw std::runtime_error("Invalid grid dimensions in file: " + filename);
+    }
+    if (!(header >> states)) {
+        states = 2;
+    } else if (states < 2 || states > 256) {
+        throw std::runtime_error("Invalid state count in file: " + filename);
+    }
+}
+
+int readCell(std::ifstream& file, int states) {
+    int value;
+    file >> value;
+    
+    if (file.fail()) {
+        throw std::runtime_error("Unexpected end of file or invalid data");
+    }
+    
+    if (value < 0 || value >= states) {
+        throw std::runtime_error(states == 2 ? "Invalid cell value (must be 0 or 1)"
+                                             : "Invalid cell value (must be below the state count)");
+    }
+    return value;
+}
+
+// Live runs go straight into the packed words; other states are dropped like matrix files do
+std::unique_ptr<Grid> readRleGrid(BufferedReader& reader, const RleHeader& header, const std::string& filename) {
+    auto grid = std::make_unique<Grid>(header.rows, header.cols);
+    readRleBody(reader, header, filename, [&](int row, int col, int count, int state) {
+        if (state == 1) {
+            fillRun(grid->rowWords(row), col, count);
+        }
+    });
+    return grid;
+}
+
+std::unique_ptr<MultiStateGrid> readRleStates(BufferedReader& reader, const RleHeader& header,
+                                              const std::string& filename, int states) {
+    auto grid = std::make_unique<MultiStateGrid>(header.rows, header.cols, states);
+    readRleBody(reader, header, filename, [&](int row, int col, int count, int state) {
+        if (state >= states) {
+            throw std::runtime_error("Invalid cell value (must be below the state count)");
+        }
+        for (int i = 0; i < count; ++i) {
+            grid->setState(row, col + i, state);
+        }
+    });
+    return grid;
+}
+
+int rleStateCount(const RleHeader& header) {
+    return header.rule.empty() ? 2 : Rule::parse(header.rule).getStateCount();
+}
+
+// Matrix cells after the "rows cols [states]" header
+std::unique_ptr<Grid> readMatrixGrid(std::ifstream& file, int rows, int cols, int states) {
+    auto grid = std::make_unique<Grid>(rows, cols);
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            grid->setCell(row, col, readCell(file, states) == 1);
+        }
+    }
+    return grid;
+}
+
+std::unique_ptr<MultiStateGrid> readMatrixStates(std::ifstream& file, int rows, int cols, int states) {
+    auto grid = std::make_unique<MultiStateGrid>(rows, cols, states);
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            grid->setState(row, col, readCell(file, states));
+        }
+    }
+    return grid;
+}
+
+} // namespace
 
 std::unique_ptr<Grid> TextFileIO::loadGrid(const std::string& filename) {
-    std::ifstream file(filename);
+    if (BinarySnapshot::isSnapshot(filename)) {
+        return std::make_unique<Grid>(std::move(BinarySnapshot::load(filename).grid));
+    }
+    if (CompressedSnapshot::isSnapshot(filename)) {
+        return std::make_unique<Grid>(std::move(CompressedSnapshot::load(filename).grid));
+    }
+    
+    std::ifstream file(filename, std::ios::binary);
     if (!file.is_open()) {
         throw std::runtime_error("Cannot open file: " + filename);
     }
     
-    int rows, cols;
-    file >> rows >> cols;
+    if (isMacrocell(file)) {
+        HashLifeEngine engine;
+        engine.readMacrocell(file);
+        return expandMacrocell(engine, filename);
+    }
     
-    if (file.fail() || rows <= 0 || cols <= 0) {
-        throw std::runtime_error("Invalid grid dimensions in file: " + filename);
+    if (isRle(file)) {
+        BufferedReader reader(file);
+        RleHeader header = readRleHeader(reader, filename);
+        return readRleGrid(reader, header, filename);
     }
     
-    auto grid = std::make_unique<Grid>(rows, cols);
+    int rows, cols, states;
+    readHeader(file, filename, rows, cols, states);
+    return readMatrixGrid(file, rows, cols, states);
+}
+
+std::unique_ptr<MultiStateGrid> TextFileIO::loadStates(const std::string& filename) {
+    if (BinarySnapshot::isSnapshot(filename)) {
+        Snapshot snapshot = BinarySnapshot::load(filename);
+        return std::make_unique<MultiStateGrid>(snapshot.grid, snapshot.rule.getStateCount());
+    }
+    if (CompressedSnapshot::isSnapshot(filename)) {
+        Snapshot snapshot = CompressedSnapshot::load(filename);
+        return std::make_unique<MultiStateGrid>(snapshot.grid, snapshot.rule.getStateCount());
+    }
     
-    for (int row = 0; row < rows; ++row) {
-        for (int col = 0; col < cols; ++col) {
-            int value;
-            file >> value;
-            
-            if (file.fail()) {
-                throw std::runtime_error("Unexpected end of file or invalid data");
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    
+    if (isMacrocell(file)) {
+        HashLifeEngine engine;
+        std::string rule = engine.readMacrocell(file);
+        int states = rule.empty() ? 2 : Rule::parse(rule).getStateCount();
+        return std::make_unique<MultiStateGrid>(*expandMacrocell(engine, filename), states);
+    }
+    
+    if (isRle(file)) {
+        BufferedReader reader(file);
+        RleHeader header = readRleHeader(reader, filename);
+        return readRleStates(reader, header, filename, rleStateCount(header));
+    }
+    
+    int rows, cols, states;
+    readHeader(file, filename, rows, cols, states);
+    return readMatrixStates(file, rows, cols, states);
+}
+
+void TextFileIO::saveGrid(const Grid& grid, const std::string& filename, const Rule& rule) {
+    if (BinarySnapshot::isSnapshotFileName(filename)) {
+        BinarySnapshot::save(grid, filename, rule);
+        return;
+    }
+    if (CompressedSnapshot::isSnapshotFileName(filename)) {
+        CompressedSnapshot::save(grid, filename, rule);
+        return;
+    }
+    if (isMacrocellFileName(filename)) {
+        HashLifeEngine engine(grid);
+        saveMacrocell(engine, filename, rule);
+        return;
+    }
+    
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot create file: " + filename);
+    }
+    
+    if (isRleFileName(filename)) {
+        // Runs are found a word at a time; blank rows are folded into the next "$" count
+        RleWriter writer(file);
+        writeRleHeader(writer, grid.getRows(), grid.getCols(), rule);
+        std::int64_t pendingRows = 0;
+        for (int row = 0; row < grid.getRows(); ++row) {
+            const Word* words = grid.rowWords(row);
+            int col = 0;
+            for (;;) {
+                int start = nextColumn(words, grid.getWordsPerRow(), col, grid.getCols(), true);
+                if (start == grid.getCols()) {
+                    break;
+                }
+                int end = nextColumn(words, grid.getWordsPerRow(), start, grid.getCols(), false);
+                if (pendingRows) {
+                    writer.run(pendingRows, "$", 1);
+                    pendingRows = 0;
+                }
+                if (start > col) {
+                    writer.run(start - col, "b", 1);
+                }
+                writer.run(end - start, "o", 1);
+                col = end;
             }
-            
-            if (value != 0 && value != 1) {
-                throw std::runtime_error("Invalid cell value (must be 0 or 1)");
+            ++pendingRows;
+        }
+        writer.run(1, "!\n", 2);
+        return;
+    }
+    
+    file << grid.getRows() << " " << grid.getCols() << "\n";
+    
+    for (int row = 0; row < grid.getRows(); ++row) {
+        for (int col = 0; col < grid.getCols(); ++col) {
+            file << (grid.getCell(row, col) ? "1" : "0");
+            if (col < grid.getCols() - 1) {
+                file << " ";
             }
-            
-            grid->setCell(row, col, value == 1);
         }
+        file << "\n";
     }
     
     file.close();
-    return grid;
 }
 
-void TextFileIO::saveGrid(const Grid& grid, const std::string& filename) {
-    std::ofstream file(filename);
+void TextFileIO::saveStates(const MultiStateGrid& grid, const std::string& filename, const Rule& rule) {
+    if (BinarySnapshot::isSnapshotFileName(filename)) {
+        BinarySnapshot::save(grid.toGrid(), filename, rule);  // Live plane only
+        return;
+    }
+    if (CompressedSnapshot::isSnapshotFileName(filename)) {
+        CompressedSnapshot::save(grid.toGrid(), filename, rule);
+        return;
+    }
+    if (isMacrocellFileName(filename)) {
+        HashLifeEngine engine(grid.toGrid());  // Live plane only
+        saveMacrocell(engine, filename, rule);
+        return;
+    }
+    
+    std::ofstream file(filename, std::ios::binary);
     if (!file.is_open()) {
         throw std::runtime_error("Cannot create file: " + filename);
     }
     
-    file << grid.getRows() << " " << grid.getCols() << "\n";
+    if (isRleFileName(filename)) {
+        if (rule.getStateCount() != grid.getStateCount()) {
+            throw std::invalid_argument("RLE rule must have the grid's state count");
+        }
+        RleWriter writer(file);
+        writeRleHeader(writer, grid.getRows(), grid.getCols(), rule);
+        std::int64_t pendingRows = 0;
+        char tag[2];
+        for (int row = 0; row < grid.getRows(); ++row) {
+            int col = 0;
+            while (col < grid.getCols()) {
+                int state = grid.getState(row, col);
+                int end = col + 1;
+                while (end < grid.getCols() && grid.getState(row, end) == state) {
+                    ++end;
+                }
+                if (state != 0 || end < grid.getCols()) {
+                    if (pendingRows) {
+                        writer.run(pendingRows, "$", 1);
+                        pendingRows = 0;
+                    }
+                    writer.run(end - col, tag, stateTag(state, tag));
+                }
+                col = end;
+            }
+            ++pendingRows;
+        }
+        writer.run(1, "!\n", 2);
+        return;
+    }
+    
+    file << grid.getRows() << " " << grid.getCols() << " " << grid.getStateCount() << "\n";
     
     for (int row = 0; row < grid.getRows(); ++row) {
         for (int col = 0; col < grid.getCols(); ++col) {
-            file << (grid.getCell(row, col) ? "1" : "0");
+            file << grid.getState(row, col);
             if (col < grid.getCols() - 1) {
                 file << " ";
             }
@@ -59,3 +602,105 @@ void TextFileIO::saveGrid(const Grid& grid, const std::string& filename) {
     
     file.close();
 }
+
+std::string TextFileIO::loadRule(const std::string& filename) {
+    if (BinarySnapshot::isSnapshot(filename)) {
+        return BinarySnapshot::load(filename).rule.toString();
+    }
+    if (CompressedSnapshot::isSnapshot(filename)) {
+        return CompressedSnapshot::loadRule(filename).toString();
+    }
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    if (isMacrocell(file)) {
+        return readMacrocellRule(file);
+    }
+    if (!isRle(file)) {
+        return "";
+    }
+    BufferedReader reader(file);
+    return readRleHeader(reader, filename).rule;
+}
+
+LoadedPattern TextFileIO::loadPattern(const std::string& filename, int threads) {
+    LoadedPattern pattern;
+    bool mapped = BinarySnapshot::isSnapshot(filename);
+    if (mapped || CompressedSnapshot::isSnapshot(filename)) {
+        // A .golb grid stays backed by the mapped file
+        Snapshot snapshot = mapped ? BinarySnapshot::load(filename) : CompressedSnapshot::load(filename, threads);
+        pattern.grid = std::make_unique<Grid>(std::move(snapshot.grid));
+        pattern.rule = snapshot.rule.toString();
+        pattern.generation = snapshot.generation;
+        pattern.toroidal = snapshot.toroidal;
+        return pattern;
+    }
+    
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    
+    if (isMacrocell(file)) {
+        HashLifeEngine engine;
+        pattern.rule = engine.readMacrocell(file);
+        pattern.grid = expandMacrocell(engine, filename);
+        return pattern;
+    }
+    
+    // Multi-state files are read as states once and their live plane taken from that
+    int rows, cols, states;
+    if (isRle(file)) {
+        BufferedReader reader(file);
+        RleHeader header = readRleHeader(reader, filename);
+        pattern.rule = header.rule;
+        states = rleStateCount(header);
+        if (states > 2) {
+            pattern.states = readRleStates(reader, header, filename, states);
+        } else {
+            pattern.grid = readRleGrid(reader, header, filename);
+        }
+    } else {
+        readHeader(file, filename, rows, cols, states);
+        if (states > 2) {
+            pattern.states = readMatrixStates(file, rows, cols, states);
+        } else {
+            pattern.grid = readMatrixGrid(file, rows, cols, states);
+        }
+    }
+    if (pattern.states) {
+        pattern.grid = std::make_unique<Grid>(pattern.states->toGrid());
+    }
+    return pattern;
+}
+
+std::unique_ptr<HashLifeEngine> TextFileIO::loadMacrocell(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    peekContent(file);
+    auto engine = std::make_unique<HashLifeEngine>();
+    engine->readMacrocell(file);
+    return engine;
+}
+
+void TextFileIO::saveMacrocell(HashLifeEngine& engine, const std::string& filename, const Rule& rule) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot create file: " + filename);
+    }
+    engine.writeMacrocell(file, rule.toString());
+    if (!file) {
+        throw std::runtime_error("Cannot write file: " + filename);
+    }
+}
+
+bool TextFileIO::isRleFileName(const std::string& filename) {
+    return FileFormat::endsWithIgnoreCase(filename, ".rle");
+}
+
+bool TextFileIO::isMacrocellFileName(const std::string& filename) {
+    return FileFormat::endsWithIgnoreCase(filename, ".mc");
+}
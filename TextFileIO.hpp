@@ -2,13 +2,58 @@
 #define TEXT_FILE_IO_HPP
 
 #include "Grid.hpp"
+#include "HashLife.hpp"
+#include "MultiStateGrid.hpp"
+#include "Rule.hpp"
+#include <cstdint>
 #include <string>
 #include <memory>
 
+// What a runner needs from a pattern file, read in one pass
+struct LoadedPattern {
+    std::unique_ptr<Grid> grid;              // Live cells (state 1)
+    std::string rule;                        // As loadRule() returns it
+    std::unique_ptr<MultiStateGrid> states;  // Only for files storing more than two states
+    std::uint64_t generation = 0;            // Snapshots resume where they stopped
+    bool toroidal = false;
+};
+
 class TextFileIO {
 public:
+    // Files starting with '#' or 'x' are read as standard RLE ("x = 3, y = 3,
+    // rule = B3/S23", then b/o/$ runs up to '!'), others as a "rows cols"
+    // matrix. Saving to a name ending in ".rle" writes RLE with the rule.
+    // Binary snapshots (BinarySnapshot, ".golb") are mapped, not parsed;
+    // compressed ones (CompressedSnapshot, ".golz") are decoded tile by tile.
     std::unique_ptr<Grid> loadGrid(const std::string& filename);
-    void saveGrid(const Grid& grid, const std::string& filename);
+    void saveGrid(const Grid& grid, const std::string& filename, const Rule& rule = Rule());
+
+    // Multi-state files add the state count to the header ("rows cols states")
+    // and store one state per cell. loadGrid() reads them too, keeping state 1.
+    // In RLE, states are '.', 'A'..'X', then 'pA'..'yO', counted by the rule.
+    std::unique_ptr<MultiStateGrid> loadStates(const std::string& filename);
+    void saveStates(const MultiStateGrid& grid, const std::string& filename, const Rule& rule = Rule());
+
+    // Rule named by an RLE header (without any ":T..." topology suffix), a
+    // macrocell "#R" line or a snapshot; empty for matrix files and files without one
+    std::string loadRule(const std::string& filename);
+
+    // loadGrid(), loadRule() and (for multi-state files) loadStates() from a
+    // single read of the file, plus a snapshot's generation and topology.
+    // Compressed snapshots are decoded on `threads` threads.
+    LoadedPattern loadPattern(const std::string& filename, int threads = 1);
+
+    // Macrocell files ("[M2]" header, ".mc") hold a deduplicated quadtree.
+    // loadMacrocell() joins their nodes into a HashLifeEngine without
+    // expanding them; loadGrid() expands the rectangle around the live cells,
+    // and saving a grid to a ".mc" name writes one.
+    std::unique_ptr<HashLifeEngine> loadMacrocell(const std::string& filename);
+    void saveMacrocell(HashLifeEngine& engine, const std::string& filename, const Rule& rule = Rule());
+
+    // True for names ending in ".rle" (any case)
+    static bool isRleFileName(const std::string& filename);
+    // True for names ending in ".mc" (any case)
+    static bool isMacrocellFileName(const std::string& filename);
 };
 
 #endif
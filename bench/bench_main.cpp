@@ -0,0 +1,529 @@
+/**
+ * @file bench_main.cpp
+ * @brief Reproducible micro/macro benchmarks for the generation kernels
+ *
+ * Every workload is derived from a fixed seed and runs a fixed number of
+ * generations chosen from its size, so two runs of the same build time
+ * exactly the same work. Results are written as one JSON document for
+ * tracking regressions across releases; progress goes to stderr.
+ *
+ * Usage: bench.exe [--quick] [--threads=N] [--filter=TEXT] [--output=PATH]
+ */
+
+#include "../Grid.hpp"
+#include "../GameEngine.hpp"
+#include "../TextFileIO.hpp"
+#include "../include/CompressedSnapshot.hpp"
+#include "../include/LargerThanLife.hpp"
+#include "../include/LifeKernels.hpp"
+#include "../include/PatternCensus.hpp"
+#include "../include/PatternLibrary.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::uint64_t kSeed = 20251201u;
+constexpr int kRepetitions = 3;
+
+struct Options {
+    bool quick = false;
+    int threads = 1;
+    std::string filter;
+    std::string outputPath;
+};
+
+struct Result {
+    std::string name;
+    std::string kind;       // "count_neighbors", "step", "rule", "ltl", "pattern" or "census"
+    int rows = 0;
+    int cols = 0;
+    double density = 0.0;
+    bool toroidal = false;
+    std::string backend;
+    std::uint64_t operations = 0;  // Calls or generations per repetition
+    double bestSeconds = 0.0;
+    double medianSeconds = 0.0;
+    std::uint64_t cellsPerRepetition = 0;
+};
+
+// splitmix64: tiny, seedable and identical on every platform
+std::uint64_t nextRandom(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Random soup written word by word; 16 random bits decide each cell
+Grid randomGrid(int rows, int cols, double density, std::uint64_t seed) {
+    Grid grid(rows, cols);
+    std::uint64_t state = seed ^ (static_cast<std::uint64_t>(rows) << 32) ^ static_cast<std::uint64_t>(density * 1000);
+    auto threshold = static_cast<std::uint64_t>(density * 65536.0);
+    for (int row = 0; row < rows; ++row) {
+        Grid::Word* words = grid.rowWords(row);
+        for (int w = 0; w < grid.getWordsPerRow(); ++w) {
+            Grid::Word word = 0;
+            for (int bit = 0; bit < Grid::kWordBits; bit += 4) {
+                std::uint64_t r = nextRandom(state);
+                for (int k = 0; k < 4; ++k) {
+                    if (((r >> (16 * k)) & 0xFFFF) < threshold) {
+                        word |= Grid::Word{1} << (bit + k);
+                    }
+                }
+            }
+            words[w] = word;
+        }
+        words[grid.getWordsPerRow() - 1] &= grid.lastWordMask();
+    }
+    return grid;
+}
+
+// Fixed work per case: about `budget` cell updates, clamped to [lo, hi] repetitions
+std::uint64_t operationsFor(std::uint64_t cells, std::uint64_t budget, std::uint64_t lo, std::uint64_t hi) {
+    return std::clamp<std::uint64_t>(budget / cells, lo, hi);
+}
+
+// setup() runs untimed before every repetition
+template <typename Setup, typename Body>
+void timeRepetitions(Result& result, Setup&& setup, Body&& body) {
+    std::vector<double> seconds;
+    for (int rep = 0; rep < kRepetitions; ++rep) {
+        setup();
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto end = std::chrono::steady_clock::now();
+        seconds.push_back(std::chrono::duration<double>(end - start).count());
+    }
+    std::sort(seconds.begin(), seconds.end());
+    result.bestSeconds = seconds.front();
+    result.medianSeconds = seconds[seconds.size() / 2];
+}
+
+class Suite {
+public:
+    explicit Suite(const Options& options) : options_(options) {}
+
+    void run() {
+        std::vector<int> sizes = options_.quick ? std::vector<int>{64, 256, 1024}
+                                                : std::vector<int>{64, 256, 1024, 4096, 16384};
+        std::vector<double> densities = options_.quick ? std::vector<double>{0.01, 0.25}
+                                                       : std::vector<double>{0.01, 0.05, 0.10, 0.25, 0.50};
+
+        for (int size : sizes) {
+            for (double density : densities) {
+                Grid soup = randomGrid(size, size, density, kSeed);
+                for (bool toroidal : {false, true}) {
+                    // countNeighbors is per cell, so larger grids only add cache misses
+                    if (size <= 4096) {
+                        benchCountNeighbors(soup, density, toroidal);
+                    }
+                    benchStep(soup, density, toroidal, GameEngine::Backend::BitParallel);
+                    benchStep(soup, density, toroidal, GameEngine::Backend::Tiled);
+                    benchStep(soup, density, toroidal, GameEngine::Backend::Lookup);
+                    benchStep(soup, density, toroidal, GameEngine::Backend::Incremental);
+                    // The per-cell reference path is too slow to be useful beyond 1024^2
+                    if (size <= 1024) {
+                        benchStep(soup, density, toroidal, GameEngine::Backend::Reference);
+                    }
+                }
+            }
+        }
+        benchRules();
+        benchLargerThanLife();
+        benchPatterns();
+        benchCensus();
+        benchRle();
+        benchCompressed();
+    }
+
+    std::string toJson() const {
+        std::ostringstream oss;
+        oss.precision(9);
+        oss << "{\n";
+        oss << "  \"suite\": \"gameoflife-kernels\",\n";
+        oss << "  \"seed\": " << kSeed << ",\n";
+        oss << "  \"isa\": \"" << LifeKernels::isaName(LifeKernels::activeIsa()) << "\",\n";
+        oss << "  \"threads\": " << options_.threads << ",\n";
+        oss << "  \"repetitions\": " << kRepetitions << ",\n";
+        oss << "  \"results\": [";
+        for (std::size_t i = 0; i < results_.size(); ++i) {
+            const Result& r = results_[i];
+            double perOp = r.medianSeconds / static_cast<double>(r.operations);
+            oss << (i == 0 ? "\n" : ",\n") << "    {"
+                << "\"name\": \"" << r.name << "\", "
+                << "\"kind\": \"" << r.kind << "\", "
+                << "\"rows\": " << r.rows << ", "
+                << "\"cols\": " << r.cols << ", "
+                << "\"density\": " << r.density << ", "
+                << "\"toroidal\": " << (r.toroidal ? "true" : "false") << ", "
+                << "\"backend\": \"" << r.backend << "\", "
+                << "\"operations\": " << r.operations << ", "
+                << "\"best_seconds\": " << r.bestSeconds << ", "
+                << "\"median_seconds\": " << r.medianSeconds << ", "
+                << "\"ns_per_operation\": " << perOp * 1e9 << ", "
+                << "\"cells_per_second\": " << r.cellsPerRepetition / r.medianSeconds
+                << "}";
+        }
+        oss << "\n  ]\n}\n";
+        return oss.str();
+    }
+
+private:
+    Options options_;
+    std::vector<Result> results_;
+
+    bool selected(const std::string& name) const {
+        return options_.filter.empty() || name.find(options_.filter) != std::string::npos;
+    }
+
+    static std::string caseName(const std::string& kind, int rows, int cols, double density,
+                                bool toroidal, const std::string& backend) {
+        std::ostringstream oss;
+        oss << kind << "/" << backend << "/" << rows << "x" << cols << "/"
+            << static_cast<int>(density * 100 + 0.5) << "pct/" << (toroidal ? "toroidal" : "bounded");
+        return oss.str();
+    }
+
+    void record(Result result) {
+        std::cerr << result.name << ": " << result.medianSeconds * 1e3 << " ms\n";
+        results_.push_back(std::move(result));
+    }
+
+    void benchCountNeighbors(const Grid& grid, double density, bool toroidal) {
+        Result result;
+        result.kind = "count_neighbors";
+        result.backend = "grid";
+        result.name = caseName(result.kind, grid.getRows(), grid.getCols(), density, toroidal, result.backend);
+        if (!selected(result.name)) {
+            return;
+        }
+        result.rows = grid.getRows();
+        result.cols = grid.getCols();
+        result.density = density;
+        result.toroidal = toroidal;
+
+        std::uint64_t cells = static_cast<std::uint64_t>(grid.getRows()) * grid.getCols();
+        std::uint64_t sweeps = operationsFor(cells, std::uint64_t{1} << 22, 1, 1000);
+        result.operations = sweeps * cells;
+        result.cellsPerRepetition = result.operations;
+
+        volatile long long sink = 0;
+        timeRepetitions(result, [] {}, [&] {
+            long long total = 0;
+            for (std::uint64_t sweep = 0; sweep < sweeps; ++sweep) {
+                for (int row = 0; row < grid.getRows(); ++row) {
+                    for (int col = 0; col < grid.getCols(); ++col) {
+                        total += grid.countNeighbors(row, col, toroidal);
+                    }
+                }
+            }
+            sink = sink + total;
+        });
+        record(result);
+    }
+
+    void benchStep(const Grid& start, double density, bool toroidal, GameEngine::Backend backend) {
+        Result result;
+        result.kind = "step";
+        result.backend = GameEngine::backendName(backend);
+        result.name = caseName(result.kind, start.getRows(), start.getCols(), density, toroidal, result.backend);
+        if (!selected(result.name)) {
+            return;
+        }
+        result.rows = start.getRows();
+        result.cols = start.getCols();
+        result.density = density;
+        result.toroidal = toroidal;
+
+        std::uint64_t cells = static_cast<std::uint64_t>(start.getRows()) * start.getCols();
+        std::uint64_t budget = backend == GameEngine::Backend::Reference ? std::uint64_t{1} << 22
+                                                                         : std::uint64_t{1} << 29;
+        result.operations = operationsFor(cells, budget, 2, 2000);
+        result.cellsPerRepetition = result.operations * cells;
+
+        GameEngine engine(start, toroidal);
+        engine.setBackend(backend);
+        engine.setThreadCount(options_.threads);
+        engine.step();  // Warm-up: buffers, pool and tile state
+
+        // Every repetition restarts from the same soup so the work is identical
+        timeRepetitions(result, [&] { engine.setCurrentGrid(start); }, [&] {
+            for (std::uint64_t gen = 0; gen < result.operations; ++gen) {
+                engine.step();
+            }
+        });
+        record(result);
+    }
+
+    // Conway's own adder vs. compile-time specialised rules vs. the generic table
+    // kernel, and the packed multi-state pass of Brian's Brain and Star Wars
+    void benchRules() {
+        int size = options_.quick ? 1024 : 4096;
+        Grid soup = randomGrid(size, size, 0.25, kSeed);
+        for (const char* text : {"B3/S23", "B36/S23", "B3678/S34678", "B35/S236", "B2/S/C3", "B2/S345/C4"}) {
+            Rule rule = Rule::parse(text);
+            Result result;
+            result.kind = "rule";
+            result.backend = "bitparallel";
+            result.name = "rule/" + rule.toString() + "/" + std::to_string(size) + "x" + std::to_string(size) +
+                          (LifeKernels::isSpecialized(rule) ? "/specialized" : "/generic");
+            if (!selected(result.name)) {
+                continue;
+            }
+            result.rows = size;
+            result.cols = size;
+            result.density = 0.25;
+            std::uint64_t cells = static_cast<std::uint64_t>(size) * size;
+            result.operations = operationsFor(cells, std::uint64_t{1} << 29, 2, 2000);
+            result.cellsPerRepetition = result.operations * cells;
+
+            GameEngine engine(soup, false);
+            engine.setRule(rule);
+            engine.setThreadCount(options_.threads);
+            timeRepetitions(result, [&] { engine.setCurrentGrid(soup); }, [&] {
+                for (std::uint64_t gen = 0; gen < result.operations; ++gen) {
+                    engine.step();
+                }
+            });
+            record(result);
+        }
+    }
+
+    // Sliding-window counts should cost about the same per cell at every radius
+    void benchLargerThanLife() {
+        int size = options_.quick ? 256 : 1024;
+        Grid soup = randomGrid(size, size, 0.4, kSeed);
+        const char* rules[] = {
+            "R1,C0,M0,S2..3,B3..3,NM", "R5,C0,M1,S34..58,B34..45,NM", "R10,C0,M1,S150..260,B140..210,NM",
+            "R1,C0,M1,S2..3,B2..3,NN", "R5,C0,M0,S15..30,B18..26,NN", "R10,C0,M0,S60..130,B70..110,NN",
+        };
+        for (const char* text : rules) {
+            LargerThanLifeRule rule = LargerThanLifeRule::parse(text);
+            Result result;
+            result.kind = "ltl";
+            result.backend = "ltl";
+            result.name = "ltl/R" + std::to_string(rule.getRadius()) +
+                          (rule.getNeighborhood() == LargerThanLifeRule::Neighborhood::Moore ? "/moore/" : "/vonneumann/") +
+                          std::to_string(size) + "x" + std::to_string(size);
+            if (!selected(result.name)) {
+                continue;
+            }
+            result.rows = size;
+            result.cols = size;
+            result.density = 0.4;
+            std::uint64_t cells = static_cast<std::uint64_t>(size) * size;
+            result.operations = operationsFor(cells, std::uint64_t{1} << 25, 2, 200);
+            result.cellsPerRepetition = result.operations * cells;
+
+            LargerThanLifeEngine engine(soup, rule, true);
+            engine.setThreadCount(options_.threads);
+            timeRepetitions(result, [&] { engine.setCurrentGrid(soup); }, [&] {
+                for (std::uint64_t gen = 0; gen < result.operations; ++gen) {
+                    engine.step();
+                }
+            });
+            record(result);
+        }
+    }
+
+    void benchPatterns() {
+        PatternLibrary library;
+        for (const std::string& pattern : library.getPatternNames()) {
+            for (bool toroidal : {false, true}) {
+                Grid start(256, 256);
+                library.insertPattern(start, pattern, 120, 120, toroidal);
+                for (auto backend : {GameEngine::Backend::BitParallel, GameEngine::Backend::Tiled,
+                                     GameEngine::Backend::Incremental}) {
+                    Result result;
+                    result.kind = "pattern";
+                    result.backend = GameEngine::backendName(backend);
+                    result.name = "pattern/" + result.backend + "/" + pattern + "/" +
+                                  (toroidal ? "toroidal" : "bounded");
+                    if (!selected(result.name)) {
+                        continue;
+                    }
+                    result.rows = start.getRows();
+                    result.cols = start.getCols();
+                    result.toroidal = toroidal;
+                    result.operations = 2000;
+                    result.cellsPerRepetition = result.operations * 256 * 256;
+
+                    GameEngine engine(start, toroidal);
+                    engine.setBackend(backend);
+                    engine.setThreadCount(options_.threads);
+                    timeRepetitions(result, [&] { engine.setCurrentGrid(start); }, [&] {
+                        for (std::uint64_t gen = 0; gen < result.operations; ++gen) {
+                            engine.step();
+                        }
+                    });
+                    record(result);
+                }
+            }
+        }
+    }
+
+    // Labelling cost per island: a soup settled for 1000 generations, and
+    // a board tiled with blocks (a million islands at 4096^2)
+    void benchCensus() {
+        int size = options_.quick ? 1024 : 4096;
+        GameEngine engine(randomGrid(size, size, 0.25, kSeed), false);
+        engine.setThreadCount(options_.threads);
+        for (int gen = 0; gen < 1000; ++gen) {
+            engine.step();
+        }
+        Grid blocks(size, size);
+        for (int row = 0; row < size; row += 4) {
+            for (int w = 0; w < blocks.getWordsPerRow(); ++w) {
+                blocks.rowWords(row)[w] = blocks.rowWords(row + 1)[w] = 0x3333333333333333ULL;
+            }
+        }
+
+        PatternCensus census(PatternLibrary(), options_.threads);
+        const std::pair<const char*, const Grid*> boards[] = {
+            {"soup1000", &engine.getCurrentGrid()}, {"blocks", &blocks}};
+        for (const auto& [board, grid] : boards) {
+            Result result;
+            result.kind = "census";
+            result.backend = "census";
+            result.name = "census/" + std::string(board) + "/" + std::to_string(size) + "x" + std::to_string(size);
+            if (!selected(result.name)) {
+                continue;
+            }
+            result.rows = size;
+            result.cols = size;
+            result.operations = 1;
+            result.cellsPerRepetition = static_cast<std::uint64_t>(size) * size;
+            timeRepetitions(result, [] {}, [&] { census.take(*grid); });
+            record(result);
+        }
+    }
+
+    void benchRle() {
+        int size = options_.quick ? 1024 : 4096;
+        Grid soup = randomGrid(size, size, 0.25, kSeed);
+        const std::string path = "bench_rle.rle";
+        TextFileIO fileIO;
+        fileIO.saveGrid(soup, path);
+        for (const char* operation : {"save", "load"}) {
+            Result result;
+            result.kind = "rle";
+            result.backend = operation;
+            result.name = "rle/" + std::string(operation) + "/" + std::to_string(size) + "x" + std::to_string(size);
+            if (!selected(result.name)) {
+                continue;
+            }
+            result.rows = size;
+            result.cols = size;
+            result.density = 0.25;
+            result.operations = 1;
+            result.cellsPerRepetition = static_cast<std::uint64_t>(size) * size;
+            if (result.backend == "save") {
+                timeRepetitions(result, [] {}, [&] { fileIO.saveGrid(soup, path); });
+            } else {
+                timeRepetitions(result, [] {}, [&] { fileIO.loadGrid(path); });
+            }
+            record(result);
+        }
+        std::remove(path.c_str());
+    }
+
+    // A few soups scattered over a mostly empty board, where skipping empty tiles pays
+    void benchCompressed() {
+        int size = options_.quick ? 4096 : 16384;
+        Grid board(size, size);
+        Grid soup = randomGrid(256, 256, 0.5, kSeed);
+        for (int i = 0; i < 16; ++i) {
+            int top = (i * 7919) % (size - 256);
+            int left = (i * 104729) % (size - 256);
+            for (int row = 0; row < 256; ++row) {
+                for (int col = 0; col < 256; ++col) {
+                    if (soup.getCell(row, col)) {
+                        board.setCell(top + row, left + col, true);
+                    }
+                }
+            }
+        }
+        const std::string path = "bench_compressed.golz";
+        CompressedSnapshot::save(board, path, Rule(), 0, false, options_.threads);
+        for (const char* operation : {"save", "load"}) {
+            Result result;
+            result.kind = "golz";
+            result.backend = operation;
+            result.name = "golz/" + std::string(operation) + "/" + std::to_string(size) + "x" + std::to_string(size);
+            if (!selected(result.name)) {
+                continue;
+            }
+            result.rows = size;
+            result.cols = size;
+            result.density = static_cast<double>(board.countLiving()) / (static_cast<double>(size) * size);
+            result.operations = 1;
+            result.cellsPerRepetition = static_cast<std::uint64_t>(size) * size;
+            if (result.backend == "save") {
+                timeRepetitions(result, [] {},
+                                [&] { CompressedSnapshot::save(board, path, Rule(), 0, false, options_.threads); });
+            } else {
+                timeRepetitions(result, [] {}, [&] { CompressedSnapshot::load(path, options_.threads); });
+            }
+            record(result);
+        }
+        std::remove(path.c_str());
+    }
+};
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--quick") {
+            options.quick = true;
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            options.threads = std::stoi(arg.substr(10));
+        } else if (arg.rfind("--filter=", 0) == 0) {
+            options.filter = arg.substr(9);
+        } else if (arg.rfind("--output=", 0) == 0) {
+            options.outputPath = arg.substr(9);
+        } else {
+            std::cerr << "Unknown argument: " << arg << "\n"
+                      << "Usage: bench.exe [--quick] [--threads=N] [--filter=TEXT] [--output=PATH]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options;
+        if (!parseOptions(argc, argv, options)) {
+            return 1;
+        }
+
+        Suite suite(options);
+        suite.run();
+
+        std::string json = suite.toJson();
+        if (options.outputPath.empty()) {
+            std::cout << json;
+        } else {
+            std::ofstream file(options.outputPath);
+            if (!file) {
+                throw std::runtime_error("Cannot create file: " + options.outputPath);
+            }
+            file << json;
+            std::cerr << "Results written to " << options.outputPath << "\n";
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
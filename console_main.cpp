@@ -0,0 +1,195 @@
+#include "Grid.hpp"
+#include "GameEngine.hpp"
+#include "TextFileIO.hpp"
+#include "Config.hpp"
+#include "BatchRunner.hpp"
+#include "BinarySnapshot.hpp"
+#include "CompressedSnapshot.hpp"
+#include "DeltaLog.hpp"
+#include "SoupSearch.hpp"
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+// Same default board as the GUI: 80x80 with a glider in the center
+std::unique_ptr<Grid> defaultGrid() {
+    auto grid = std::make_unique<Grid>(80, 80);
+    int centerRow = grid->getRows() / 2;
+    int centerCol = grid->getCols() / 2;
+    grid->setCell(centerRow, centerCol + 1, true);
+    grid->setCell(centerRow + 1, centerCol + 2, true);
+    grid->setCell(centerRow + 2, centerCol, true);
+    grid->setCell(centerRow + 2, centerCol + 1, true);
+    grid->setCell(centerRow + 2, centerCol + 2, true);
+    std::cerr << "Created default 80x80 grid with glider\n";
+    return grid;
+}
+
+// --engine=hashlife: the pattern on an unbounded plane, advanced by
+// --generations in one stepBy()
+int runHashLife(const Config& config) {
+    TextFileIO fileIO;
+    const std::string& path = config.getFilePath();
+    std::unique_ptr<HashLifeEngine> engine;
+    std::string fileRule;
+    if (path.empty()) {
+        engine = std::make_unique<HashLifeEngine>(*defaultGrid());
+    } else if (TextFileIO::isMacrocellFileName(path)) {
+        // Joined straight into the quadtree, never expanded
+        engine = fileIO.loadMacrocell(path);
+        std::cerr << "Loaded macrocell pattern from: " << path << "\n";
+        fileRule = fileIO.loadRule(path);
+    } else {
+        LoadedPattern pattern = fileIO.loadPattern(path, config.getThreads());
+        engine = std::make_unique<HashLifeEngine>(*pattern.grid);
+        fileRule = pattern.rule;
+        std::cerr << "Loaded " << path << "\n";
+    }
+    if (!config.hasRule() && !fileRule.empty() && Rule::parse(fileRule) != Rule()) {
+        throw std::runtime_error("--engine=hashlife only runs B3/S23, but " + path + " uses " +
+                                 Rule::parse(fileRule).toString() + "; pick another --engine");
+    }
+
+    BatchRunner runner(config.getGenerations(), false);
+    BatchResult result = runner.run(*engine);
+
+    if (!config.getOutputPath().empty()) {
+        const std::string& output = config.getOutputPath();
+        if (TextFileIO::isMacrocellFileName(output)) {
+            fileIO.saveMacrocell(*engine, output);
+        } else {
+            // Other formats hold the rectangle around the live cells
+            HashLifeEngine::Bounds bounds = engine->getBounds();
+            if (bounds.rows > std::numeric_limits<int>::max() || bounds.cols > std::numeric_limits<int>::max()) {
+                throw std::runtime_error("Pattern is too large for a grid file; save it as .mc instead");
+            }
+            Grid grid = bounds.rows == 0 ? Grid(1, 1)
+                                         : engine->toGrid(static_cast<int>(bounds.rows), static_cast<int>(bounds.cols),
+                                                          bounds.top, bounds.left);
+            fileIO.saveGrid(grid, output);
+        }
+        std::cerr << "Saved final pattern to: " << output << "\n";
+    }
+
+    if (config.getReportFormat() == "json") {
+        std::cout << BatchRunner::formatJson(result, *engine);
+    } else {
+        std::cout << BatchRunner::formatText(result, *engine);
+    }
+    return 0;
+}
+
+} // namespace
+
+// Headless entry point: no SFML, suitable for servers and batch jobs.
+// Diagnostics go to stderr so stdout carries only the report.
+int main(int argc, char* argv[]) {
+    try {
+        Config config;
+        if (!config.parse(argc, argv)) {
+            std::cerr << "\n" << Config::getUsage();
+            return 1;
+        }
+
+        if (config.getSoups() > 0) {
+            SoupSearchOptions options;
+            options.soups = config.getSoups();
+            options.firstSeed = config.getSeed();
+            options.soupSize = config.getSoupSize();
+            options.boardSize = config.getBoardSize();
+            options.density = config.getDensity();
+            if (config.hasGenerations()) {
+                options.maxGenerations = config.getGenerations();
+            }
+            options.toroidal = config.isToroidal();
+            options.rule = config.getRule();
+            options.backend = config.getBackend();
+            options.threads = config.getThreads();
+
+            SoupSearchResult result = SoupSearch(options).run();
+            if (config.getReportFormat() == "csv") {
+                std::cout << SoupSearch::formatCsv(result);
+            } else if (config.getReportFormat() == "json") {
+                std::cout << SoupSearch::formatJson(result);
+            } else {
+                std::cout << SoupSearch::formatText(result);
+            }
+            return 0;
+        }
+        if (config.useHashLife()) {
+            return runHashLife(config);
+        }
+
+        LoadedPattern pattern;
+        if (!config.getFilePath().empty()) {
+            // Checkpoints resume where they stopped; a .golb grid stays backed by the mapped file
+            pattern = TextFileIO().loadPattern(config.getFilePath(), config.getThreads());
+            if (pattern.generation > static_cast<std::uint64_t>(std::numeric_limits<int>::max())) {
+                throw std::runtime_error("Snapshot generation is too large to resume");
+            }
+            std::cerr << (pattern.grid->hasExternalStorage() ? "Mapped " : "Loaded ") << config.getFilePath();
+            if (pattern.generation > 0) {
+                std::cerr << " at generation " << pattern.generation;
+            }
+            std::cerr << "\n";
+        } else {
+            pattern.grid = defaultGrid();
+        }
+
+        GameEngine engine(std::move(*pattern.grid), config.isToroidal() || pattern.toroidal);
+        engine.setGeneration(static_cast<int>(pattern.generation));
+        engine.setBackend(config.getBackend());
+        engine.setThreadCount(config.getThreads());
+        engine.setRule(config.getRule());
+        if (!config.hasRule() && !pattern.rule.empty()) {
+            // RLE files and snapshots name the rule they were made with
+            engine.setRule(Rule::parse(pattern.rule));
+            std::cerr << "Using rule " << engine.getRule().toString() << " from the file\n";
+        }
+        if (engine.getCellStates() && pattern.states) {
+            // Multi-state files carry decaying cells as well as live ones
+            engine.setCellStates(*pattern.states);
+        }
+
+        BatchRunner runner(config.getGenerations(), config.runUntilStable(), config.takeCensus());
+        BatchResult result;
+        if (!config.getDeltaLogPath().empty()) {
+            DeltaLogWriter log(config.getDeltaLogPath(), engine, config.getKeyframeInterval());
+            result = runner.run(engine, [&log](const GameEngine& stepped) { log.record(stepped); });
+            log.close();
+            std::cerr << "Wrote " << log.getRecordCount() << " generations (" << log.getKeyframeCount()
+                      << " keyframes) to: " << config.getDeltaLogPath() << "\n";
+        } else {
+            result = runner.run(engine);
+        }
+
+        if (!config.getOutputPath().empty()) {
+            TextFileIO fileIO;
+            if (BinarySnapshot::isSnapshotFileName(config.getOutputPath())) {
+                BinarySnapshot::save(engine, config.getOutputPath());
+            } else if (CompressedSnapshot::isSnapshotFileName(config.getOutputPath())) {
+                CompressedSnapshot::save(engine, config.getOutputPath(), config.getThreads());
+            } else if (engine.getCellStates()) {
+                fileIO.saveStates(*engine.getCellStates(), config.getOutputPath(), engine.getRule());
+            } else {
+                fileIO.saveGrid(engine.getCurrentGrid(), config.getOutputPath(), engine.getRule());
+            }
+            std::cerr << "Saved final grid to: " << config.getOutputPath() << "\n";
+        }
+
+        if (config.getReportFormat() == "json") {
+            std::cout << BatchRunner::formatJson(result, engine);
+        } else {
+            std::cout << BatchRunner::formatText(result, engine);
+        }
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        std::cerr << "\n" << Config::getUsage();
+        return 1;
+    }
+}
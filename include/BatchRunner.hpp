@@ -0,0 +1,71 @@
+#pragma once
+#include "GameEngine.hpp"
+#include "HashLife.hpp"
+#include "PatternCensus.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/**
+ * @brief Outcome and throughput of one headless run
+ */
+struct BatchResult {
+    std::uint64_t generations = 0;   // Generations actually computed
+    bool stabilized = false;         // Stopped because a generation changed nothing
+    double seconds = 0.0;            // Wall time spent stepping
+    std::uint64_t cellUpdates = 0;   // generations * rows * cols
+    std::uint64_t population = 0;    // Live cells in the final grid
+    std::size_t peakRssBytes = 0;    // Peak resident set of the process, 0 if unknown
+    bool censusTaken = false;        // census holds the final grid's objects
+    Census census;
+    double censusSeconds = 0.0;
+
+    double generationsPerSecond() const { return seconds > 0.0 ? generations / seconds : 0.0; }
+    double cellsPerSecond() const { return seconds > 0.0 ? cellUpdates / seconds : 0.0; }
+};
+
+/**
+ * @class BatchRunner
+ * @brief Drives a GameEngine without a display and measures the run
+ *
+ * Used by the console executable for server-side jobs: runs a fixed number
+ * of generations or until the grid stops changing, then reports speed and
+ * memory as text or JSON.
+ */
+class BatchRunner {
+public:
+    /**
+     * @param generations Generation limit; 0 means no limit (requires untilStable)
+     * @param untilStable Stop early once a step leaves the grid unchanged
+     * @param census Count the objects of the final grid with PatternCensus
+     */
+    BatchRunner(int generations, bool untilStable, bool census = false);
+
+    /// Called after every step, e.g. to record the generation; its time counts towards the run
+    using StepObserver = std::function<void(const GameEngine&)>;
+
+    BatchResult run(GameEngine& engine, const StepObserver& afterStep = {}) const;
+
+    /**
+     * @brief Advances a HashLife universe by the generation limit in one stepBy()
+     *
+     * HashLife has no per-step stability check or bounded grid, so
+     * untilStable and the census are not supported and cellUpdates stays 0.
+     * @throws std::invalid_argument without a generation limit, or with untilStable or census
+     */
+    BatchResult run(HashLifeEngine& engine) const;
+
+    /// Peak resident set size of this process in bytes (0 where unsupported).
+    static std::size_t peakResidentBytes();
+
+    static std::string formatText(const BatchResult& result, const GameEngine& engine);
+    static std::string formatJson(const BatchResult& result, const GameEngine& engine);
+    static std::string formatText(const BatchResult& result, const HashLifeEngine& engine);
+    static std::string formatJson(const BatchResult& result, const HashLifeEngine& engine);
+
+private:
+    int generations_;
+    bool untilStable_;
+    bool census_;
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include "GameEngine.hpp"
+#include "Grid.hpp"
+#include "Rule.hpp"
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief A board restored from a binary snapshot
+ */
+struct Snapshot {
+    Grid grid;  // Backed by the mapped file
+    Rule rule;
+    std::uint64_t generation = 0;
+    bool toroidal = false;
+};
+
+/**
+ * @class BinarySnapshot
+ * @brief Versioned binary checkpoints (.golb) loaded by memory mapping
+ *
+ * Layout, little-endian: a 48-byte header ("GOLB", version, payload offset,
+ * flags, rows, cols, words per row, rule length, generation, payload word
+ * count), the rule text, zero padding up to a multiple of 64 bytes, then
+ * the grid's own buffer: rows + 1 rows of 64-bit words, the last all zero.
+ *
+ * load() maps the file copy-on-write and hands the payload to the Grid as
+ * its storage, so loading costs a few system calls whatever the board size;
+ * pages are read from disk as the grid first touches them and edits stay
+ * private to the process. Copies of the grid are ordinary owned grids, so
+ * move it into a GameEngine: the engine steps the mapped grid in place and
+ * maps the file a second time as its reset() state.
+ *
+ * save() writes a temporary file and renames it over the target, so a
+ * snapshot still mapped by a grid is never truncated underneath it (on
+ * Windows, replacing a mapped snapshot fails instead). Only the live
+ * plane is stored: decaying cells of Generations rules are not kept.
+ */
+class BinarySnapshot {
+public:
+    static constexpr std::uint32_t kVersion = 1;
+
+    static void save(const Grid& grid, const std::string& filename, const Rule& rule = Rule(),
+                     std::uint64_t generation = 0, bool toroidal = false);
+    /// Current grid, rule, generation and topology of the engine
+    static void save(const GameEngine& engine, const std::string& filename);
+
+    /// @throws std::runtime_error if the file cannot be mapped, is truncated,
+    ///         is not a snapshot or has a newer version
+    static Snapshot load(const std::string& filename);
+
+    /// True if the file starts with the snapshot magic
+    static bool isSnapshot(const std::string& filename);
+    /// True for names ending in ".golb" (any case)
+    static bool isSnapshotFileName(const std::string& filename);
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include "BinarySnapshot.hpp"
+#include "GameEngine.hpp"
+#include "Grid.hpp"
+#include "Rule.hpp"
+#include <cstdint>
+#include <string>
+
+/**
+ * @class CompressedSnapshot
+ * @brief Tiled, compressed checkpoints (.golz) for mostly empty boards
+ *
+ * The board is cut into 64x64-cell tiles, one packed word per tile row
+ * (the engine's tiled backend uses the same tiles). Empty tiles are not
+ * stored at all. Each other tile is stored either raw (512 bytes) or, when
+ * smaller, zero-suppressed: a 64-bit mask of its non-zero words, then per
+ * such word a byte mask and its non-zero bytes. A glider's tile takes 15
+ * bytes.
+ *
+ * Layout, little-endian: a header ("GOLZ", version, dimensions, flags,
+ * generation, tile count, rule text), an index of (tile row, tile column,
+ * offset, size) sorted by tile row then column, then the tile data. The
+ * index lets loadRegion() read only the tiles a window touches.
+ *
+ * Tiles are encoded and decoded on a ThreadPool, one tile row per task.
+ */
+class CompressedSnapshot {
+public:
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr int kTileSize = Grid::kWordBits;
+
+    /// @param threads Threads for encoding; 0 uses every hardware thread
+    static void save(const Grid& grid, const std::string& filename, const Rule& rule = Rule(),
+                     std::uint64_t generation = 0, bool toroidal = false, int threads = 0);
+    static void save(const GameEngine& engine, const std::string& filename, int threads = 0);
+
+    /// @throws std::runtime_error if the file is missing, damaged, not a
+    ///         compressed snapshot or has a newer version
+    static Snapshot load(const std::string& filename, int threads = 0);
+
+    /// The rule from the header, without reading or decoding any tiles
+    /// @throws std::runtime_error as load() does for a damaged header
+    static Rule loadRule(const std::string& filename);
+
+    /**
+     * @brief Decodes only the tiles overlapping a window of the board
+     * @return A rows x cols grid holding cells [top, top + rows) x [left, left + cols)
+     * @throws std::out_of_range if the window is empty or leaves the board
+     */
+    static Grid loadRegion(const std::string& filename, int top, int left, int rows, int cols);
+
+    /// True if the file starts with the compressed snapshot magic
+    static bool isSnapshot(const std::string& filename);
+    /// True for names ending in ".golz" (any case)
+    static bool isSnapshotFileName(const std::string& filename);
+};
@@ -0,0 +1,172 @@
+#pragma once
+#include "GameEngine.hpp"
+#include "Grid.hpp"
+#include "Rule.hpp"
+#include "SpscQueue.hpp"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @class DeltaLogWriter
+ * @brief Append-only log (.gold) of a run's generations as flipped cells
+ *
+ * Layout, little-endian: a header ("GOLD", version, flags, rows, cols,
+ * keyframe interval, rule text), then one record per generation: a tag
+ * byte ('K' keyframe, 'D' delta), the generation (for a delta, its
+ * distance from the previous record) and the payload length as varints,
+ * then the payload. A delta lists the cells flipped since the previous
+ * record as varint gaps between row-major cell indices; a keyframe lists
+ * the live cells the same way, or holds the packed words when that is
+ * smaller. close() appends an index of the keyframes and a 16-byte
+ * trailer pointing at it.
+ *
+ * record() encodes on the calling thread, at a cost proportional to the
+ * changes, and hands the bytes to an I/O thread through an SpscQueue;
+ * spent buffers come back through a second one. The simulation only waits
+ * when the disk falls a whole queue (1024 records) behind. Under a
+ * Generations rule only the live plane is logged.
+ */
+class DeltaLogWriter {
+public:
+    static constexpr std::uint32_t kVersion = 1;
+
+    /**
+     * @brief Creates the file and logs the engine's current grid as a keyframe
+     *
+     * Turns on the engine's change tracking, which the deltas are built from.
+     * @param keyframeInterval Most generations between keyframes
+     * @throws std::runtime_error if the file cannot be created
+     */
+    DeltaLogWriter(const std::string& filename, GameEngine& engine, int keyframeInterval = 1000);
+    ~DeltaLogWriter();  // Closes the log; errors are only reported by close()
+
+    DeltaLogWriter(const DeltaLogWriter&) = delete;
+    DeltaLogWriter& operator=(const DeltaLogWriter&) = delete;
+
+    /**
+     * @brief Appends the engine's current generation, normally after each step()
+     *
+     * Written as a delta when the previous generation was the last one
+     * recorded, the engine's change list is complete and no longer than the
+     * live cell list, and the last keyframe is fewer than keyframeInterval
+     * generations back; as a keyframe otherwise.
+     * @throws std::invalid_argument if the generation does not increase or the grid was resized
+     * @throws std::runtime_error if an earlier write failed
+     */
+    void record(const GameEngine& engine);
+
+    /// Waits for the queued records, writes the index and closes the file
+    /// @throws std::runtime_error if any write failed
+    void close();
+
+    std::uint64_t getRecordCount() const { return records_; }
+    std::uint64_t getKeyframeCount() const { return keyframes_; }
+
+    /// True for names ending in ".gold" (any case)
+    static bool isDeltaLogFileName(const std::string& filename);
+
+private:
+    struct Record;
+    using RecordPtr = std::unique_ptr<Record>;
+
+    std::string filename_;
+    std::ofstream file_;
+    int rows_;
+    int cols_;
+    int keyframeInterval_;
+    std::uint64_t lastGeneration_;
+    std::uint64_t lastKeyframe_;
+    std::uint64_t records_;
+    std::uint64_t keyframes_;
+    bool closed_;
+
+    // Filled records to the I/O thread, empty ones back for reuse; a null
+    // record tells the I/O thread to finish
+    SpscQueue<RecordPtr> filled_;
+    SpscQueue<RecordPtr> spare_;
+    std::thread io_;
+    std::atomic<bool> failed_;
+    std::string error_;  // Set by the I/O thread before failed_
+
+    // Owned by the I/O thread: keyframe (generation, file offset) pairs
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> keyframeIndex_;
+    std::uint64_t offset_;
+
+    void append(const GameEngine& engine, bool forceKeyframe);
+    void writeRecords();
+    void writeIndex(std::uint64_t lastGeneration);
+};
+
+/**
+ * @class DeltaLogReader
+ * @brief Replays a delta log, seeking through its keyframe index
+ *
+ * seek() starts from the nearest keyframe at or before the target (or the
+ * current position, when that is closer) and applies the deltas after it.
+ * A log whose writer never closed it has no index; it is scanned on open
+ * instead, and a record cut short at the end is ignored.
+ */
+class DeltaLogReader {
+public:
+    /// @throws std::runtime_error if the file is missing, not a delta log or has a newer version
+    explicit DeltaLogReader(const std::string& filename);
+
+    int getRows() const { return rows_; }
+    int getCols() const { return cols_; }
+    const Rule& getRule() const { return rule_; }
+    bool isToroidal() const { return toroidal_; }
+    std::uint64_t getFirstGeneration() const { return keyframes_.front().first; }
+    std::uint64_t getLastGeneration() const { return lastGeneration_; }
+    std::size_t getKeyframeCount() const { return keyframes_.size(); }
+    /// False if the log was recovered by scanning because the index was missing
+    bool hasIndex() const { return indexed_; }
+
+    /**
+     * @brief Moves to the last recorded generation at or before generation
+     * @throws std::out_of_range outside [getFirstGeneration(), getLastGeneration()]
+     * @throws std::runtime_error on a corrupt record
+     */
+    void seek(std::uint64_t generation);
+    /// Moves to the next recorded generation; false at the end of the log
+    bool next();
+
+    const Grid& getGrid() const { return grid_; }
+    std::uint64_t getGeneration() const { return generation_; }
+
+private:
+    struct RecordHeader {
+        char tag;
+        std::uint64_t generation;
+        std::uint64_t payloadOffset;
+        std::uint64_t payloadBytes;
+    };
+
+    std::string filename_;
+    std::ifstream file_;
+    int rows_;
+    int cols_;
+    Rule rule_;
+    bool toroidal_;
+    bool indexed_;
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> keyframes_;  // (generation, offset)
+    std::uint64_t lastGeneration_;
+    std::uint64_t endOffset_;  // End of the records
+
+    Grid grid_;
+    std::uint64_t generation_;
+    std::uint64_t position_;  // Offset of the next record
+    std::vector<char> payload_;
+
+    // Header of the record at offset, a delta following previousGeneration;
+    // false if it is malformed or does not fit before end
+    bool readRecordHeader(std::uint64_t offset, std::uint64_t previousGeneration, std::uint64_t end,
+                          RecordHeader& header);
+    void apply(const RecordHeader& header);
+    void scanRecords(std::uint64_t offset, std::uint64_t fileBytes);
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+/**
+ * @namespace FileFormat
+ * @brief Byte-level helpers shared by the pattern, snapshot and delta log files
+ *
+ * Internal to the file readers and writers (TextFileIO, BinarySnapshot,
+ * CompressedSnapshot, DeltaLog): little-endian integers, extension checks
+ * and replacing a file without ever leaving it half written.
+ */
+namespace FileFormat {
+
+inline void put32(std::vector<char>& out, std::uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<char>(value >> shift));
+    }
+}
+
+inline void put64(std::vector<char>& out, std::uint64_t value) {
+    for (int shift = 0; shift < 64; shift += 8) {
+        out.push_back(static_cast<char>(value >> shift));
+    }
+}
+
+inline std::uint32_t get32(const char* bytes) {
+    std::uint32_t value = 0;
+    for (int i = 3; i >= 0; --i) {
+        value = (value << 8) | static_cast<unsigned char>(bytes[i]);
+    }
+    return value;
+}
+
+inline std::uint64_t get64(const char* bytes) {
+    return get32(bytes) | (std::uint64_t{get32(bytes + 4)} << 32);
+}
+
+/// True if @p text ends with @p suffix, ASCII letters compared in any case
+inline bool endsWithIgnoreCase(const std::string& text, const std::string& suffix) {
+    if (text.size() < suffix.size()) {
+        return false;
+    }
+    std::size_t offset = text.size() - suffix.size();
+    for (std::size_t i = 0; i < suffix.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(text[offset + i])) !=
+            std::tolower(static_cast<unsigned char>(suffix[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Writes @p filename through a temporary file renamed over it
+ *
+ * @p write fills the stream; readers, and grids still mapping the old
+ * file, never see it truncated or half written. On Windows, replacing a
+ * mapped file fails instead.
+ *
+ * @throws std::runtime_error if the file cannot be created, written or renamed
+ */
+template <typename Write>
+void replaceFile(const std::string& filename, Write&& write) {
+    std::string temporary = filename + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Cannot create file: " + filename);
+        }
+        write(file);
+        if (!file) {
+            file.close();
+            std::remove(temporary.c_str());
+            throw std::runtime_error("Cannot write file: " + filename);
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, filename, error);
+    if (error) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Cannot replace file " + filename + ": " + error.message());
+    }
+}
+
+} // namespace FileFormat
@@ -0,0 +1,74 @@
+#pragma once
+#include "Grid.hpp"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @struct GridHash
+ * @brief 128-bit hash of a grid's live cells that is updated word by word
+ *
+ * The hash is a sum, per 64-bit half, of one mixed term for every packed
+ * word keyed by the word's index, so replacing a word only needs its old
+ * and new value; GameEngine uses that to carry the hash along the words
+ * each step changed. Empty words contribute nothing, so an empty grid
+ * hashes to zero. The halves use independent mixers: remembering a few
+ * thousand states, a collision is about as likely as 2^-100.
+ */
+struct GridHash {
+    std::uint64_t low = 0;
+    std::uint64_t high = 0;
+
+    bool operator==(const GridHash& other) const = default;
+
+    /// Hash of every word of the grid
+    static GridHash of(const Grid& grid) {
+        GridHash hash;
+        std::size_t count = static_cast<std::size_t>(grid.getRows()) * grid.getWordsPerRow();
+        const Grid::Word* words = grid.data();
+        for (std::size_t index = 0; index < count; ++index) {
+            hash.add(index, words[index]);
+        }
+        return hash;
+    }
+
+    /// Accounts for word @p index changing from @p before to @p after
+    void replaceWord(std::size_t index, Grid::Word before, Grid::Word after) {
+        if (before != after) {
+            remove(index, before);
+            add(index, after);
+        }
+    }
+
+private:
+    // Murmur3's 64-bit finaliser, a bijection with full avalanche
+    static std::uint64_t mix(std::uint64_t x, std::uint64_t m1, std::uint64_t m2) {
+        x ^= x >> 33;
+        x *= m1;
+        x ^= x >> 33;
+        x *= m2;
+        x ^= x >> 33;
+        return x;
+    }
+
+    static std::uint64_t lowTerm(std::size_t index, Grid::Word word) {
+        return mix(word ^ (index * 0x9E3779B97F4A7C15ull), 0xFF51AFD7ED558CCDull, 0xC4CEB9FE1A85EC53ull);
+    }
+
+    static std::uint64_t highTerm(std::size_t index, Grid::Word word) {
+        return mix(word + (index + 1) * 0xD6E8FEB86659FD93ull, 0xBF58476D1CE4E5B9ull, 0x94D049BB133111EBull);
+    }
+
+    void add(std::size_t index, Grid::Word word) {
+        if (word) {
+            low += lowTerm(index, word);
+            high += highTerm(index, word);
+        }
+    }
+
+    void remove(std::size_t index, Grid::Word word) {
+        if (word) {
+            low -= lowTerm(index, word);
+            high -= highTerm(index, word);
+        }
+    }
+};
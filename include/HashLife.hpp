@@ -0,0 +1,139 @@
+#pragma once
+#include "Grid.hpp"
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class HashLifeEngine
+ * @brief Memoized quadtree (HashLife) engine for fast-forwarding large patterns
+ *
+ * The universe is an unbounded plane stored as a canonical quadtree: every
+ * distinct square of cells exists once, and each node caches the result of
+ * advancing its centre, so repetitive patterns such as methuselahs or guns
+ * can be advanced by 2^k generations in time far below k single steps.
+ *
+ * Unlike GameEngine there is no bounded or toroidal edge; a loaded Grid is
+ * placed at (0, 0) and may grow beyond it. toGrid() cuts a window back out
+ * for rendering or saving.
+ */
+class HashLifeEngine {
+public:
+    HashLifeEngine();
+    explicit HashLifeEngine(const Grid& grid);
+
+    // Loading and exporting
+    void loadGrid(const Grid& grid);
+    Grid toGrid() const;  // Window of the grid that was loaded
+    Grid toGrid(int rows, int cols, std::int64_t top, std::int64_t left) const;
+    bool getCell(std::int64_t row, std::int64_t col) const;
+    void clear();
+
+    /// Smallest rectangle holding every live cell; rows and cols are 0 when there are none
+    struct Bounds {
+        std::int64_t top = 0;
+        std::int64_t left = 0;
+        std::int64_t rows = 0;
+        std::int64_t cols = 0;
+    };
+    Bounds getBounds() const;
+
+    /**
+     * @brief Macrocell files (Golly's "[M2]" format)
+     *
+     * Each line is one quadtree node: an 8x8 leaf drawn with '.', '*' and
+     * '$', or "level nw ne sw se" naming earlier lines (0 for empty). Lines
+     * are joined straight into the canonical node table, so a pattern with
+     * shared structure loads in time and memory proportional to the file,
+     * not its area. As in Golly, cell (0, 0) is the centre of the root.
+     *
+     * readMacrocell() replaces the universe, takes the generation from "#G"
+     * and returns the "#R" rule (empty if none); stepping always uses
+     * B3/S23. writeMacrocell() may add nodes to re-centre the root.
+     * @throws std::runtime_error on malformed lines
+     */
+    std::string readMacrocell(std::istream& in);
+    void writeMacrocell(std::ostream& out, const std::string& rule);
+
+    // Simulation
+    void step() { stepPow2(0); }
+    void stepPow2(int exponent);             // Advances 2^exponent generations
+    void stepBy(std::uint64_t generations);  // Advances by any count, one power of two per set bit
+    std::uint64_t getGeneration() const { return generation_; }
+    std::uint64_t getPopulation() const;
+
+    // Memory management
+    std::size_t getNodeCount() const { return nodes_.size() - freeNodes_.size(); }
+    void setNodeLimit(std::size_t limit) { nodeLimit_ = limit; }
+    void collectGarbage();
+
+protected:
+    using NodeId = std::uint32_t;
+    static constexpr NodeId kNone = 0xFFFFFFFFu;
+    static constexpr NodeId kDeadCell = 0;   // Level-0 leaves
+    static constexpr NodeId kLiveCell = 1;
+
+    struct Node {
+        NodeId nw, ne, sw, se;
+        NodeId result;             // Centre advanced 2^(level-2) generations, or kNone
+        std::uint64_t population;
+        std::uint8_t level;
+    };
+
+    // Canonical node for the four quadrants (hash-consed)
+    NodeId join(NodeId nw, NodeId ne, NodeId sw, NodeId se);
+    NodeId emptyNode(int level);
+    const Node& node(NodeId id) const { return nodes_[id]; }
+
+    // Root covers [originRow_, +2^level) x [originCol_, +2^level)
+    void setRoot(NodeId root, std::int64_t originRow, std::int64_t originCol);
+    NodeId getRoot() const { return root_; }
+
+private:
+    std::vector<Node> nodes_;
+    std::vector<NodeId> freeNodes_;
+    std::vector<NodeId> table_;  // Open addressing over node ids
+    std::size_t tableUsed_;
+    std::vector<NodeId> empties_;
+    std::unordered_map<std::uint64_t, NodeId> slowResults_;  // (node, exponent) below full speed
+    std::size_t nodeLimit_;
+
+    NodeId root_;
+    std::int64_t originRow_;
+    std::int64_t originCol_;
+    int windowRows_;
+    int windowCols_;
+    std::uint64_t generation_;
+
+    static std::uint64_t hashChildren(NodeId nw, NodeId ne, NodeId sw, NodeId se);
+    NodeId allocateNode(const Node& value);
+    void insertIntoTable(NodeId id);
+    void growTable();
+
+    NodeId centre(NodeId id);
+    NodeId successor(NodeId id, int exponent);
+    NodeId baseCase(NodeId id);
+    NodeId expand(NodeId id);
+    bool isPadded(NodeId id) const;
+
+    NodeId build(const Grid& grid, int level, std::int64_t top, std::int64_t left);
+    NodeId buildLeaf(std::uint64_t cells, int level, int top, int left);
+    std::uint64_t leafCells(NodeId id, int top, int left) const;
+    // Level-`level` node covering [top, +2^level) x [left, +2^level) of the
+    // universe; the shifts below the root are memoized per block in memo
+    NodeId window(int level, std::int64_t top, std::int64_t left, std::unordered_map<NodeId, NodeId>& memo);
+    // Node one level below block at offset (dy, dx) inside it; every call
+    // sharing a memo must use the same offsets modulo the level's size
+    NodeId shifted(NodeId block, std::int64_t dy, std::int64_t dx, std::unordered_map<NodeId, NodeId>& memo);
+    std::uint64_t writeNode(NodeId id, std::ostream& out, std::unordered_map<NodeId, std::uint64_t>& lines,
+                            std::uint64_t& lineCount) const;
+    // Live-cell extent of a node, relative to its top-left corner
+    struct Extent {
+        std::int64_t top, left, bottom, right;  // Inclusive
+    };
+    Extent extent(NodeId id, std::unordered_map<NodeId, Extent>& memo) const;
+    void paint(NodeId id, std::int64_t top, std::int64_t left, Grid& grid,
+               std::int64_t windowTop, std::int64_t windowLeft) const;
+};
@@ -0,0 +1,133 @@
+#pragma once
+#include "Grid.hpp"
+#include "ThreadPool.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @class LargerThanLifeRule
+ * @brief Larger-than-Life rule: birth and survival ranges over a radius-R neighbourhood
+ *
+ * Written in Golly's notation, e.g. "R5,C0,M1,S34..58,B34..45,NM" (Bosco's
+ * rule): radius 5, two states, the middle cell counted, survival on 34-58
+ * live cells, birth on 34-45, Moore (square) neighbourhood. "NN" selects the
+ * von Neumann (diamond) neighbourhood instead.
+ */
+class LargerThanLifeRule {
+public:
+    enum class Neighborhood {
+        Moore,      // |dr| <= R and |dc| <= R
+        VonNeumann  // |dr| + |dc| <= R
+    };
+
+    static constexpr int kMaxRadius = 10;
+
+    LargerThanLifeRule();  // R1,C0,M0,S2..3,B3..3,NM - Conway's Life
+    /// @throws std::invalid_argument for a radius outside 1..10 or ranges the neighbourhood cannot reach
+    LargerThanLifeRule(int radius, Neighborhood neighborhood, bool countsMiddle,
+                       int birthMin, int birthMax, int survivalMin, int survivalMax);
+
+    /**
+     * @brief Parses Golly's "R..,C..,M..,S..,B..,N.." notation or a name
+     *        ("bosco", "majority")
+     *
+     * C may be omitted, 0 or 2; multi-state Larger-than-Life is not supported.
+     * M defaults to 0 and N to Moore. A range may be a single count.
+     * @throws std::invalid_argument if the text is not a valid rule
+     */
+    static LargerThanLifeRule parse(const std::string& text);
+
+    int getRadius() const { return radius_; }
+    Neighborhood getNeighborhood() const { return neighborhood_; }
+    bool countsMiddle() const { return countsMiddle_; }
+    int getBirthMin() const { return birthMin_; }
+    int getBirthMax() const { return birthMax_; }
+    int getSurvivalMin() const { return survivalMin_; }
+    int getSurvivalMax() const { return survivalMax_; }
+
+    /// Cells in the neighbourhood, including the middle cell when it is counted
+    int getNeighborhoodSize() const;
+    bool nextState(bool alive, int count) const {
+        return alive ? (count >= survivalMin_ && count <= survivalMax_)
+                     : (count >= birthMin_ && count <= birthMax_);
+    }
+
+    /// Canonical Golly form
+    std::string toString() const;
+
+    bool operator==(const LargerThanLifeRule& other) const;
+    bool operator!=(const LargerThanLifeRule& other) const { return !(*this == other); }
+
+private:
+    int radius_;
+    Neighborhood neighborhood_;
+    bool countsMiddle_;
+    int birthMin_;
+    int birthMax_;
+    int survivalMin_;
+    int survivalMax_;
+};
+
+/**
+ * @class LargerThanLifeEngine
+ * @brief Steps a Grid under a LargerThanLifeRule at a cost per cell independent of the radius
+ *
+ * Each row band copies its rows plus a radius-wide halo into a byte
+ * window (wrapped on a torus, zero past a bounded edge). Moore counts then
+ * come from column sums slid down the band and a running sum slid along
+ * each row; von Neumann counts slide the diamond down one row at a time,
+ * adding and removing its two diagonal edges through diagonal prefix sums.
+ * Both do a constant amount of work per cell for any radius. Bands are
+ * independent, so they run in parallel on the thread pool.
+ */
+class LargerThanLifeEngine {
+public:
+    LargerThanLifeEngine(const Grid& grid, const LargerThanLifeRule& rule, bool toroidal = false);
+    ~LargerThanLifeEngine();
+
+    void step();
+    const Grid& getCurrentGrid() const { return *current_; }
+    /// @throws std::invalid_argument if the dimensions differ
+    void setCurrentGrid(const Grid& grid);
+    int getGeneration() const { return generation_; }
+    bool isStable() const { return isStable_; }
+    bool isToroidal() const { return toroidal_; }
+
+    void setRule(const LargerThanLifeRule& rule) { rule_ = rule; isStable_ = false; }
+    const LargerThanLifeRule& getRule() const { return rule_; }
+
+    /// Worker threads for row bands; 1 runs serially, 0 uses every hardware thread
+    void setThreadCount(int threads);
+    int getThreadCount() const { return pool_ ? pool_->getThreadCount() : 1; }
+
+    /// Neighbourhood count of one cell, summed directly (for checks and tools)
+    int countNeighbors(int row, int col) const;
+
+private:
+    // Per-band buffers, kept between steps so stepping does not allocate.
+    // Windows are (band rows + 2 * halo) x (cols + 2 * halo), halo = R + 1.
+    struct BandScratch {
+        std::vector<std::uint8_t> window;
+        std::vector<std::uint16_t> columnSums;  // Moore: vertical window sums per column
+        std::vector<std::uint16_t> counts;      // Neighbourhood counts of the current row
+        std::vector<std::uint16_t> diagDown;    // Von Neumann: prefix sums along down-right diagonals
+        std::vector<std::uint16_t> diagUp;      // Von Neumann: prefix sums along down-left diagonals
+    };
+
+    std::unique_ptr<Grid> current_;
+    std::unique_ptr<Grid> next_;
+    LargerThanLifeRule rule_;
+    bool toroidal_;
+    int generation_;
+    bool isStable_;
+    std::unique_ptr<ThreadPool> pool_;
+    std::vector<BandScratch> scratch_;
+
+    bool stepBand(int rowBegin, int rowEnd, BandScratch& scratch);
+    void fillWindow(int rowBegin, int rowEnd, BandScratch& scratch) const;
+    void countMooreRow(BandScratch& scratch, int y, bool first) const;
+    void buildDiagonals(BandScratch& scratch, int height) const;
+    void countVonNeumannRow(BandScratch& scratch, int y, bool first) const;
+};
@@ -0,0 +1,349 @@
+#pragma once
+#include "Grid.hpp"
+#include "MultiStateGrid.hpp"
+#include "Rule.hpp"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+/**
+ * @namespace LifeKernels
+ * @brief Bit-parallel (SWAR) generation kernels over Grid's packed words
+ *
+ * Each kernel treats a 64-bit word as 64 independent cells and sums the
+ * eight neighbour bitboards with a bit-sliced adder tree, so one pass of
+ * a dozen logic operations advances 64 cells at once. On x86 the interior
+ * words of each row are further processed 4 or 8 words per instruction
+ * (AVX2 / AVX-512), chosen once at startup from CPUID.
+ *
+ * Every entry point takes a Rule. Conway and a set of common B/S rules run
+ * kernels specialised on the rule at compile time; any other rule uses a
+ * generic kernel that looks its masks up per neighbour count.
+ */
+#if defined(__GNUC__)
+// Forced so the adder is expanded inside each ISA-specific kernel body
+#define LIFE_KERNELS_INLINE __attribute__((always_inline)) inline
+#else
+#define LIFE_KERNELS_INLINE inline
+#endif
+
+namespace LifeKernels {
+
+using Word = Grid::Word;
+
+/**
+ * @brief Conway's B3/S23 rule applied to 64 cells in parallel
+ *
+ * Arguments are the neighbour bitboards already aligned on the centre
+ * cells. Written against plain bitwise operators so it also works on
+ * compiler vector types holding several words.
+ */
+template <typename W>
+LIFE_KERNELS_INLINE W conwayNext(const W& nw, const W& n, const W& ne,
+                                 const W& w, const W& c, const W& e,
+                                 const W& sw, const W& s, const W& se) {
+    // Row triples as 2-bit counts (0..3); the middle row excludes the centre
+    W topXor = nw ^ n;
+    W topOnes = topXor ^ ne;
+    W topTwos = (nw & n) | (topXor & ne);
+    W botXor = sw ^ s;
+    W botOnes = botXor ^ se;
+    W botTwos = (sw & s) | (botXor & se);
+    W midOnes = w ^ e;
+    W midTwos = w & e;
+
+    // Add the three ones columns, carrying into the twos column
+    W onesXor = topOnes ^ botOnes;
+    W ones = onesXor ^ midOnes;
+    W carry = (topOnes & botOnes) | (onesXor & midOnes);
+
+    // Total is 2 or 3 exactly when a single one of the four twos bits is set
+    W pairA = topTwos ^ botTwos;
+    W pairB = midTwos ^ carry;
+    W twosIsOne = (pairA ^ pairB) & ~((topTwos & botTwos) | (midTwos & carry));
+
+    return twosIsOne & (ones | c);
+}
+
+/// Bit-sliced neighbour count (0..8) of 64 cells: count = 8*bit3 + 4*bit2 + 2*bit1 + bit0
+template <typename W>
+struct NeighbourCount {
+    W bit0, bit1, bit2, bit3;
+};
+
+/// Sums the eight neighbour bitboards into a bit-sliced count
+template <typename W>
+LIFE_KERNELS_INLINE NeighbourCount<W> countNeighbours(const W& nw, const W& n, const W& ne,
+                                                      const W& w, const W& e,
+                                                      const W& sw, const W& s, const W& se) {
+    // Top and bottom triples as 2-bit sums, the middle pair as a 2-bit sum
+    W topXor = nw ^ n;
+    W top0 = topXor ^ ne;
+    W top1 = (nw & n) | (topXor & ne);
+    W botXor = sw ^ s;
+    W bot0 = botXor ^ se;
+    W bot1 = (sw & s) | (botXor & se);
+    W mid0 = w ^ e;
+    W mid1 = w & e;
+
+    // top + bottom (0..6) as three bits
+    W sum0 = top0 ^ bot0;
+    W carry0 = top0 & bot0;
+    W twosXor = top1 ^ bot1;
+    W sum1 = twosXor ^ carry0;
+    W sum2 = (top1 & bot1) | (twosXor & carry0);
+
+    // ... + middle (0..8) as four bits
+    NeighbourCount<W> count;
+    count.bit0 = sum0 ^ mid0;
+    W carry1 = sum0 & mid0;
+    W onesXor = sum1 ^ mid1;
+    count.bit1 = onesXor ^ carry1;
+    W carry2 = (sum1 & mid1) | (onesXor & carry1);
+    count.bit2 = sum2 ^ carry2;
+    count.bit3 = sum2 & carry2;
+    return count;
+}
+
+/// A count bit, or its complement when the wanted count has that bit clear
+template <bool Set, typename W>
+LIFE_KERNELS_INLINE W matchBit(const W& bit) {
+    if constexpr (Set) {
+        return bit;
+    } else {
+        return ~bit;
+    }
+}
+
+/// Cells whose neighbour count equals K
+template <int K, typename W>
+LIFE_KERNELS_INLINE W countEquals(const NeighbourCount<W>& count) {
+    static_assert(K >= 0 && K <= 8, "neighbour counts are 0..8");
+    if constexpr (K == 8) {
+        return count.bit3;  // 8 is the only count with bit 3 set
+    } else if constexpr (K == 0) {
+        return ~(count.bit0 | count.bit1 | count.bit2 | count.bit3);
+    } else {
+        // Counts 1..7 have a low bit set, which already excludes 8
+        return matchBit<(K & 1) != 0>(count.bit0) & matchBit<(K & 2) != 0>(count.bit1) &
+               matchBit<(K & 4) != 0>(count.bit2);
+    }
+}
+
+template <unsigned Mask, int K, typename W>
+LIFE_KERNELS_INLINE W countTerm(const NeighbourCount<W>& count) {
+    if constexpr (((Mask >> K) & 1u) != 0) {
+        return countEquals<K>(count);
+    } else {
+        return W{};
+    }
+}
+
+/// Cells whose count is in Mask, folded at compile time into a fixed expression
+template <unsigned Mask, typename W, int... K>
+LIFE_KERNELS_INLINE W countIn(const NeighbourCount<W>& count, std::integer_sequence<int, K...>) {
+    return (W{} | ... | countTerm<Mask, K>(count));
+}
+
+/**
+ * @brief Any B/S rule applied to 64 cells, with the masks fixed at compile time
+ *
+ * Counts that appear in neither mask vanish from the expression, so each
+ * rule instantiates its own branch-free and lookup-free kernel.
+ */
+template <unsigned Birth, unsigned Survival, typename W>
+LIFE_KERNELS_INLINE W ruleNext(const W& nw, const W& n, const W& ne,
+                               const W& w, const W& c, const W& e,
+                               const W& sw, const W& s, const W& se) {
+    NeighbourCount<W> count = countNeighbours(nw, n, ne, w, e, sw, s, se);
+    constexpr auto counts = std::make_integer_sequence<int, 9>();
+    if constexpr (Birth == Survival) {
+        return countIn<Birth>(count, counts);  // Next state ignores the centre
+    } else {
+        return (countIn<Birth>(count, counts) & ~c) | (countIn<Survival>(count, counts) & c);
+    }
+}
+
+/// Neighbour at column - 1 shifted onto each cell, pulling bit 63 of the previous word.
+inline Word westOf(Word word, Word previous) {
+    return (word << 1) | (previous >> 63);
+}
+
+/// Neighbour at column + 1 shifted onto each cell, pulling bit 0 of the next word.
+inline Word eastOf(Word word, Word next) {
+    return (word >> 1) | (next << 63);
+}
+
+/**
+ * @brief Instruction set used for the interior words of each row
+ */
+enum class Isa {
+    Scalar,   // Portable 64-bit words, always available
+    Avx2,     // 256-bit lanes, 256 cells per operation
+    Avx512    // 512-bit lanes, 512 cells per operation
+};
+
+/// True when this build and the running CPU can execute the given kernel.
+bool isSupported(Isa isa);
+
+/// Best supported kernel, detected once via CPUID.
+Isa detectIsa();
+
+/// Kernel currently used by stepRow(); defaults to detectIsa().
+Isa activeIsa();
+
+/// Forces a kernel (for benchmarks and self-checks); returns false if unsupported.
+bool setActiveIsa(Isa isa);
+
+std::string isaName(Isa isa);
+
+/**
+ * @brief Compares every supported kernel with Grid::countNeighbors on random grids
+ *
+ * Covers Conway, a specialised non-Conway rule and the generic rule kernel.
+ *
+ * @param report Receives one line per kernel checked (may be null)
+ * @return true if all kernels agree with the reference rule
+ */
+bool selfCheck(std::string* report = nullptr);
+
+/**
+ * @brief Cells a kernel call turned on and off in the rows or words it wrote
+ *
+ * Kernels fill it with popcounts of the flipped bits of each output word
+ * while the words are still in registers; pass null to skip counting.
+ */
+struct StepCounts {
+    std::int64_t births = 0;
+    std::int64_t deaths = 0;
+
+    StepCounts& operator+=(const StepCounts& other) {
+        births += other.births;
+        deaths += other.deaths;
+        return *this;
+    }
+};
+
+/**
+ * @brief Computes one output row from its three input rows
+ *
+ * @param above,row,below Packed input rows (pass Grid::zeroRow() past the edge of a bounded grid)
+ * @param out Packed output row; padding bits are left clear
+ * @param words Words per row
+ * @param cols Number of columns in the row
+ * @param toroidal Wrap the first and last columns onto each other
+ * @param rule Birth/survival rule to apply
+ */
+void stepRow(const Word* above, const Word* row, const Word* below, Word* out,
+             int words, int cols, bool toroidal, const Rule& rule = Rule());
+
+/**
+ * @brief Computes rows [rowBegin, rowEnd) of the next generation
+ *
+ * Reads only from current, writes only those rows of next, so disjoint
+ * row ranges may run concurrently. Both grids must have equal dimensions.
+ *
+ * @return true if any cell in those rows differs between current and next
+ */
+bool stepRows(const Grid& current, Grid& next, int rowBegin, int rowEnd, bool toroidal,
+              const Rule& rule = Rule(), StepCounts* counts = nullptr);
+
+/// Rows per tile for stepTile(); a tile is one word (64 columns) wide.
+constexpr int kTileRows = 64;
+
+/**
+ * @brief Computes one 64x64 tile of the next generation
+ *
+ * The tile spans rows [tileRow * kTileRows, +kTileRows) clipped to the
+ * grid, and word column tileCol. Distinct tiles write disjoint words, so
+ * they may run concurrently.
+ *
+ * @return true if any cell of the tile differs between current and next
+ */
+bool stepTile(const Grid& current, Grid& next, int tileRow, int tileCol, bool toroidal,
+              const Rule& rule = Rule(), StepCounts* counts = nullptr);
+
+/**
+ * @brief Computes only the listed words of the next generation
+ *
+ * Each entry of @p indices is row * getWordsPerRow() + word column; every
+ * other word of next is left untouched. Entries must be distinct, and
+ * disjoint lists may run concurrently.
+ */
+void stepWords(const Grid& current, Grid& next, const std::uint32_t* indices, std::size_t count,
+               bool toroidal, const Rule& rule = Rule(), StepCounts* counts = nullptr);
+
+/// Computes the whole next generation of current into next; true if anything changed.
+inline bool step(const Grid& current, Grid& next, bool toroidal, const Rule& rule = Rule()) {
+    return stepRows(current, next, 0, current.getRows(), toroidal, rule);
+}
+
+/// True if the rule has a compile-time specialised kernel (otherwise the generic one runs).
+bool isSpecialized(const Rule& rule);
+
+/**
+ * @brief Next state of the 2x2 centre of every 4x4 block
+ *
+ * Bit 4 * r + c of the index is cell (r, c) of the block; bit 2 * r + c of
+ * the entry is the next state of centre cell (r + 1, c + 1). One byte per
+ * entry keeps the table at 64 KiB, small enough to stay in L2.
+ */
+using BlockTable = std::array<std::uint8_t, 1 << 16>;
+
+constexpr BlockTable makeBlockTable(std::uint16_t birthMask, std::uint16_t survivalMask) {
+    BlockTable table{};
+    for (unsigned index = 0; index < table.size(); ++index) {
+        std::uint8_t entry = 0;
+        for (int r = 0; r < 2; ++r) {
+            for (int c = 0; c < 2; ++c) {
+                // 3x3 neighbourhood of centre cell (r + 1, c + 1), shifted into place
+                unsigned around = 0x0757u << (4 * r + c);
+                unsigned centre = 1u << (4 * (r + 1) + c + 1);
+                int neighbors = std::popcount(index & around & ~centre);
+                bool alive = (index & centre) != 0;
+                unsigned mask = alive ? survivalMask : birthMask;
+                if ((mask >> neighbors) & 1u) {
+                    entry |= static_cast<std::uint8_t>(1u << (2 * r + c));
+                }
+            }
+        }
+        table[index] = entry;
+    }
+    return table;
+}
+
+/// Table for a rule: Conway's is a compile-time constant, others are built once and cached.
+const BlockTable& blockTable(const Rule& rule);
+
+/**
+ * @brief Lookup-table alternative to stepRows()
+ *
+ * Works on pairs of rows: each 2x2 output block is read from the table
+ * using the 4x4 input block around it as the index. Same contract as
+ * stepRows(); disjoint row ranges may run concurrently.
+ *
+ * @return true if any cell in those rows differs between current and next
+ */
+bool stepRowsLookup(const Grid& current, Grid& next, int rowBegin, int rowEnd, bool toroidal,
+                    const BlockTable& table, StepCounts* counts = nullptr);
+
+/**
+ * @brief Generations transition for rows [rowBegin, rowEnd)
+ *
+ * @p alive holds the current state-1 cells and @p nextAlive what stepRows()
+ * made of them under the rule's B/S masks. Cells that are dying in
+ * @p current cannot be born, so they are cleared from @p nextAlive; every
+ * lane of @p next is then written in one pass over the packed words.
+ * A cell's liveness is taken from @p alive, so edits made to it since the
+ * states were last written win. Disjoint row ranges may run concurrently.
+ * @p counts, if given, receives the births and deaths of the live plane.
+ *
+ * @return true if any state in those rows changed
+ */
+bool stepStateRows(const Grid& alive, Grid& nextAlive, const MultiStateGrid& current,
+                   MultiStateGrid& next, int rowBegin, int rowEnd, StepCounts* counts = nullptr);
+
+} // namespace LifeKernels
@@ -0,0 +1,123 @@
+#pragma once
+#include "Grid.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class MultiStateGrid
+ * @brief Bounded grid of cells with more than two states, packed 2, 4 or 8 bits per cell
+ *
+ * The narrowest lane that holds every state is used: 2 bits up to 4 states,
+ * 4 bits up to 16 and 8 bits up to 256. Lane i of word j in a row is column
+ * j * getCellsPerWord() + i. Rows are padded to a multiple of 64 cells, so
+ * word w of a Grid row covers exactly words w * getBitsPerCell() onwards of
+ * the matching row here, and a kernel can pair the two word for word.
+ * Padding lanes are always zero.
+ *
+ * State 0 is dead and state 1 is alive; what the higher states mean is up
+ * to the rule (see Rule::getStateCount()).
+ */
+class MultiStateGrid {
+public:
+    using Word = Grid::Word;
+
+    /// SWAR helpers for one word of B-bit lanes, shared with LifeKernels
+    template <int B>
+    struct Lanes {
+        static constexpr int kCells = Grid::kWordBits / B;
+        static constexpr Word kOnes = ~Word{0} / ((Word{1} << B) - 1);  // Low bit of every lane
+        static constexpr Word kLow = kOnes * ((Word{1} << (B - 1)) - 1);  // All lane bits but the top
+        static constexpr Word kHigh = kOnes << (B - 1);
+
+        // Low bit set in every non-zero lane; the add never carries out of a lane
+        static Word nonZero(Word x) { return ((((x & kLow) + kLow) | x) & kHigh) >> (B - 1); }
+        static Word equal(Word x, Word value) { return kOnes & ~nonZero(x ^ (value * kOnes)); }
+
+        // Low lane bits to one bit per cell (kCells bits)
+        static Word gather(Word x) {
+            if constexpr (B == 2) {
+                x = (x | (x >> 1)) & 0x3333333333333333ULL;
+                x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+                x = (x | (x >> 4)) & 0x00FF00FF00FF00FFULL;
+                x = (x | (x >> 8)) & 0x0000FFFF0000FFFFULL;
+                x = (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+            } else if constexpr (B == 4) {
+                x = (x | (x >> 3)) & 0x0303030303030303ULL;
+                x = (x | (x >> 6)) & 0x000F000F000F000FULL;
+                x = (x | (x >> 12)) & 0x000000FF000000FFULL;
+                x = (x | (x >> 24)) & 0x000000000000FFFFULL;
+            } else {
+                x = (x | (x >> 7)) & 0x0003000300030003ULL;
+                x = (x | (x >> 14)) & 0x0000000F0000000FULL;
+                x = (x | (x >> 28)) & 0x00000000000000FFULL;
+            }
+            return x;
+        }
+
+        // The low kCells bits back out to the low bit of each lane
+        static Word spread(Word x) {
+            if constexpr (B == 2) {
+                x &= 0x00000000FFFFFFFFULL;
+                x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+                x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+                x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+                x = (x | (x << 2)) & 0x3333333333333333ULL;
+                x = (x | (x << 1)) & 0x5555555555555555ULL;
+            } else if constexpr (B == 4) {
+                x &= 0x000000000000FFFFULL;
+                x = (x | (x << 24)) & 0x000000FF000000FFULL;
+                x = (x | (x << 12)) & 0x000F000F000F000FULL;
+                x = (x | (x << 6)) & 0x0303030303030303ULL;
+                x = (x | (x << 3)) & 0x1111111111111111ULL;
+            } else {
+                x &= 0x00000000000000FFULL;
+                x = (x | (x << 28)) & 0x0000000F0000000FULL;
+                x = (x | (x << 14)) & 0x0003000300030003ULL;
+                x = (x | (x << 7)) & 0x0101010101010101ULL;
+            }
+            return x;
+        }
+    };
+
+    /// @throws std::invalid_argument unless rows, cols > 0 and 2 <= states <= 256
+    MultiStateGrid(int rows, int cols, int states);
+    /// Live cells of the grid in state 1, everything else in state 0
+    MultiStateGrid(const Grid& grid, int states);
+
+    int getRows() const { return rows_; }
+    int getCols() const { return cols_; }
+    int getStateCount() const { return states_; }
+
+    /// @throws std::out_of_range if the position is outside the grid
+    int getState(int row, int col) const;
+    /// @throws std::out_of_range for a bad position, std::invalid_argument for a bad state
+    void setState(int row, int col, int state);
+    void clear();
+
+    /// Cells in state 1
+    int countLiving() const;
+    /// Cells in any state other than 0
+    int countNonDead() const;
+    /// Cells in state 1 as a two-state grid
+    Grid toGrid() const;
+    bool operator==(const MultiStateGrid& other) const;
+    bool operator!=(const MultiStateGrid& other) const { return !(*this == other); }
+
+    // Word-level access for generation kernels (no bounds checks)
+    int getBitsPerCell() const { return bits_; }
+    int getCellsPerWord() const { return Grid::kWordBits / bits_; }
+    int getWordsPerRow() const { return wordsPerRow_; }
+    const Word* rowWords(int row) const { return words_.data() + static_cast<std::size_t>(row) * wordsPerRow_; }
+    Word* rowWords(int row) { return words_.data() + static_cast<std::size_t>(row) * wordsPerRow_; }
+
+private:
+    int rows_;
+    int cols_;
+    int states_;
+    int bits_;
+    int wordsPerRow_;
+    std::vector<Word> words_;
+
+    void checkPosition(int row, int col) const;
+};
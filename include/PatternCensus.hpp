@@ -0,0 +1,88 @@
+#pragma once
+#include "Grid.hpp"
+#include "PatternLibrary.hpp"
+#include "ThreadPool.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct Census
+ * @brief Objects found on a grid, counted by PatternLibrary key
+ */
+struct Census {
+    // Most common first; islands matching no library pattern count as "unknown"
+    std::vector<std::pair<std::string, std::int64_t>> counts;
+    std::int64_t islands = 0;
+
+    /// Islands of one library pattern (0 if none were found)
+    std::int64_t count(const std::string& key) const;
+
+    /// e.g. "412 blocks, 96 blinkers, 3 gliders"
+    std::string summary() const;
+};
+
+/**
+ * @class PatternCensus
+ * @brief Splits a grid into objects and names them from a PatternLibrary
+ *
+ * An object is an island of live cells each within two cells of another
+ * (a 5x5 neighbourhood, as soup censuses use), so spaceships with detached
+ * sparks such as the LWSS stay whole; objects closer than that count as
+ * one. The labeller works on the horizontal runs of live cells read out of
+ * the packed words: row bands extract their runs and join nearby runs of
+ * the same and the two rows above in a shared union-find in parallel, then
+ * the rows at the band seams are joined serially.
+ *
+ * Each island is reduced to a canonical key, the least of its hashes under
+ * the 8 rotations and reflections, and looked up among the keys of every
+ * library pattern that is a single island, including the other phases of
+ * its oscillators and spaceships.
+ *
+ * Patterns made of several islands (glider gun) are counted piece by
+ * piece as unknown, and islands are not joined across the edges of a
+ * toroidal grid.
+ */
+class PatternCensus {
+public:
+    /**
+     * @param library Patterns to recognise
+     * @param threads Threads used by take(); 0 uses every hardware thread
+     */
+    explicit PatternCensus(const PatternLibrary& library = PatternLibrary(), int threads = 1);
+    ~PatternCensus();
+
+    Census take(const Grid& grid) const;
+
+    int getThreadCount() const { return pool_ ? pool_->getThreadCount() : 1; }
+
+    /// Longest period over which library patterns are evolved to find their phases
+    static constexpr int kMaxPhases = 30;
+
+private:
+    // Island size and orientation-free hash of its cells
+    struct ShapeKey {
+        int rows = 0;
+        int cols = 0;
+        std::int64_t population = 0;
+        std::uint64_t hash = 0;
+
+        bool operator==(const ShapeKey& other) const = default;
+    };
+    struct ShapeKeyHash {
+        std::size_t operator()(const ShapeKey& key) const { return static_cast<std::size_t>(key.hash); }
+    };
+
+    std::unique_ptr<ThreadPool> pool_;
+    std::vector<std::string> names_;
+    std::unordered_map<ShapeKey, int, ShapeKeyHash> known_;
+
+    std::vector<ShapeKey> islandKeys(const Grid& grid) const;
+    void learn(const PatternLibrary& library, const std::string& name);
+    template <typename Task>
+    void forEach(int count, const Task& task) const;
+};
@@ -1,12 +1,26 @@
 #pragma once
+#include "GameEngine.hpp"
 #include "Grid.hpp"
+#include "GridHash.hpp"
+#include <memory>
 #include <string>
 #include <vector>
-#include <map>
 
 /**
  * @class PatternDetector
  * @brief Detects stable patterns, oscillators, and other interesting behaviors
+ *
+ * Generations are remembered by their GridHash in a fixed-size
+ * open-addressing table, so memory use does not depend on the grid size.
+ *
+ * Spaceships are found through a second, translation-invariant hash: the
+ * live cells' sum of A^row * B^col (mod 2^64, two base pairs), scaled by
+ * the inverse powers of the bounding box's top-left corner. Row and column
+ * occupancy counts track the bounding box. With the engine's change list
+ * complete (Incremental backend or change tracking), both are updated per
+ * flipped cell rather than per grid cell. A spaceship straddling the seam
+ * of a toroidal grid is not recognised until it is back in one piece, so
+ * a match may then span several periods.
  */
 class PatternDetector {
 public:
@@ -22,17 +36,39 @@ public:
     
     PatternDetector();
     
-    // Update with new grid state
-    void update(const Grid& grid, int generation);
+    // Update with new grid state; on a toroidal grid, spaceship
+    // displacements are taken the short way around
+    void update(const Grid& grid, int generation, bool toroidal = false);
+    
+    // Update after engine.step(), taking the population and state hash the
+    // engine keeps; a step that flipped nothing is a still life right away
+    void update(const GameEngine& engine);
+    
+    // Longest period reported as an oscillator
+    static constexpr int kMaxPeriod = 30;
+    
+    /**
+     * @brief Confirms hash matches by comparing the grids cell for cell
+     *
+     * Keeps copies of the last kMaxPeriod + 1 grids, so memory then grows
+     * with the grid size. Off by default: a 128-bit hash collision is far
+     * less likely than a hardware fault.
+     */
+    void setVerifyMatches(bool verify);
+    bool isVerifyingMatches() const { return verifyMatches_; }
     
     // Get current pattern type
     PatternType getPatternType() const { return currentPattern_; }
     std::string getPatternName() const;
     std::string getPatternDescription() const;
     
-    // Get oscillator period (if detected)
+    // Get oscillator or spaceship period (if detected)
     int getOscillatorPeriod() const { return oscillatorPeriod_; }
     
+    // Cells a detected spaceship moves per period (+x right, +y down)
+    int getSpaceshipDx() const { return spaceshipDx_; }
+    int getSpaceshipDy() const { return spaceshipDy_; }
+    
     // Get statistics
     bool isStable() const;
     int getStableGenerations() const { return stableGenerations_; }
@@ -43,13 +79,55 @@ private:
     PatternType currentPattern_;
     int oscillatorPeriod_;
     int stableGenerations_;
+    int spaceshipDx_;
+    int spaceshipDy_;
+    
+    // Open-addressing tables (linear probing) of state hash -> generation
+    // last seen, and of shape hash -> generation and position; both are
+    // cleared once either is half full
+    struct SeenState {
+        GridHash hash;
+        int generation = -1;  // -1 marks an empty slot
+        int top = 0;          // Bounding box corner, shapes only
+        int left = 0;
+    };
+    static constexpr std::size_t kTableSlots = 2048;
+    std::vector<SeenState> seenStates_;
+    std::vector<SeenState> seenShapes_;
+    std::size_t seenCount_;
+    std::size_t shapeCount_;
+    
+    // Shape of the generation shapeGeneration_: unnormalised hash sum,
+    // live cells per row and column, and the bounding box (top > bottom
+    // when empty). rowPowers_[r] holds both row bases to the power r
+    int shapeGeneration_;
+    GridHash shapeSum_;
+    std::vector<int> rowCounts_;
+    std::vector<int> colCounts_;
+    std::vector<GridHash> rowPowers_;
+    std::vector<GridHash> colPowers_;
+    int top_;
+    int bottom_;
+    int left_;
+    int right_;
+    bool toroidal_;
     
-    std::vector<std::string> gridHistory_;
-    std::map<std::string, int> gridStates_;
+    // Match verification only: ring of recent grids indexed by generation
+    bool verifyMatches_;
+    std::vector<std::unique_ptr<Grid>> recentGrids_;
+    std::vector<int> recentGenerations_;
     
     int lastPopulation_;
     int samePopulationCount_;
     
-    std::string gridToString(const Grid& grid) const;
-    void detectPattern();
+    void update(const Grid& grid, int generation, int population, const GridHash& hash);
+    static SeenState& findSlot(std::vector<SeenState>& table, const GridHash& hash);
+    void trackShape(const GameEngine& engine);
+    void rebuildShape(const Grid& grid, int generation);
+    void flipShapeCell(int row, int col, bool alive);
+    void tightenBounds();
+    GridHash shapeKey() const;
+    bool sameAsRecent(const Grid& grid, int generation) const;
+    void remember(const Grid& grid, int generation);
+    void clearSeenStates();
 };
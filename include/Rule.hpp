@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class Rule
+ * @brief Life-like cellular automaton rule in B/S notation
+ *
+ * A rule is two 9-bit masks over the neighbour count 0..8: bit n of the
+ * birth mask makes a dead cell with n live neighbours come alive, bit n of
+ * the survival mask keeps a live cell with n neighbours alive. Conway's
+ * Game of Life is B3/S23, the default.
+ *
+ * Rules of the "Generations" family (B2/S/C3, Brian's Brain) add a state
+ * count C > 2: a live cell that fails to survive passes through states
+ * 2..C-1 before it is dead again, and only state 1 counts as a neighbour.
+ */
+class Rule {
+public:
+    Rule();  // B3/S23
+    Rule(std::uint16_t birthMask, std::uint16_t survivalMask, int states = 2);
+
+    /**
+     * @brief Parses "B36/S23", "b3/s23", "S23/B3", the legacy "23/3" (survival/birth)
+     *        or a well-known name such as "highlife" or "daynight"
+     *
+     * A third part sets the state count: "B2/S/C3", or "/2/3" in the legacy
+     * survival/birth/states order.
+     * @throws std::invalid_argument if the text is not a valid rule
+     */
+    static Rule parse(const std::string& text);
+
+    std::uint16_t getBirthMask() const { return birth_; }
+    std::uint16_t getSurvivalMask() const { return survival_; }
+    bool isBorn(int neighbors) const { return (birth_ >> neighbors) & 1u; }
+    bool survives(int neighbors) const { return (survival_ >> neighbors) & 1u; }
+    bool nextState(bool alive, int neighbors) const {
+        return alive ? survives(neighbors) : isBorn(neighbors);
+    }
+    bool isConway() const { return *this == Rule(); }
+    /// Cell states including dead and alive; 2 for Life-like rules
+    int getStateCount() const { return states_; }
+    bool isMultiState() const { return states_ > 2; }
+
+    /// Canonical "B.../S..." form, with "/C..." appended for multi-state rules
+    std::string toString() const;
+    /// Names accepted by parse()
+    static std::vector<std::string> namedRules();
+
+    bool operator==(const Rule& other) const {
+        return birth_ == other.birth_ && survival_ == other.survival_ && states_ == other.states_;
+    }
+    bool operator!=(const Rule& other) const { return !(*this == other); }
+
+private:
+    std::uint16_t birth_;
+    std::uint16_t survival_;
+    int states_;
+};
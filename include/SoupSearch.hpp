@@ -0,0 +1,81 @@
+#pragma once
+#include "GameEngine.hpp"
+#include "PatternCensus.hpp"
+#include "Rule.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Parameters of a sweep over seeded random soups
+ */
+struct SoupSearchOptions {
+    int soups = 1000;                  // Soups to run, seeds firstSeed, firstSeed + 1, ...
+    std::uint64_t firstSeed = 1;
+    int soupSize = 16;                 // Side of the random square
+    int boardSize = 256;               // Side of the board the soup is centred on
+    double density = 0.5;              // Chance of each soup cell being alive
+    int maxGenerations = 100000;       // Cap per soup; 0 means no cap
+    bool toroidal = false;
+    Rule rule;
+    GameEngine::Backend backend = GameEngine::Backend::Incremental;
+    bool census = true;                // Take a census of every final board
+    int threads = 0;                   // 0 uses every hardware thread
+};
+
+/**
+ * @brief How one soup ended
+ */
+struct SoupResult {
+    std::uint64_t seed = 0;
+    int lifespan = 0;       // First generation of the final cycle or of extinction, else the cap
+    int period = 0;         // 1 for still lifes, 0 if the soup never settled
+    bool stabilized = false;
+    int population = 0;     // Live cells when the run stopped
+    Census census;
+};
+
+/**
+ * @brief Outcome and throughput of a sweep, soups in seed order
+ */
+struct SoupSearchResult {
+    std::vector<SoupResult> soups;
+    std::uint64_t generations = 0;  // Summed over all soups
+    double seconds = 0.0;
+    int threads = 1;
+
+    double soupsPerSecond() const { return seconds > 0.0 ? soups.size() / seconds : 0.0; }
+};
+
+/**
+ * @class SoupSearch
+ * @brief Runs many independent random soups to find long-lived ones
+ *
+ * Each soup runs on its own single-threaded GameEngine, one soup per pool
+ * task, so every core works on a different soup. A soup stops as soon as
+ * PatternDetector sees its state hash repeat within PatternDetector::
+ * kMaxPeriod generations (a still life or oscillator), when it dies out,
+ * or at the generation cap. Escaping gliders settle into debris on a
+ * bounded board, but circle a toroidal one until the cap.
+ */
+class SoupSearch {
+public:
+    /// @throws std::invalid_argument for non-positive sizes or a soup larger than the board
+    explicit SoupSearch(const SoupSearchOptions& options);
+
+    SoupSearchResult run() const;
+
+    /// Runs a single soup; safe to call concurrently
+    SoupResult runSoup(std::uint64_t seed) const;
+
+    /// The soup for a seed, centred on an empty board
+    Grid makeSoup(std::uint64_t seed) const;
+
+    static std::string formatText(const SoupSearchResult& result);
+    static std::string formatJson(const SoupSearchResult& result);
+    static std::string formatCsv(const SoupSearchResult& result);
+
+private:
+    SoupSearchOptions options_;
+    PatternCensus census_;  // Single-threaded, so take() may run on every worker at once
+};
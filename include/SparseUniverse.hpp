@@ -0,0 +1,76 @@
+#pragma once
+#include "Grid.hpp"
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class SparseUniverse
+ * @brief Unbounded Life universe stored as a hash map of 64x64 bit-packed chunks
+ *
+ * A chunk exists only while it holds a live cell: it is allocated when a
+ * cell is born into it and dropped as soon as it empties, so memory follows
+ * the live area rather than its bounding box. Each generation visits the
+ * populated chunks plus those neighbours a live edge cell can reach.
+ *
+ * Cell coordinates are signed 64-bit values within +/- 2^37, which leaves a
+ * spaceship billions of cells of room in every direction.
+ */
+class SparseUniverse {
+public:
+    static constexpr int kChunkShift = 6;
+    static constexpr int kChunkSize = 1 << kChunkShift;  // Cells per chunk side
+    static constexpr std::int64_t kCoordinateLimit = std::int64_t{1} << 37;
+
+    SparseUniverse();
+    explicit SparseUniverse(const Grid& grid, std::int64_t top = 0, std::int64_t left = 0);
+
+    // Cell access
+    bool getCell(std::int64_t row, std::int64_t col) const;
+    void setCell(std::int64_t row, std::int64_t col, bool alive);
+    void clear();
+
+    // Grid conversion: pastes live cells at (top, left) / cuts a window out
+    void placeGrid(const Grid& grid, std::int64_t top = 0, std::int64_t left = 0);
+    Grid toGrid(int rows, int cols, std::int64_t top, std::int64_t left) const;
+
+    // Simulation
+    void step();
+    std::uint64_t getGeneration() const { return generation_; }
+    std::uint64_t getPopulation() const;
+
+    // Introspection
+    std::size_t getChunkCount() const { return chunks_.size(); }
+    /// Bounding box of live cells (inclusive); false if the universe is empty.
+    bool getBounds(std::int64_t& top, std::int64_t& left,
+                   std::int64_t& bottom, std::int64_t& right) const;
+
+private:
+    using Word = Grid::Word;
+    // Row r of the chunk is one word; bit c is column c, as in Grid
+    using Chunk = std::array<Word, kChunkSize>;
+
+    struct KeyHash {
+        std::size_t operator()(std::uint64_t key) const {
+            key ^= key >> 31;
+            key *= 0x9E3779B97F4A7C15ULL;
+            return static_cast<std::size_t>(key ^ (key >> 29));
+        }
+    };
+    using ChunkMap = std::unordered_map<std::uint64_t, Chunk, KeyHash>;
+
+    ChunkMap chunks_;
+    ChunkMap next_;                        // Reused every step
+    std::vector<std::uint64_t> candidates_;
+    std::uint64_t generation_;
+
+    static std::uint64_t chunkKey(std::int64_t chunkRow, std::int64_t chunkCol);
+    static std::int64_t keyRow(std::uint64_t key);
+    static std::int64_t keyCol(std::uint64_t key);
+    static void checkCoordinates(std::int64_t row, std::int64_t col);
+
+    const Chunk* findChunk(std::int64_t chunkRow, std::int64_t chunkCol) const;
+    void collectCandidates();
+    bool stepChunk(std::int64_t chunkRow, std::int64_t chunkCol, Chunk& out) const;
+};
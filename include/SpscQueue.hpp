@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @class SpscQueue
+ * @brief Bounded lock-free queue between exactly one producer and one consumer thread
+ *
+ * A ring of slots indexed by two running counters, each written by one
+ * side only, so pushes and pops are a load, a store and no locks. The
+ * blocking push() and pop() sleep on the other side's counter with C++20
+ * atomic waits, and only when the ring is full or empty.
+ */
+template <typename T>
+class SpscQueue {
+public:
+    /// Capacity is rounded up to a power of two
+    explicit SpscQueue(std::size_t capacity) : slots_(roundUp(capacity)), mask_(slots_.size() - 1) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    std::size_t capacity() const { return slots_.size(); }
+
+    /// Producer: moves value in unless the ring is full
+    bool tryPush(T& value) {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+            return false;
+        }
+        publish(tail, value);
+        return true;
+    }
+
+    /// Producer: waits for a free slot
+    void push(T value) {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            std::size_t head = head_.load(std::memory_order_acquire);
+            if (tail - head < slots_.size()) {
+                break;
+            }
+            head_.wait(head, std::memory_order_acquire);
+        }
+        publish(tail, value);
+    }
+
+    /// Consumer: moves the oldest value out unless the ring is empty
+    bool tryPop(T& value) {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (tail_.load(std::memory_order_acquire) == head) {
+            return false;
+        }
+        consume(head, value);
+        return true;
+    }
+
+    /// Consumer: waits for a value
+    T pop() {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            std::size_t tail = tail_.load(std::memory_order_acquire);
+            if (tail != head) {
+                break;
+            }
+            tail_.wait(tail, std::memory_order_acquire);
+        }
+        T value;
+        consume(head, value);
+        return value;
+    }
+
+private:
+    std::vector<T> slots_;
+    std::size_t mask_;
+    // Next slot to pop (written by the consumer) and to push (by the
+    // producer), on separate cache lines so the two sides do not share one
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+
+    static std::size_t roundUp(std::size_t capacity) {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size *= 2;
+        }
+        return size;
+    }
+
+    void publish(std::size_t tail, T& value) {
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        tail_.notify_one();
+    }
+
+    void consume(std::size_t head, T& value) {
+        value = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        head_.notify_one();
+    }
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Persistent worker threads for data-parallel loops
+ *
+ * Workers are created once and sleep between calls, so a parallel step
+ * costs one wake-up instead of a thread creation per generation. The
+ * calling thread takes part in every loop.
+ *
+ * Scheduling is work-stealing: each thread starts with a contiguous slice
+ * of the index range and pops from its front; a thread that runs dry
+ * steals the back half of another thread's remaining slice.
+ */
+class ThreadPool {
+public:
+    /// Creates a pool running loops on threadCount threads (caller included).
+    explicit ThreadPool(int threadCount);
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    int getThreadCount() const { return static_cast<int>(workers_.size()) + 1; }
+    
+    /**
+     * @brief Runs task(i) for every i in [0, count) and waits for completion
+     *
+     * Neighbouring indices tend to run on the same thread, and uneven
+     * tasks balance through stealing. Tasks must not throw. Does not allocate.
+     */
+    template <typename Task>
+    void parallelFor(int count, Task&& task) {
+        using TaskType = std::remove_reference_t<Task>;
+        run(count, [](void* context, int index) { (*static_cast<TaskType*>(context))(index); },
+            const_cast<void*>(static_cast<const void*>(&task)));
+    }
+    
+    /// Number of threads to use for a requested count; 0 means all hardware threads.
+    static int resolveThreadCount(int requested);
+
+private:
+    using TaskFn = void (*)(void* context, int index);
+    
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    
+    // Remaining [begin, end) of one thread's slice, packed as begin << 32 | end
+    struct alignas(64) Slice {
+        std::atomic<std::uint64_t> range{0};
+    };
+    std::vector<Slice> slices_;
+    
+    TaskFn taskFn_;
+    void* taskContext_;
+    int pendingWorkers_;
+    std::uint64_t epoch_;
+    bool stopping_;
+    
+    void run(int count, TaskFn fn, void* context);
+    void drain(int self);
+    bool popFront(int self, int& index);
+    bool steal(int self);
+    void workerLoop(int self);
+};
@@ -4,22 +4,35 @@
 #include "Config.hpp"
 #include "EnhancedGUIRenderer.hpp"
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <stdexcept>
 
 int main(int argc, char* argv[]) {
     try {
         // Parse configuration
         Config config;
         config.parse(argc, argv);
+        if (config.useHashLife()) {
+            std::cout << "HashLife runs only in GameOfLife_Console; showing the bit-parallel engine\n";
+        }
         
         // Load or create grid
-        std::unique_ptr<Grid> grid;
+        LoadedPattern pattern;
+        std::unique_ptr<Grid>& grid = pattern.grid;
         
         if (!config.getFilePath().empty()) {
-            // Load from file
+            // Load from file, with its rule and any decaying cells
             TextFileIO fileIO;
-            grid = fileIO.loadGrid(config.getFilePath());
-            std::cout << "Loaded grid from: " << config.getFilePath() << "\n";
+            pattern = fileIO.loadPattern(config.getFilePath(), config.getThreads());
+            if (pattern.generation > static_cast<std::uint64_t>(std::numeric_limits<int>::max())) {
+                throw std::runtime_error("Snapshot generation is too large to resume");
+            }
+            std::cout << "Loaded grid from: " << config.getFilePath();
+            if (pattern.generation > 0) {
+                std::cout << " at generation " << pattern.generation;
+            }
+            std::cout << "\n";
         } else {
             // Create default grid
             grid = std::make_unique<Grid>(80, 80);
@@ -40,7 +53,21 @@ int main(int argc, char* argv[]) {
         std::cout << "Starting GUI...\n\n";
         
         // Create game engine
-        GameEngine engine(*grid, config.isToroidal());
+        // Checkpoints resume where they stopped, on the board they ran on
+        GameEngine engine(std::move(*grid), config.isToroidal() || pattern.toroidal);
+        engine.setGeneration(static_cast<int>(pattern.generation));
+        engine.setBackend(config.getBackend());
+        engine.setThreadCount(config.getThreads());
+        engine.setRule(config.getRule());
+        if (!config.hasRule() && !pattern.rule.empty()) {
+            // RLE files and snapshots name the rule they were made with
+            engine.setRule(Rule::parse(pattern.rule));
+            std::cout << "Using rule " << engine.getRule().toString() << " from the file\n";
+        }
+        if (engine.getCellStates() && pattern.states) {
+            // Multi-state files carry decaying cells as well as live ones
+            engine.setCellStates(*pattern.states);
+        }
         
         // Create and run enhanced GUI renderer
         EnhancedGUIRenderer renderer(engine, config);
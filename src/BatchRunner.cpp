@@ -0,0 +1,178 @@
+#include "BatchRunner.hpp"
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(_WIN32)
+// Version 2 maps GetProcessMemoryInfo onto kernel32, so no -lpsapi is needed
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+BatchRunner::BatchRunner(int generations, bool untilStable, bool census)
+    : generations_(generations), untilStable_(untilStable), census_(census) {
+    if (generations < 0) {
+        throw std::invalid_argument("Generation count cannot be negative");
+    }
+}
+
+BatchResult BatchRunner::run(GameEngine& engine, const StepObserver& afterStep) const {
+    BatchResult result;
+    const Grid& grid = engine.getCurrentGrid();
+    std::uint64_t cellsPerGeneration = static_cast<std::uint64_t>(grid.getRows()) * grid.getCols();
+    bool unlimited = generations_ == 0 && untilStable_;
+
+    auto start = std::chrono::steady_clock::now();
+    while (unlimited || result.generations < static_cast<std::uint64_t>(generations_)) {
+        engine.step();
+        ++result.generations;
+        if (afterStep) {
+            afterStep(engine);
+        }
+        if (untilStable_ && engine.isStable()) {
+            result.stabilized = true;
+            break;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    result.cellUpdates = result.generations * cellsPerGeneration;
+    result.population = engine.getPopulation();
+    if (census_) {
+        auto censusStart = std::chrono::steady_clock::now();
+        PatternCensus census(PatternLibrary(), engine.getThreadCount());
+        result.census = census.take(engine.getCurrentGrid());
+        result.censusTaken = true;
+        result.censusSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - censusStart).count();
+    }
+    result.peakRssBytes = peakResidentBytes();
+    return result;
+}
+
+BatchResult BatchRunner::run(HashLifeEngine& engine) const {
+    if (generations_ == 0 || untilStable_ || census_) {
+        throw std::invalid_argument("HashLife runs need a generation limit and no stability check or census");
+    }
+    BatchResult result;
+    auto start = std::chrono::steady_clock::now();
+    engine.stepBy(static_cast<std::uint64_t>(generations_));
+    auto end = std::chrono::steady_clock::now();
+
+    result.generations = static_cast<std::uint64_t>(generations_);
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    result.population = engine.getPopulation();
+    result.peakRssBytes = peakResidentBytes();
+    return result;
+}
+
+std::size_t BatchRunner::peakResidentBytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<std::size_t>(usage.ru_maxrss);          // Bytes on macOS
+#else
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;   // Kilobytes on Linux
+#endif
+#endif
+}
+
+std::string BatchRunner::formatText(const BatchResult& result, const GameEngine& engine) {
+    const Grid& grid = engine.getCurrentGrid();
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    oss << "Grid:        " << grid.getRows() << "x" << grid.getCols()
+        << (engine.isToroidal() ? " (toroidal)" : "") << "\n";
+    oss << "Engine:      " << GameEngine::backendName(engine.getBackend())
+        << ", " << engine.getThreadCount() << " thread(s), rule " << engine.getRule().toString() << "\n";
+    oss << "Generations: " << result.generations << (result.stabilized ? " (stabilized)" : "") << "\n";
+    oss << "Population:  " << result.population << "\n";
+    if (result.censusTaken) {
+        oss << "Census:      " << result.census.summary() << "\n";
+    }
+    oss << "Elapsed:     " << result.seconds << " s\n";
+    oss << std::setprecision(1);
+    oss << "Throughput:  " << result.generationsPerSecond() << " gen/s, "
+        << std::scientific << std::setprecision(3) << result.cellsPerSecond() << " cells/s\n";
+    oss << std::fixed << std::setprecision(1);
+    oss << "Peak RSS:    " << result.peakRssBytes / (1024.0 * 1024.0) << " MiB\n";
+    return oss.str();
+}
+
+std::string BatchRunner::formatText(const BatchResult& result, const HashLifeEngine& engine) {
+    HashLifeEngine::Bounds bounds = engine.getBounds();
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    oss << "Universe:    unbounded, live cells in " << bounds.rows << "x" << bounds.cols << " at ("
+        << bounds.top << ", " << bounds.left << ")\n";
+    oss << "Engine:      hashlife, " << engine.getNodeCount() << " nodes, rule B3/S23\n";
+    oss << "Generations: " << result.generations << " (now at " << engine.getGeneration() << ")\n";
+    oss << "Population:  " << result.population << "\n";
+    oss << "Elapsed:     " << result.seconds << " s\n";
+    oss << std::setprecision(1);
+    oss << "Throughput:  " << result.generationsPerSecond() << " gen/s\n";
+    oss << "Peak RSS:    " << result.peakRssBytes / (1024.0 * 1024.0) << " MiB\n";
+    return oss.str();
+}
+
+std::string BatchRunner::formatJson(const BatchResult& result, const HashLifeEngine& engine) {
+    HashLifeEngine::Bounds bounds = engine.getBounds();
+    std::ostringstream oss;
+    oss << std::setprecision(6);
+    oss << "{"
+        << "\"engine\": \"hashlife\", "
+        << "\"rule\": \"B3/S23\", "
+        << "\"bounds\": {\"top\": " << bounds.top << ", \"left\": " << bounds.left << ", \"rows\": " << bounds.rows
+        << ", \"cols\": " << bounds.cols << "}, "
+        << "\"nodes\": " << engine.getNodeCount() << ", "
+        << "\"generations\": " << result.generations << ", "
+        << "\"generation\": " << engine.getGeneration() << ", "
+        << "\"population\": " << result.population << ", "
+        << "\"seconds\": " << result.seconds << ", "
+        << "\"generations_per_second\": " << result.generationsPerSecond() << ", "
+        << "\"peak_rss_bytes\": " << result.peakRssBytes << "}\n";
+    return oss.str();
+}
+
+std::string BatchRunner::formatJson(const BatchResult& result, const GameEngine& engine) {
+    const Grid& grid = engine.getCurrentGrid();
+    std::ostringstream oss;
+    oss << std::setprecision(6);
+    oss << "{"
+        << "\"rows\": " << grid.getRows() << ", "
+        << "\"cols\": " << grid.getCols() << ", "
+        << "\"toroidal\": " << (engine.isToroidal() ? "true" : "false") << ", "
+        << "\"engine\": \"" << GameEngine::backendName(engine.getBackend()) << "\", "
+        << "\"threads\": " << engine.getThreadCount() << ", "
+        << "\"rule\": \"" << engine.getRule().toString() << "\", "
+        << "\"generations\": " << result.generations << ", "
+        << "\"stabilized\": " << (result.stabilized ? "true" : "false") << ", "
+        << "\"population\": " << result.population << ", "
+        << "\"seconds\": " << result.seconds << ", "
+        << "\"generations_per_second\": " << result.generationsPerSecond() << ", "
+        << "\"cells_per_second\": " << result.cellsPerSecond() << ", "
+        << "\"peak_rss_bytes\": " << result.peakRssBytes;
+    if (result.censusTaken) {
+        oss << ", \"census\": {\"islands\": " << result.census.islands << ", \"seconds\": " << result.censusSeconds
+            << ", \"objects\": {";
+        for (std::size_t i = 0; i < result.census.counts.size(); ++i) {
+            oss << (i ? ", " : "") << "\"" << result.census.counts[i].first << "\": " << result.census.counts[i].second;
+        }
+        oss << "}}";
+    }
+    oss << "}\n";
+    return oss.str();
+}
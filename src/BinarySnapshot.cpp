@@ -0,0 +1,241 @@
+#include "BinarySnapshot.hpp"
+#include "FileFormat.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Word = Grid::Word;
+
+constexpr char kMagic[4] = {'G', 'O', 'L', 'B'};
+constexpr std::uint32_t kToroidalFlag = 1;
+constexpr std::size_t kPayloadAlignment = 64;
+
+// Fixed part of the header; the rule text follows it
+struct Header {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t headerBytes;   // Offset of the payload, a multiple of kPayloadAlignment
+    std::uint32_t flags;
+    std::int32_t rows;
+    std::int32_t cols;
+    std::uint32_t wordsPerRow;
+    std::uint32_t ruleBytes;
+    std::uint64_t generation;
+    std::uint64_t payloadWords;  // (rows + 1) * wordsPerRow
+};
+static_assert(sizeof(Header) == 48, "Snapshot header layout must not depend on the compiler");
+
+void requireLittleEndian() {
+    if constexpr (std::endian::native != std::endian::little) {
+        throw std::runtime_error("Binary snapshots need a little-endian host");
+    }
+}
+
+// Open snapshot file and its size
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename) {
+#if defined(_WIN32)
+        file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        LARGE_INTEGER size;
+        if (file_ == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_, &size)) {
+            if (file_ != INVALID_HANDLE_VALUE) {
+                CloseHandle(file_);
+            }
+            throw std::runtime_error("Cannot open file: " + filename);
+        }
+        size_ = static_cast<std::size_t>(size.QuadPart);
+        if (size_ > 0) {
+            mapping_ = CreateFileMappingA(file_, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+            if (!mapping_) {
+                CloseHandle(file_);
+                throw std::runtime_error("Cannot map file: " + filename);
+            }
+        }
+#else
+        fd_ = ::open(filename.c_str(), O_RDONLY);
+        struct stat info;
+        if (fd_ < 0 || ::fstat(fd_, &info) != 0) {
+            if (fd_ >= 0) {
+                ::close(fd_);
+            }
+            throw std::runtime_error("Cannot open file: " + filename);
+        }
+        size_ = static_cast<std::size_t>(info.st_size);
+#endif
+    }
+    ~MappedFile() {
+#if defined(_WIN32)
+        if (mapping_) {
+            CloseHandle(mapping_);
+        }
+        CloseHandle(file_);
+#else
+        ::close(fd_);
+#endif
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::size_t size() const { return size_; }
+
+    // A private copy-on-write view of the whole file, nullptr on failure
+    void* map() const {
+        if (size_ == 0) {
+            return nullptr;
+        }
+#if defined(_WIN32)
+        return MapViewOfFile(mapping_, FILE_MAP_COPY, 0, 0, size_);
+#else
+        void* view = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd_, 0);
+        return view == MAP_FAILED ? nullptr : view;
+#endif
+    }
+    void unmap(void* view) const {
+#if defined(_WIN32)
+        UnmapViewOfFile(view);
+#else
+        ::munmap(view, size_);
+#endif
+    }
+
+private:
+    std::size_t size_ = 0;
+#if defined(_WIN32)
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+// One view of a snapshot, used as a grid's storage
+class SnapshotStorage : public Grid::ExternalStorage {
+public:
+    SnapshotStorage(std::shared_ptr<const MappedFile> file, std::size_t payloadOffset)
+        : file_(std::move(file)), payloadOffset_(payloadOffset), view_(file_->map()) {
+        if (!view_) {
+            throw std::runtime_error("Cannot map snapshot into memory");
+        }
+    }
+    ~SnapshotStorage() override { file_->unmap(view_); }
+
+    const char* bytes() const { return static_cast<const char*>(view_); }
+    void setPayloadOffset(std::size_t offset) { payloadOffset_ = offset; }
+    Word* words() override { return reinterpret_cast<Word*>(static_cast<char*>(view_) + payloadOffset_); }
+    // Another private view of the same file: none of this view's edits
+    std::unique_ptr<Grid::ExternalStorage> reopen() const override {
+        return std::make_unique<SnapshotStorage>(file_, payloadOffset_);
+    }
+
+private:
+    std::shared_ptr<const MappedFile> file_;
+    std::size_t payloadOffset_;
+    void* view_;
+};
+
+} // namespace
+
+void BinarySnapshot::save(const Grid& grid, const std::string& filename, const Rule& rule,
+                          std::uint64_t generation, bool toroidal) {
+    requireLittleEndian();
+    std::string ruleText = rule.toString();
+    std::size_t headerBytes = (sizeof(Header) + ruleText.size() + kPayloadAlignment - 1) /
+                              kPayloadAlignment * kPayloadAlignment;
+
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.headerBytes = static_cast<std::uint32_t>(headerBytes);
+    header.flags = toroidal ? kToroidalFlag : 0;
+    header.rows = grid.getRows();
+    header.cols = grid.getCols();
+    header.wordsPerRow = static_cast<std::uint32_t>(grid.getWordsPerRow());
+    header.ruleBytes = static_cast<std::uint32_t>(ruleText.size());
+    header.generation = generation;
+    header.payloadWords = (static_cast<std::uint64_t>(grid.getRows()) + 1) * grid.getWordsPerRow();
+
+    std::vector<char> prefix(headerBytes, 0);
+    std::memcpy(prefix.data(), &header, sizeof(header));
+    std::memcpy(prefix.data() + sizeof(header), ruleText.data(), ruleText.size());
+
+    // The grid buffer already ends with its zero row, so the payload is one write
+    FileFormat::replaceFile(filename, [&](std::ofstream& file) {
+        file.write(prefix.data(), static_cast<std::streamsize>(prefix.size()));
+        file.write(reinterpret_cast<const char*>(grid.data()),
+                   static_cast<std::streamsize>(header.payloadWords * sizeof(Word)));
+    });
+}
+
+void BinarySnapshot::save(const GameEngine& engine, const std::string& filename) {
+    save(engine.getCurrentGrid(), filename, engine.getRule(),
+         static_cast<std::uint64_t>(engine.getGeneration()), engine.isToroidal());
+}
+
+Snapshot BinarySnapshot::load(const std::string& filename) {
+    requireLittleEndian();
+    auto file = std::make_unique<const MappedFile>(filename);
+    std::size_t fileBytes = file->size();
+    if (fileBytes < sizeof(Header)) {
+        throw std::runtime_error("Not a binary snapshot: " + filename);
+    }
+    auto storage = std::make_unique<SnapshotStorage>(std::move(file), 0);
+
+    // Only the header page is touched here; the payload is paged in on use
+    Header header;
+    std::memcpy(&header, storage->bytes(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a binary snapshot: " + filename);
+    }
+    if (header.version > kVersion) {
+        throw std::runtime_error("Snapshot version " + std::to_string(header.version) +
+                                 " is newer than this build reads: " + filename);
+    }
+    std::uint64_t wordsPerRow = (static_cast<std::uint64_t>(std::max(header.cols, 0)) + Grid::kWordBits - 1) /
+                                Grid::kWordBits;
+    bool valid = header.rows > 0 && header.cols > 0 && header.wordsPerRow == wordsPerRow &&
+                 header.headerBytes % kPayloadAlignment == 0 &&
+                 header.headerBytes >= sizeof(Header) + header.ruleBytes &&
+                 header.payloadWords == (static_cast<std::uint64_t>(header.rows) + 1) * wordsPerRow &&
+                 header.payloadWords <= (std::numeric_limits<std::uint64_t>::max() - header.headerBytes) / sizeof(Word) &&
+                 fileBytes == header.headerBytes + header.payloadWords * sizeof(Word);
+    if (!valid) {
+        throw std::runtime_error("Truncated or corrupt binary snapshot: " + filename);
+    }
+
+    std::string ruleText(storage->bytes() + sizeof(Header), header.ruleBytes);
+    Rule rule = Rule::parse(ruleText);
+
+    // The view the header was read from becomes the grid's storage
+    storage->setPayloadOffset(header.headerBytes);
+    return Snapshot{Grid(header.rows, header.cols, std::move(storage)), rule, header.generation,
+                    (header.flags & kToroidalFlag) != 0};
+}
+
+bool BinarySnapshot::isSnapshot(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[sizeof(kMagic)];
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+bool BinarySnapshot::isSnapshotFileName(const std::string& filename) {
+    return FileFormat::endsWithIgnoreCase(filename, ".golb");
+}
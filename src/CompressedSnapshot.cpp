@@ -0,0 +1,428 @@
+#include "CompressedSnapshot.hpp"
+#include "FileFormat.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using Word = Grid::Word;
+
+constexpr char kMagic[4] = {'G', 'O', 'L', 'Z'};
+constexpr std::uint32_t kToroidalFlag = 1;
+constexpr int kTileWords = CompressedSnapshot::kTileSize;  // One word per cell row of a tile
+constexpr std::size_t kHeaderBytes = 52;                    // Fixed part; the rule text follows
+constexpr std::size_t kEntryBytes = 24;
+constexpr std::size_t kRawTileBytes = 1 + kTileWords * sizeof(Word);
+
+enum Codec : std::uint8_t {
+    kRaw = 0,     // 64 little-endian words
+    kPacked = 1,  // Non-zero word mask, then a byte mask and the non-zero bytes of each such word
+};
+
+// Index entry of one stored tile; offsets are relative to the start of the tile data
+struct Entry {
+    std::uint32_t tileRow;
+    std::uint32_t tileCol;
+    std::uint64_t offset;
+    std::uint32_t bytes;
+};
+
+struct Header {
+    std::uint32_t version = 0;
+    std::uint32_t flags = 0;
+    int rows = 0;
+    int cols = 0;
+    std::uint64_t generation = 0;
+    std::string rule;
+    std::vector<Entry> index;
+    std::uint64_t dataOffset = 0;
+    std::uint64_t dataBytes = 0;
+    std::uint64_t fileBytes = 0;
+};
+
+// Explicit little-endian byte order, so files move between hosts unchanged
+using FileFormat::get32;
+using FileFormat::get64;
+using FileFormat::put32;
+using FileFormat::put64;
+
+// Word column tileCol of the tile's rows; rows past the board read as zero
+void readTile(const Grid& grid, int tileRow, int tileCol, Word* tile) {
+    int firstRow = tileRow * kTileWords;
+    int count = std::min(kTileWords, grid.getRows() - firstRow);
+    for (int i = 0; i < count; ++i) {
+        tile[i] = grid.rowWords(firstRow + i)[tileCol];
+    }
+    std::fill(tile + count, tile + kTileWords, Word{0});
+}
+
+// Appends the smaller of the two encodings; false, with nothing appended, for an empty tile
+bool encodeTile(const Word* tile, std::vector<char>& out) {
+    Word wordMask = 0;
+    std::size_t packedBytes = 1 + sizeof(Word);
+    for (int i = 0; i < kTileWords; ++i) {
+        if (tile[i]) {
+            wordMask |= Word{1} << i;
+            for (int shift = 0; shift < 64; shift += 8) {
+                packedBytes += ((tile[i] >> shift) & 0xFF) != 0;
+            }
+            ++packedBytes;
+        }
+    }
+    if (!wordMask) {
+        return false;
+    }
+    if (packedBytes >= kRawTileBytes) {
+        out.push_back(static_cast<char>(kRaw));
+        for (int i = 0; i < kTileWords; ++i) {
+            put64(out, tile[i]);
+        }
+        return true;
+    }
+    out.push_back(static_cast<char>(kPacked));
+    put64(out, wordMask);
+    for (Word mask = wordMask; mask; mask &= mask - 1) {
+        Word word = tile[std::countr_zero(mask)];
+        std::uint8_t byteMask = 0;
+        for (int b = 0; b < 8; ++b) {
+            byteMask |= static_cast<std::uint8_t>((((word >> (8 * b)) & 0xFF) != 0) << b);
+        }
+        out.push_back(static_cast<char>(byteMask));
+        for (int b = 0; b < 8; ++b) {
+            if ((byteMask >> b) & 1) {
+                out.push_back(static_cast<char>(word >> (8 * b)));
+            }
+        }
+    }
+    return true;
+}
+
+// False if the bytes are not one well-formed tile
+bool decodeTile(const char* data, std::size_t size, Word* tile) {
+    if (size == 0) {
+        return false;
+    }
+    if (data[0] == static_cast<char>(kRaw)) {
+        if (size != kRawTileBytes) {
+            return false;
+        }
+        for (int i = 0; i < kTileWords; ++i) {
+            tile[i] = get64(data + 1 + i * sizeof(Word));
+        }
+        return true;
+    }
+    if (data[0] != static_cast<char>(kPacked) || size < 1 + sizeof(Word)) {
+        return false;
+    }
+    std::fill(tile, tile + kTileWords, Word{0});
+    Word wordMask = get64(data + 1);
+    std::size_t pos = 1 + sizeof(Word);
+    for (Word mask = wordMask; mask; mask &= mask - 1) {
+        if (pos >= size) {
+            return false;
+        }
+        auto byteMask = static_cast<std::uint8_t>(data[pos++]);
+        if (pos + std::popcount(byteMask) > size) {
+            return false;
+        }
+        Word word = 0;
+        for (int b = 0; b < 8; ++b) {
+            if ((byteMask >> b) & 1) {
+                word |= Word{static_cast<unsigned char>(data[pos++])} << (8 * b);
+            }
+        }
+        tile[std::countr_zero(mask)] = word;
+    }
+    return pos == size;
+}
+
+// Stores a decoded tile, clearing any bits past the board
+void writeTile(Grid& grid, int tileRow, int tileCol, const Word* tile) {
+    int firstRow = tileRow * kTileWords;
+    int count = std::min(kTileWords, grid.getRows() - firstRow);
+    Word mask = tileCol == grid.getWordsPerRow() - 1 ? grid.lastWordMask() : ~Word{0};
+    for (int i = 0; i < count; ++i) {
+        grid.rowWords(firstRow + i)[tileCol] = tile[i] & mask;
+    }
+}
+
+// ORs 64 cells starting at column col (possibly negative) into a grid row
+void placeWord(Grid& grid, int row, int col, Word bits) {
+    if (!bits || col <= -Grid::kWordBits || col >= grid.getCols()) {
+        return;
+    }
+    if (col < 0) {
+        bits >>= -col;
+        col = 0;
+    }
+    Word* words = grid.rowWords(row);
+    int w = col >> 6;
+    int shift = col & 63;
+    words[w] |= bits << shift;
+    if (shift && w + 1 < grid.getWordsPerRow()) {
+        words[w + 1] |= bits >> (Grid::kWordBits - shift);
+    }
+    words[grid.getWordsPerRow() - 1] &= grid.lastWordMask();
+}
+
+Header readHeader(std::ifstream& file, const std::string& filename) {
+    // Sizes in the header are checked against the file before anything is allocated for them
+    file.seekg(0, std::ios::end);
+    std::streamoff fileBytes = file.tellg();
+    file.seekg(0);
+    char fixed[kHeaderBytes];
+    if (!file.read(fixed, sizeof(fixed)) || std::memcmp(fixed, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a compressed snapshot: " + filename);
+    }
+    Header header;
+    header.version = get32(fixed + 4);
+    if (header.version > CompressedSnapshot::kVersion) {
+        throw std::runtime_error("Snapshot version " + std::to_string(header.version) +
+                                 " is newer than this build reads: " + filename);
+    }
+    header.flags = get32(fixed + 8);
+    std::uint32_t rows = get32(fixed + 12);
+    std::uint32_t cols = get32(fixed + 16);
+    std::uint32_t ruleBytes = get32(fixed + 20);
+    std::uint32_t tileSize = get32(fixed + 24);
+    header.generation = get64(fixed + 28);
+    std::uint64_t tileCount = get64(fixed + 36);
+    header.dataBytes = get64(fixed + 44);
+    header.fileBytes = static_cast<std::uint64_t>(fileBytes);
+
+    constexpr std::uint32_t kMaxSide = std::numeric_limits<int>::max();
+    if (rows == 0 || cols == 0 || rows > kMaxSide || cols > kMaxSide || tileSize != kTileWords || ruleBytes > 4096) {
+        throw std::runtime_error("Corrupt compressed snapshot header: " + filename);
+    }
+    header.rows = static_cast<int>(rows);
+    header.cols = static_cast<int>(cols);
+    std::uint64_t tileRows = (std::uint64_t{rows} + kTileWords - 1) / kTileWords;
+    std::uint64_t tileCols = (std::uint64_t{cols} + kTileWords - 1) / kTileWords;
+    if (tileCount > tileRows * tileCols) {
+        throw std::runtime_error("Corrupt compressed snapshot header: " + filename);
+    }
+    // tileCount is at most 2^50 here, so the sum cannot overflow
+    header.dataOffset = kHeaderBytes + ruleBytes + tileCount * kEntryBytes;
+    if (header.dataOffset > header.fileBytes) {
+        throw std::runtime_error("Truncated compressed snapshot: " + filename);
+    }
+
+    header.rule.resize(ruleBytes);
+    std::vector<char> index(tileCount * kEntryBytes);
+    if (!file.read(header.rule.data(), ruleBytes) ||
+        !file.read(index.data(), static_cast<std::streamsize>(index.size()))) {
+        throw std::runtime_error("Truncated compressed snapshot: " + filename);
+    }
+
+    // Sorted, inside the board and inside the data, so tiles can be decoded independently
+    header.index.resize(tileCount);
+    for (std::size_t i = 0; i < tileCount; ++i) {
+        const char* bytes = index.data() + i * kEntryBytes;
+        Entry& entry = header.index[i];
+        entry = {get32(bytes), get32(bytes + 4), get64(bytes + 8), get32(bytes + 16)};
+        bool ordered = i == 0 || std::pair(entry.tileRow, entry.tileCol) >
+                                     std::pair(header.index[i - 1].tileRow, header.index[i - 1].tileCol);
+        if (!ordered || entry.tileRow >= tileRows || entry.tileCol >= tileCols ||
+            entry.offset > header.dataBytes || entry.bytes > header.dataBytes - entry.offset) {
+            throw std::runtime_error("Corrupt compressed snapshot index: " + filename);
+        }
+    }
+    return header;
+}
+
+// The tile data fills the rest of the file exactly
+void requireData(const Header& header, const std::string& filename) {
+    if (header.dataBytes != header.fileBytes - header.dataOffset) {
+        throw std::runtime_error("Truncated or corrupt compressed snapshot: " + filename);
+    }
+}
+
+} // namespace
+
+void CompressedSnapshot::save(const Grid& grid, const std::string& filename, const Rule& rule,
+                              std::uint64_t generation, bool toroidal, int threads) {
+    int tileRows = (grid.getRows() + kTileWords - 1) / kTileWords;
+    int tileCols = grid.getWordsPerRow();
+
+    // Each tile row is encoded into its own buffer, then the buffers are laid out in order
+    std::vector<std::vector<char>> rowData(tileRows);
+    std::vector<std::vector<Entry>> rowEntries(tileRows);
+    std::atomic<bool> failed{false};
+    ThreadPool pool(ThreadPool::resolveThreadCount(threads));
+    pool.parallelFor(tileRows, [&](int tileRow) {
+        try {
+            Word tile[kTileWords];
+            std::vector<char>& data = rowData[tileRow];
+            for (int tileCol = 0; tileCol < tileCols; ++tileCol) {
+                readTile(grid, tileRow, tileCol, tile);
+                std::size_t start = data.size();
+                if (encodeTile(tile, data)) {
+                    rowEntries[tileRow].push_back({static_cast<std::uint32_t>(tileRow), static_cast<std::uint32_t>(tileCol),
+                                                   start, static_cast<std::uint32_t>(data.size() - start)});
+                }
+            }
+        } catch (...) {
+            failed = true;
+        }
+    });
+    if (failed) {
+        throw std::runtime_error("Out of memory compressing snapshot: " + filename);
+    }
+
+    std::uint64_t tileCount = 0;
+    std::uint64_t dataBytes = 0;
+    for (int tileRow = 0; tileRow < tileRows; ++tileRow) {
+        for (Entry& entry : rowEntries[tileRow]) {
+            entry.offset += dataBytes;
+        }
+        tileCount += rowEntries[tileRow].size();
+        dataBytes += rowData[tileRow].size();
+    }
+
+    std::string ruleText = rule.toString();
+    std::vector<char> prefix(kMagic, kMagic + sizeof(kMagic));
+    put32(prefix, kVersion);
+    put32(prefix, toroidal ? kToroidalFlag : 0);
+    put32(prefix, static_cast<std::uint32_t>(grid.getRows()));
+    put32(prefix, static_cast<std::uint32_t>(grid.getCols()));
+    put32(prefix, static_cast<std::uint32_t>(ruleText.size()));
+    put32(prefix, kTileWords);
+    put64(prefix, generation);
+    put64(prefix, tileCount);
+    put64(prefix, dataBytes);
+    prefix.insert(prefix.end(), ruleText.begin(), ruleText.end());
+    prefix.reserve(prefix.size() + tileCount * kEntryBytes);
+    for (const std::vector<Entry>& entries : rowEntries) {
+        for (const Entry& entry : entries) {
+            put32(prefix, entry.tileRow);
+            put32(prefix, entry.tileCol);
+            put64(prefix, entry.offset);
+            put32(prefix, entry.bytes);
+            put32(prefix, 0);
+        }
+    }
+
+    // Written beside the target and renamed over it, like BinarySnapshot
+    FileFormat::replaceFile(filename, [&](std::ofstream& file) {
+        file.write(prefix.data(), static_cast<std::streamsize>(prefix.size()));
+        for (const std::vector<char>& data : rowData) {
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        }
+    });
+}
+
+void CompressedSnapshot::save(const GameEngine& engine, const std::string& filename, int threads) {
+    save(engine.getCurrentGrid(), filename, engine.getRule(),
+         static_cast<std::uint64_t>(engine.getGeneration()), engine.isToroidal(), threads);
+}
+
+Snapshot CompressedSnapshot::load(const std::string& filename, int threads) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    Header header = readHeader(file, filename);
+    requireData(header, filename);
+    std::vector<char> data(header.dataBytes);
+    if (!file.read(data.data(), static_cast<std::streamsize>(data.size()))) {
+        throw std::runtime_error("Truncated compressed snapshot: " + filename);
+    }
+
+    // First index entry of every tile row, so each task finds its tiles directly
+    int tileRows = (header.rows + kTileWords - 1) / kTileWords;
+    std::vector<std::size_t> rowStart(tileRows + 1, header.index.size());
+    for (std::size_t i = header.index.size(); i-- > 0;) {
+        rowStart[header.index[i].tileRow] = i;
+    }
+    for (int tileRow = tileRows - 1; tileRow >= 0; --tileRow) {
+        rowStart[tileRow] = std::min(rowStart[tileRow], rowStart[tileRow + 1]);
+    }
+
+    Snapshot snapshot{Grid(header.rows, header.cols), Rule::parse(header.rule), header.generation,
+                      (header.flags & kToroidalFlag) != 0};
+    std::atomic<bool> corrupt{false};
+    ThreadPool pool(ThreadPool::resolveThreadCount(threads));
+    pool.parallelFor(tileRows, [&](int tileRow) {
+        Word tile[kTileWords];
+        for (std::size_t i = rowStart[tileRow]; i < rowStart[tileRow + 1]; ++i) {
+            const Entry& entry = header.index[i];
+            if (!decodeTile(data.data() + entry.offset, entry.bytes, tile)) {
+                corrupt = true;
+                return;
+            }
+            writeTile(snapshot.grid, tileRow, static_cast<int>(entry.tileCol), tile);
+        }
+    });
+    if (corrupt) {
+        throw std::runtime_error("Corrupt tile in compressed snapshot: " + filename);
+    }
+    return snapshot;
+}
+
+Rule CompressedSnapshot::loadRule(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    return Rule::parse(readHeader(file, filename).rule);
+}
+
+Grid CompressedSnapshot::loadRegion(const std::string& filename, int top, int left, int rows, int cols) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    Header header = readHeader(file, filename);
+    requireData(header, filename);
+    if (rows <= 0 || cols <= 0 || top < 0 || left < 0 ||
+        top > header.rows - rows || left > header.cols - cols) {
+        throw std::out_of_range("Region lies outside the snapshot's board");
+    }
+
+    Grid region(rows, cols);
+    std::vector<char> bytes;
+    Word tile[kTileWords];
+    std::uint32_t firstCol = static_cast<std::uint32_t>(left / kTileWords);
+    std::uint32_t lastCol = static_cast<std::uint32_t>((left + cols - 1) / kTileWords);
+    for (int tileRow = top / kTileWords; tileRow <= (top + rows - 1) / kTileWords; ++tileRow) {
+        auto entry = std::lower_bound(header.index.begin(), header.index.end(),
+                                      std::pair(static_cast<std::uint32_t>(tileRow), firstCol),
+                                      [](const Entry& e, const std::pair<std::uint32_t, std::uint32_t>& key) {
+                                          return std::pair(e.tileRow, e.tileCol) < key;
+                                      });
+        for (; entry != header.index.end() && entry->tileRow == static_cast<std::uint32_t>(tileRow) &&
+               entry->tileCol <= lastCol;
+             ++entry) {
+            bytes.resize(entry->bytes);
+            file.seekg(static_cast<std::streamoff>(header.dataOffset + entry->offset));
+            if (!file.read(bytes.data(), static_cast<std::streamsize>(bytes.size())) ||
+                !decodeTile(bytes.data(), bytes.size(), tile)) {
+                throw std::runtime_error("Corrupt tile in compressed snapshot: " + filename);
+            }
+            int firstRow = std::max(top, tileRow * kTileWords);
+            int endRow = std::min(top + rows, (tileRow + 1) * kTileWords);
+            int col = static_cast<int>(entry->tileCol) * kTileWords - left;
+            for (int row = firstRow; row < endRow; ++row) {
+                placeWord(region, row - top, col, tile[row - tileRow * kTileWords]);
+            }
+        }
+    }
+    return region;
+}
+
+bool CompressedSnapshot::isSnapshot(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[sizeof(kMagic)];
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+bool CompressedSnapshot::isSnapshotFileName(const std::string& filename) {
+    return FileFormat::endsWithIgnoreCase(filename, ".golz");
+}
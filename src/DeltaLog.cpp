@@ -0,0 +1,532 @@
+#include "DeltaLog.hpp"
+#include "FileFormat.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+using Word = Grid::Word;
+
+constexpr char kMagic[4] = {'G', 'O', 'L', 'D'};
+constexpr char kIndexMagic[8] = {'G', 'O', 'L', 'D', 'I', 'N', 'D', 'X'};
+constexpr std::uint32_t kToroidalFlag = 1;
+constexpr std::size_t kHeaderBytes = 28;      // Fixed part; the rule text follows
+constexpr std::size_t kTrailerBytes = 16;     // Index offset and kIndexMagic
+constexpr std::size_t kQueueRecords = 1024;
+constexpr std::size_t kRecycleBytes = 64 * 1024;  // Larger buffers (keyframes) are freed, not kept
+
+constexpr char kKeyframe = 'K';
+constexpr char kDelta = 'D';
+
+// Keyframe payload encodings
+enum KeyframeMode : char {
+    kCellList = 0,     // Varint gaps between live cell indices
+    kPackedWords = 1,  // rows x wordsPerRow little-endian words
+};
+
+using FileFormat::get32;
+using FileFormat::get64;
+using FileFormat::put32;
+using FileFormat::put64;
+
+// LEB128: seven bits per byte, low bits first, high bit set on all but the last
+void putVarint(std::vector<char>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+bool getVarint(const char*& next, const char* end, std::uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && next < end; shift += 7) {
+        auto byte = static_cast<unsigned char>(*next++);
+        value |= std::uint64_t{byte & 0x7Fu} << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Live cells as gaps between row-major indices; false, with nothing kept,
+// once the list grows past limit bytes
+bool encodeCellList(const Grid& grid, std::size_t limit, std::vector<char>& out) {
+    std::size_t start = out.size();
+    std::uint64_t next = 0;
+    for (int row = 0; row < grid.getRows(); ++row) {
+        const Word* words = grid.rowWords(row);
+        std::uint64_t rowStart = static_cast<std::uint64_t>(row) * grid.getCols();
+        for (int w = 0; w < grid.getWordsPerRow(); ++w) {
+            for (Word bits = words[w]; bits; bits &= bits - 1) {
+                std::uint64_t index = rowStart + w * Grid::kWordBits + std::countr_zero(bits);
+                putVarint(out, index - next);
+                next = index + 1;
+            }
+        }
+        if (out.size() - start > limit) {
+            out.resize(start);
+            return false;
+        }
+    }
+    return true;
+}
+
+void encodeKeyframe(const Grid& grid, std::size_t population, std::vector<char>& out) {
+    std::size_t words = static_cast<std::size_t>(grid.getRows()) * grid.getWordsPerRow();
+    std::size_t rawBytes = words * sizeof(Word);
+    // Every live cell takes at least a byte in the list
+    if (population < rawBytes) {
+        out.push_back(kCellList);
+        if (encodeCellList(grid, rawBytes, out)) {
+            return;
+        }
+        out.pop_back();
+    }
+    out.push_back(kPackedWords);
+    std::size_t start = out.size();
+    if constexpr (std::endian::native == std::endian::little) {
+        // Rows are contiguous in the grid's buffer
+        out.resize(start + rawBytes);
+        std::memcpy(out.data() + start, grid.data(), rawBytes);
+    } else {
+        for (std::size_t i = 0; i < words; ++i) {
+            put64(out, grid.data()[i]);
+        }
+    }
+}
+
+} // namespace
+
+struct DeltaLogWriter::Record {
+    std::vector<char> head;     // Tag, generation and payload length
+    std::vector<char> payload;
+    std::uint64_t generation = 0;
+    bool keyframe = false;
+};
+
+DeltaLogWriter::DeltaLogWriter(const std::string& filename, GameEngine& engine, int keyframeInterval)
+    : filename_(filename),
+      rows_(engine.getCurrentGrid().getRows()),
+      cols_(engine.getCurrentGrid().getCols()),
+      keyframeInterval_(keyframeInterval),
+      lastGeneration_(0),
+      lastKeyframe_(0),
+      records_(0),
+      keyframes_(0),
+      closed_(false),
+      filled_(kQueueRecords),
+      spare_(kQueueRecords),
+      failed_(false),
+      offset_(0) {
+    if (keyframeInterval < 1) {
+        throw std::invalid_argument("Keyframe interval must be positive");
+    }
+    file_.open(filename, std::ios::binary | std::ios::trunc);
+    if (!file_.is_open()) {
+        throw std::runtime_error("Cannot create file: " + filename);
+    }
+
+    std::string ruleText = engine.getRule().toString();
+    std::vector<char> header(kMagic, kMagic + sizeof(kMagic));
+    put32(header, kVersion);
+    put32(header, engine.isToroidal() ? kToroidalFlag : 0);
+    put32(header, static_cast<std::uint32_t>(rows_));
+    put32(header, static_cast<std::uint32_t>(cols_));
+    put32(header, static_cast<std::uint32_t>(keyframeInterval));
+    put32(header, static_cast<std::uint32_t>(ruleText.size()));
+    header.insert(header.end(), ruleText.begin(), ruleText.end());
+    file_.write(header.data(), static_cast<std::streamsize>(header.size()));
+    if (!file_) {
+        throw std::runtime_error("Cannot write file: " + filename);
+    }
+    offset_ = header.size();
+
+    engine.setChangeTracking(true);
+    append(engine, true);  // Queued before the I/O thread starts, so nothing can fail yet
+    io_ = std::thread(&DeltaLogWriter::writeRecords, this);
+}
+
+DeltaLogWriter::~DeltaLogWriter() {
+    try {
+        close();
+    } catch (const std::exception&) {
+        // Only close() reports write errors
+    }
+}
+
+void DeltaLogWriter::record(const GameEngine& engine) {
+    if (closed_) {
+        throw std::logic_error("Delta log is closed: " + filename_);
+    }
+    if (failed_.load(std::memory_order_acquire)) {
+        throw std::runtime_error(error_);
+    }
+    append(engine, false);
+}
+
+void DeltaLogWriter::append(const GameEngine& engine, bool forceKeyframe) {
+    const Grid& grid = engine.getCurrentGrid();
+    if (grid.getRows() != rows_ || grid.getCols() != cols_) {
+        throw std::invalid_argument("Delta log grids must keep the first grid's size");
+    }
+    auto generation = static_cast<std::uint64_t>(engine.getGeneration());
+    if (records_ > 0 && generation <= lastGeneration_) {
+        throw std::invalid_argument("Delta log generations must increase");
+    }
+
+    // The change list only describes this record if it covers one step from the last one
+    const std::vector<GameEngine::CellChange>& changes = engine.getChanges();
+    auto population = static_cast<std::size_t>(engine.getPopulation());
+    bool delta = !forceKeyframe && generation == lastGeneration_ + 1 && engine.hasCompleteChanges() &&
+                 generation - lastKeyframe_ < static_cast<std::uint64_t>(keyframeInterval_) &&
+                 changes.size() <= population;
+
+    RecordPtr record;
+    if (!spare_.tryPop(record)) {
+        record = std::make_unique<Record>();
+    }
+    record->head.clear();
+    record->payload.clear();
+    if (delta) {
+        std::uint64_t next = 0;
+        for (const GameEngine::CellChange& change : changes) {
+            std::uint64_t index = static_cast<std::uint64_t>(change.row) * cols_ + change.col;
+            putVarint(record->payload, index - next);
+            next = index + 1;
+        }
+    } else {
+        encodeKeyframe(grid, population, record->payload);
+    }
+    record->head.push_back(delta ? kDelta : kKeyframe);
+    putVarint(record->head, delta ? generation - lastGeneration_ : generation);
+    putVarint(record->head, record->payload.size());
+    record->generation = generation;
+    record->keyframe = !delta;
+    filled_.push(std::move(record));
+
+    lastGeneration_ = generation;
+    ++records_;
+    if (!delta) {
+        lastKeyframe_ = generation;
+        ++keyframes_;
+    }
+}
+
+void DeltaLogWriter::writeRecords() {
+    std::uint64_t lastGeneration = 0;
+    for (;;) {
+        RecordPtr record = filled_.pop();
+        if (!record) {
+            break;
+        }
+        if (!failed_.load(std::memory_order_relaxed)) {
+            if (record->keyframe) {
+                keyframeIndex_.emplace_back(record->generation, offset_);
+            }
+            file_.write(record->head.data(), static_cast<std::streamsize>(record->head.size()));
+            file_.write(record->payload.data(), static_cast<std::streamsize>(record->payload.size()));
+            offset_ += record->head.size() + record->payload.size();
+            lastGeneration = record->generation;
+            if (!file_) {
+                error_ = "Cannot write file: " + filename_;
+                failed_.store(true, std::memory_order_release);
+            }
+        }
+        if (record->payload.capacity() <= kRecycleBytes) {
+            spare_.tryPush(record);  // Freed instead when the spare ring is full
+        }
+    }
+    if (!failed_.load(std::memory_order_relaxed)) {
+        writeIndex(lastGeneration);
+    }
+}
+
+void DeltaLogWriter::writeIndex(std::uint64_t lastGeneration) {
+    // Keyframes as varint differences, then the trailer pointing at them
+    std::vector<char> index;
+    putVarint(index, keyframeIndex_.size());
+    putVarint(index, lastGeneration);
+    std::uint64_t previousGeneration = 0;
+    std::uint64_t previousOffset = 0;
+    for (const auto& [generation, offset] : keyframeIndex_) {
+        putVarint(index, generation - previousGeneration);
+        putVarint(index, offset - previousOffset);
+        previousGeneration = generation;
+        previousOffset = offset;
+    }
+    put64(index, offset_);
+    index.insert(index.end(), kIndexMagic, kIndexMagic + sizeof(kIndexMagic));
+    file_.write(index.data(), static_cast<std::streamsize>(index.size()));
+    file_.flush();
+    if (!file_) {
+        error_ = "Cannot write file: " + filename_;
+        failed_.store(true, std::memory_order_release);
+    }
+}
+
+void DeltaLogWriter::close() {
+    if (closed_) {
+        return;
+    }
+    closed_ = true;
+    filled_.push(nullptr);
+    io_.join();
+    file_.close();
+    if (failed_.load(std::memory_order_acquire)) {
+        throw std::runtime_error(error_);
+    }
+    if (!file_) {
+        throw std::runtime_error("Cannot write file: " + filename_);
+    }
+}
+
+bool DeltaLogWriter::isDeltaLogFileName(const std::string& filename) {
+    return FileFormat::endsWithIgnoreCase(filename, ".gold");
+}
+
+// ==================== Reader ====================
+
+DeltaLogReader::DeltaLogReader(const std::string& filename)
+    : filename_(filename),
+      file_(filename, std::ios::binary),
+      rows_(0),
+      cols_(0),
+      toroidal_(false),
+      indexed_(false),
+      lastGeneration_(0),
+      endOffset_(0),
+      grid_(1, 1),
+      generation_(0),
+      position_(0) {
+    if (!file_.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    char fixed[kHeaderBytes];
+    if (!file_.read(fixed, sizeof(fixed)) || std::memcmp(fixed, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a delta log: " + filename);
+    }
+    std::uint32_t version = get32(fixed + 4);
+    if (version > DeltaLogWriter::kVersion) {
+        throw std::runtime_error("Delta log version " + std::to_string(version) +
+                                 " is newer than this build reads: " + filename);
+    }
+    toroidal_ = (get32(fixed + 8) & kToroidalFlag) != 0;
+    std::uint32_t rows = get32(fixed + 12);
+    std::uint32_t cols = get32(fixed + 16);
+    std::uint32_t ruleBytes = get32(fixed + 24);
+    constexpr std::uint32_t kMaxSide = std::numeric_limits<int>::max();
+    if (rows == 0 || cols == 0 || rows > kMaxSide || cols > kMaxSide || ruleBytes > 4096) {
+        throw std::runtime_error("Corrupt delta log header: " + filename);
+    }
+    rows_ = static_cast<int>(rows);
+    cols_ = static_cast<int>(cols);
+    std::string ruleText(ruleBytes, '\0');
+    if (!file_.read(ruleText.data(), ruleBytes)) {
+        throw std::runtime_error("Truncated delta log: " + filename);
+    }
+    rule_ = Rule::parse(ruleText);
+
+    std::uint64_t dataOffset = kHeaderBytes + ruleBytes;
+    file_.seekg(0, std::ios::end);
+    auto fileBytes = static_cast<std::uint64_t>(file_.tellg());
+
+    // The index close() wrote, if the trailer is intact
+    if (fileBytes >= dataOffset + kTrailerBytes) {
+        char trailer[kTrailerBytes];
+        file_.seekg(static_cast<std::streamoff>(fileBytes - kTrailerBytes));
+        file_.read(trailer, sizeof(trailer));
+        std::uint64_t indexOffset = get64(trailer);
+        if (file_ && std::memcmp(trailer + 8, kIndexMagic, sizeof(kIndexMagic)) == 0 &&
+            indexOffset >= dataOffset && indexOffset <= fileBytes - kTrailerBytes) {
+            std::vector<char> index(fileBytes - kTrailerBytes - indexOffset);
+            file_.seekg(static_cast<std::streamoff>(indexOffset));
+            file_.read(index.data(), static_cast<std::streamsize>(index.size()));
+            const char* next = index.data();
+            const char* end = index.data() + index.size();
+            std::uint64_t count = 0;
+            bool valid = file_ && getVarint(next, end, count) && getVarint(next, end, lastGeneration_) &&
+                         count <= index.size();
+            std::uint64_t generation = 0;
+            std::uint64_t offset = 0;
+            for (std::uint64_t i = 0; valid && i < count; ++i) {
+                std::uint64_t generationStep = 0;
+                std::uint64_t offsetStep = 0;
+                valid = getVarint(next, end, generationStep) && getVarint(next, end, offsetStep) &&
+                        (i == 0 || (generationStep > 0 && offsetStep > 0));
+                generation += generationStep;
+                offset += offsetStep;
+                valid = valid && offset >= dataOffset && offset < indexOffset && generation <= lastGeneration_;
+                keyframes_.emplace_back(generation, offset);
+            }
+            if (!valid || next != end) {
+                throw std::runtime_error("Corrupt delta log index: " + filename);
+            }
+            indexed_ = true;
+            endOffset_ = indexOffset;
+        }
+    }
+    if (!indexed_) {
+        scanRecords(dataOffset, fileBytes);
+    }
+    if (keyframes_.empty()) {
+        throw std::runtime_error("Delta log has no complete keyframe: " + filename);
+    }
+
+    grid_ = Grid(rows_, cols_);
+    seek(keyframes_.front().first);
+}
+
+bool DeltaLogReader::readRecordHeader(std::uint64_t offset, std::uint64_t previousGeneration,
+                                      std::uint64_t end, RecordHeader& header) {
+    if (offset >= end) {
+        return false;
+    }
+    file_.clear();
+    if (static_cast<std::uint64_t>(file_.tellg()) != offset) {
+        file_.seekg(static_cast<std::streamoff>(offset));
+    }
+    // Tag plus two varints of at most ten bytes each
+    char bytes[21];
+    std::size_t available = static_cast<std::size_t>(std::min<std::uint64_t>(sizeof(bytes), end - offset));
+    if (!file_.read(bytes, static_cast<std::streamsize>(available))) {
+        return false;
+    }
+    const char* next = bytes + 1;
+    const char* stop = bytes + available;
+    std::uint64_t generation = 0;
+    header.tag = bytes[0];
+    if ((header.tag != kKeyframe && header.tag != kDelta) || !getVarint(next, stop, generation) ||
+        !getVarint(next, stop, header.payloadBytes)) {
+        return false;
+    }
+    header.generation = header.tag == kKeyframe ? generation : previousGeneration + generation;
+    header.payloadOffset = offset + static_cast<std::uint64_t>(next - bytes);
+    file_.seekg(static_cast<std::streamoff>(header.payloadOffset));
+    return header.payloadBytes <= end - header.payloadOffset;
+}
+
+void DeltaLogReader::scanRecords(std::uint64_t offset, std::uint64_t fileBytes) {
+    // Records up to the first one that is cut short or malformed, as left
+    // by a writer that never reached close()
+    RecordHeader header;
+    std::uint64_t generation = 0;
+    endOffset_ = offset;
+    while (readRecordHeader(offset, generation, fileBytes, header)) {
+        if (header.tag == kKeyframe) {
+            if (!keyframes_.empty() && header.generation <= generation) {
+                break;
+            }
+            keyframes_.emplace_back(header.generation, offset);
+        } else if (keyframes_.empty()) {
+            break;
+        }
+        generation = header.generation;
+        lastGeneration_ = generation;
+        offset = header.payloadOffset + header.payloadBytes;
+        endOffset_ = offset;
+    }
+}
+
+void DeltaLogReader::apply(const RecordHeader& header) {
+    payload_.resize(header.payloadBytes);
+    if (!file_.read(payload_.data(), static_cast<std::streamsize>(payload_.size()))) {
+        throw std::runtime_error("Truncated delta log: " + filename_);
+    }
+    const char* next = payload_.data();
+    const char* end = payload_.data() + payload_.size();
+    auto corrupt = [&] {
+        return std::runtime_error("Corrupt delta log record at offset " + std::to_string(header.payloadOffset) +
+                                  ": " + filename_);
+    };
+
+    bool toggle = header.tag == kDelta;
+    if (!toggle) {
+        if (next == end) {
+            throw corrupt();
+        }
+        char mode = *next++;
+        if (mode == kPackedWords) {
+            std::size_t words = static_cast<std::size_t>(rows_) * grid_.getWordsPerRow();
+            if (static_cast<std::size_t>(end - next) != words * sizeof(Word)) {
+                throw corrupt();
+            }
+            for (int row = 0; row < rows_; ++row) {
+                Word* rowWords = grid_.rowWords(row);
+                for (int w = 0; w < grid_.getWordsPerRow(); ++w, next += sizeof(Word)) {
+                    rowWords[w] = get64(next);
+                }
+                rowWords[grid_.getWordsPerRow() - 1] &= grid_.lastWordMask();
+            }
+            next = end;
+        } else if (mode == kCellList) {
+            grid_.clear();
+        } else {
+            throw corrupt();
+        }
+    }
+
+    // Cell indices as gaps: live cells to set, or flipped cells to toggle
+    std::uint64_t cells = static_cast<std::uint64_t>(rows_) * cols_;
+    std::uint64_t index = 0;
+    while (next < end) {
+        std::uint64_t gap = 0;
+        if (!getVarint(next, end, gap) || gap >= cells - index) {
+            throw corrupt();
+        }
+        index += gap;
+        int row = static_cast<int>(index / cols_);
+        int col = static_cast<int>(index % cols_);
+        Word bit = Word{1} << (col & 63);
+        if (toggle) {
+            grid_.rowWords(row)[col >> 6] ^= bit;
+        } else {
+            grid_.rowWords(row)[col >> 6] |= bit;
+        }
+        ++index;
+    }
+    generation_ = header.generation;
+    position_ = header.payloadOffset + header.payloadBytes;
+}
+
+void DeltaLogReader::seek(std::uint64_t generation) {
+    if (generation < getFirstGeneration() || generation > lastGeneration_) {
+        throw std::out_of_range("Generation " + std::to_string(generation) + " is not in the delta log");
+    }
+    // Nearest keyframe at or before the target, unless the current state is nearer
+    auto keyframe = std::upper_bound(keyframes_.begin(), keyframes_.end(), generation,
+                                     [](std::uint64_t value, const std::pair<std::uint64_t, std::uint64_t>& entry) {
+                                         return value < entry.first;
+                                     }) - 1;
+    RecordHeader header;
+    if (position_ == 0 || generation_ < keyframe->first || generation_ > generation) {
+        if (!readRecordHeader(keyframe->second, 0, endOffset_, header) || header.tag != kKeyframe) {
+            throw std::runtime_error("Corrupt delta log index: " + filename_);
+        }
+        apply(header);
+    }
+    while (position_ < endOffset_) {
+        if (!readRecordHeader(position_, generation_, endOffset_, header)) {
+            throw std::runtime_error("Corrupt delta log record at offset " + std::to_string(position_) + ": " + filename_);
+        }
+        if (header.generation > generation) {
+            break;
+        }
+        apply(header);
+    }
+}
+
+bool DeltaLogReader::next() {
+    if (position_ >= endOffset_) {
+        return false;
+    }
+    RecordHeader header;
+    if (!readRecordHeader(position_, generation_, endOffset_, header)) {
+        throw std::runtime_error("Corrupt delta log record at offset " + std::to_string(position_) + ": " + filename_);
+    }
+    apply(header);
+    return true;
+}
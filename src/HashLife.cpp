@@ -0,0 +1,775 @@
+#include "HashLife.hpp"
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+
+// Largest single jump; keeps every node coordinate inside int64_t
+constexpr int kMaxExponent = 56;
+
+// Smallest root: the 8x8 level keeps the padding checks meaningful
+constexpr int kMinRootLevel = 3;
+
+// Deepest macrocell node; leaves room for the expansions stepPow2() makes
+// before coordinates leave int64_t
+constexpr int kMaxMacrocellLevel = 60;
+
+std::string trimmed(const std::string& text) {
+    std::size_t begin = 0;
+    std::size_t end = text.size();
+    while (begin < end && std::isspace(static_cast<unsigned char>(text[begin]))) {
+        ++begin;
+    }
+    while (end > begin && std::isspace(static_cast<unsigned char>(text[end - 1]))) {
+        --end;
+    }
+    return text.substr(begin, end - begin);
+}
+
+} // namespace
+
+HashLifeEngine::HashLifeEngine()
+    : tableUsed_(0), nodeLimit_(std::size_t{1} << 22), root_(kNone),
+      originRow_(0), originCol_(0), windowRows_(0), windowCols_(0), generation_(0) {
+    clear();
+}
+
+HashLifeEngine::HashLifeEngine(const Grid& grid) : HashLifeEngine() {
+    loadGrid(grid);
+}
+
+void HashLifeEngine::clear() {
+    nodes_.clear();
+    freeNodes_.clear();
+    empties_.clear();
+    slowResults_.clear();
+    table_.assign(1024, kNone);
+    tableUsed_ = 0;
+
+    // The two level-0 leaves live outside the hash table at fixed ids
+    nodes_.push_back(Node{kNone, kNone, kNone, kNone, kNone, 0, 0});
+    nodes_.push_back(Node{kNone, kNone, kNone, kNone, kNone, 1, 0});
+
+    root_ = emptyNode(kMinRootLevel);
+    originRow_ = 0;
+    originCol_ = 0;
+    generation_ = 0;
+}
+
+// ==================== Canonical node table ====================
+
+std::uint64_t HashLifeEngine::hashChildren(NodeId nw, NodeId ne, NodeId sw, NodeId se) {
+    std::uint64_t h = (static_cast<std::uint64_t>(nw) << 32 | ne) * 0x9E3779B97F4A7C15ULL;
+    h ^= (static_cast<std::uint64_t>(sw) << 32 | se) * 0xC2B2AE3D27D4EB4FULL;
+    return h ^ (h >> 29);
+}
+
+HashLifeEngine::NodeId HashLifeEngine::allocateNode(const Node& value) {
+    if (!freeNodes_.empty()) {
+        NodeId id = freeNodes_.back();
+        freeNodes_.pop_back();
+        nodes_[id] = value;
+        return id;
+    }
+    if (nodes_.size() >= kNone) {
+        throw std::length_error("HashLife node table is full");
+    }
+    nodes_.push_back(value);
+    return static_cast<NodeId>(nodes_.size() - 1);
+}
+
+void HashLifeEngine::insertIntoTable(NodeId id) {
+    const Node& n = nodes_[id];
+    std::size_t mask = table_.size() - 1;
+    std::size_t slot = hashChildren(n.nw, n.ne, n.sw, n.se) & mask;
+    while (table_[slot] != kNone) {
+        slot = (slot + 1) & mask;
+    }
+    table_[slot] = id;
+    ++tableUsed_;
+}
+
+void HashLifeEngine::growTable() {
+    std::vector<NodeId> old;
+    old.swap(table_);
+    table_.assign(old.size() * 2, kNone);
+    tableUsed_ = 0;
+    for (NodeId id : old) {
+        if (id != kNone) {
+            insertIntoTable(id);
+        }
+    }
+}
+
+HashLifeEngine::NodeId HashLifeEngine::join(NodeId nw, NodeId ne, NodeId sw, NodeId se) {
+    std::size_t mask = table_.size() - 1;
+    std::size_t slot = hashChildren(nw, ne, sw, se) & mask;
+    while (table_[slot] != kNone) {
+        const Node& n = nodes_[table_[slot]];
+        if (n.nw == nw && n.ne == ne && n.sw == sw && n.se == se) {
+            return table_[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    Node created{nw, ne, sw, se, kNone,
+                 nodes_[nw].population + nodes_[ne].population +
+                     nodes_[sw].population + nodes_[se].population,
+                 static_cast<std::uint8_t>(nodes_[nw].level + 1)};
+    NodeId id = allocateNode(created);
+    table_[slot] = id;
+    if (++tableUsed_ * 2 > table_.size()) {
+        growTable();
+    }
+    return id;
+}
+
+HashLifeEngine::NodeId HashLifeEngine::emptyNode(int level) {
+    if (empties_.empty()) {
+        empties_.push_back(kDeadCell);
+    }
+    while (static_cast<int>(empties_.size()) <= level) {
+        NodeId below = empties_.back();
+        empties_.push_back(join(below, below, below, below));
+    }
+    return empties_[level];
+}
+
+// ==================== Evolution ====================
+
+HashLifeEngine::NodeId HashLifeEngine::centre(NodeId id) {
+    Node n = nodes_[id];
+    return join(nodes_[n.nw].se, nodes_[n.ne].sw, nodes_[n.sw].ne, nodes_[n.se].nw);
+}
+
+HashLifeEngine::NodeId HashLifeEngine::baseCase(NodeId id) {
+    // Gather the 4x4 block as bits, row-major from the top-left
+    Node n = nodes_[id];
+    const NodeId quads[4] = {n.nw, n.ne, n.sw, n.se};
+    unsigned cells = 0;
+    for (int q = 0; q < 4; ++q) {
+        const Node& quad = nodes_[quads[q]];
+        int row = (q / 2) * 2;
+        int col = (q % 2) * 2;
+        cells |= (quad.nw == kLiveCell ? 1u : 0u) << (row * 4 + col);
+        cells |= (quad.ne == kLiveCell ? 1u : 0u) << (row * 4 + col + 1);
+        cells |= (quad.sw == kLiveCell ? 1u : 0u) << ((row + 1) * 4 + col);
+        cells |= (quad.se == kLiveCell ? 1u : 0u) << ((row + 1) * 4 + col + 1);
+    }
+
+    NodeId next[4];
+    for (int i = 0; i < 4; ++i) {
+        int row = 1 + i / 2;
+        int col = 1 + i % 2;
+        int neighbors = 0;
+        for (int dr = -1; dr <= 1; ++dr) {
+            for (int dc = -1; dc <= 1; ++dc) {
+                if (dr != 0 || dc != 0) {
+                    neighbors += (cells >> ((row + dr) * 4 + col + dc)) & 1u;
+                }
+            }
+        }
+        bool alive = (cells >> (row * 4 + col)) & 1u;
+        next[i] = (neighbors == 3 || (neighbors == 2 && alive)) ? kLiveCell : kDeadCell;
+    }
+    return join(next[0], next[1], next[2], next[3]);
+}
+
+HashLifeEngine::NodeId HashLifeEngine::successor(NodeId id, int exponent) {
+    Node n = nodes_[id];
+    int level = n.level;
+    if (n.population == 0) {
+        return emptyNode(level - 1);
+    }
+
+    // At full speed the result is a property of the node alone; slower
+    // steps are cached per exponent on the side
+    bool fullSpeed = exponent >= level - 2;
+    std::uint64_t slowKey = (static_cast<std::uint64_t>(id) << 6) | static_cast<unsigned>(exponent);
+    if (fullSpeed) {
+        if (n.result != kNone) {
+            return n.result;
+        }
+    } else {
+        auto cached = slowResults_.find(slowKey);
+        if (cached != slowResults_.end()) {
+            return cached->second;
+        }
+    }
+
+    NodeId result;
+    if (level == 2) {
+        result = baseCase(id);
+    } else {
+        Node a = nodes_[n.nw];
+        Node b = nodes_[n.ne];
+        Node c = nodes_[n.sw];
+        Node d = nodes_[n.se];
+
+        // Nine overlapping half-size squares covering the node
+        NodeId parts[9] = {
+            n.nw, join(a.ne, b.nw, a.se, b.sw), n.ne,
+            join(a.sw, a.se, c.nw, c.ne), join(a.se, b.sw, c.ne, d.nw), join(b.sw, b.se, d.nw, d.ne),
+            n.sw, join(c.ne, d.nw, c.se, d.sw), n.se};
+
+        // Full speed advances twice (2^(level-3) each); otherwise the first
+        // stage only re-centres and the second supplies all 2^exponent steps
+        for (NodeId& part : parts) {
+            part = fullSpeed ? successor(part, exponent) : centre(part);
+        }
+
+        NodeId nw = successor(join(parts[0], parts[1], parts[3], parts[4]), exponent);
+        NodeId ne = successor(join(parts[1], parts[2], parts[4], parts[5]), exponent);
+        NodeId sw = successor(join(parts[3], parts[4], parts[6], parts[7]), exponent);
+        NodeId se = successor(join(parts[4], parts[5], parts[7], parts[8]), exponent);
+        result = join(nw, ne, sw, se);
+    }
+
+    if (fullSpeed) {
+        nodes_[id].result = result;
+    } else {
+        slowResults_.emplace(slowKey, result);
+    }
+    return result;
+}
+
+HashLifeEngine::NodeId HashLifeEngine::expand(NodeId id) {
+    Node n = nodes_[id];
+    NodeId e = emptyNode(n.level - 1);
+    std::int64_t shift = std::int64_t{1} << (n.level - 1);
+    originRow_ -= shift;
+    originCol_ -= shift;
+    return join(join(e, e, e, n.nw), join(e, e, n.ne, e),
+                join(e, n.sw, e, e), join(n.se, e, e, e));
+}
+
+bool HashLifeEngine::isPadded(NodeId id) const {
+    const Node& n = nodes_[id];
+    if (n.level < 2) {
+        return false;
+    }
+    std::uint64_t inner = nodes_[nodes_[n.nw].se].population + nodes_[nodes_[n.ne].sw].population +
+                          nodes_[nodes_[n.sw].ne].population + nodes_[nodes_[n.se].nw].population;
+    return inner == n.population;
+}
+
+void HashLifeEngine::stepPow2(int exponent) {
+    if (exponent < 0 || exponent > kMaxExponent) {
+        throw std::invalid_argument("HashLife step exponent must be in [0, " +
+                                    std::to_string(kMaxExponent) + "]");
+    }
+    generation_ += std::uint64_t{1} << exponent;
+    if (nodes_[root_].population == 0) {
+        return;
+    }
+
+    // The pattern must sit in the central quarter of a node at least two
+    // levels above the step so nothing can reach the edge of the result
+    while (nodes_[root_].level < exponent + 2 || !isPadded(root_)) {
+        root_ = expand(root_);
+    }
+    root_ = expand(root_);
+
+    std::int64_t shift = std::int64_t{1} << (nodes_[root_].level - 2);
+    root_ = successor(root_, exponent);
+    originRow_ += shift;
+    originCol_ += shift;
+
+    // Drop empty borders so the next step starts from a small canonical root
+    while (nodes_[root_].level > kMinRootLevel && isPadded(root_)) {
+        shift = std::int64_t{1} << (nodes_[root_].level - 2);
+        root_ = centre(root_);
+        originRow_ += shift;
+        originCol_ += shift;
+    }
+
+    if (getNodeCount() > nodeLimit_) {
+        collectGarbage();
+    }
+}
+
+void HashLifeEngine::stepBy(std::uint64_t generations) {
+    for (int exponent = 0; generations != 0; ++exponent, generations >>= 1) {
+        if (generations & 1) {
+            stepPow2(exponent);
+        }
+    }
+}
+
+std::uint64_t HashLifeEngine::getPopulation() const {
+    return nodes_[root_].population;
+}
+
+// ==================== Garbage collection ====================
+
+void HashLifeEngine::collectGarbage() {
+    constexpr std::uint8_t kFreeLevel = 0xFF;
+    std::vector<std::uint8_t> marked(nodes_.size(), 0);
+    marked[kDeadCell] = marked[kLiveCell] = 1;
+
+    std::vector<NodeId> pending(empties_.begin(), empties_.end());
+    pending.push_back(root_);
+    while (!pending.empty()) {
+        NodeId id = pending.back();
+        pending.pop_back();
+        if (marked[id]) {
+            continue;
+        }
+        marked[id] = 1;
+        const Node& n = nodes_[id];
+        pending.insert(pending.end(), {n.nw, n.ne, n.sw, n.se});
+    }
+
+    freeNodes_.clear();
+    std::fill(table_.begin(), table_.end(), kNone);
+    tableUsed_ = 0;
+    for (NodeId id = 2; id < nodes_.size(); ++id) {
+        Node& n = nodes_[id];
+        if (!marked[id]) {
+            n.level = kFreeLevel;
+            freeNodes_.push_back(id);
+            continue;
+        }
+        // Cached results survive only if their nodes did
+        if (n.result != kNone && !marked[n.result]) {
+            n.result = kNone;
+        }
+        insertIntoTable(id);
+    }
+    slowResults_.clear();
+
+    // A live set near the limit would otherwise collect on every step
+    if (getNodeCount() * 2 > nodeLimit_) {
+        nodeLimit_ *= 2;
+    }
+}
+
+// ==================== Grid conversion ====================
+
+HashLifeEngine::NodeId HashLifeEngine::build(const Grid& grid, int level, std::int64_t top, std::int64_t left) {
+    if (top >= grid.getRows() || left >= grid.getCols()) {
+        return emptyNode(level);
+    }
+    if (level == 0) {
+        return grid.getCell(static_cast<int>(top), static_cast<int>(left)) ? kLiveCell : kDeadCell;
+    }
+    if (level == 6) {
+        // A 64x64 block is exactly one word column of the packed grid
+        int rowEnd = static_cast<int>(std::min<std::int64_t>(top + 64, grid.getRows()));
+        int word = static_cast<int>(left / Grid::kWordBits);
+        bool empty = true;
+        for (int row = static_cast<int>(top); row < rowEnd && empty; ++row) {
+            empty = grid.rowWords(row)[word] == 0;
+        }
+        if (empty) {
+            return emptyNode(level);
+        }
+    }
+
+    std::int64_t half = std::int64_t{1} << (level - 1);
+    NodeId nw = build(grid, level - 1, top, left);
+    NodeId ne = build(grid, level - 1, top, left + half);
+    NodeId sw = build(grid, level - 1, top + half, left);
+    NodeId se = build(grid, level - 1, top + half, left + half);
+    return join(nw, ne, sw, se);
+}
+
+void HashLifeEngine::loadGrid(const Grid& grid) {
+    clear();
+    int level = kMinRootLevel;
+    while ((1 << level) < std::max(grid.getRows(), grid.getCols())) {
+        ++level;
+    }
+    root_ = build(grid, level, 0, 0);
+    windowRows_ = grid.getRows();
+    windowCols_ = grid.getCols();
+}
+
+void HashLifeEngine::paint(NodeId id, std::int64_t top, std::int64_t left, Grid& grid,
+                           std::int64_t windowTop, std::int64_t windowLeft) const {
+    const Node& n = nodes_[id];
+    std::int64_t size = std::int64_t{1} << n.level;
+    if (n.population == 0 ||
+        top >= windowTop + grid.getRows() || top + size <= windowTop ||
+        left >= windowLeft + grid.getCols() || left + size <= windowLeft) {
+        return;
+    }
+    if (n.level == 0) {
+        grid.setCell(static_cast<int>(top - windowTop), static_cast<int>(left - windowLeft), true);
+        return;
+    }
+
+    std::int64_t half = size / 2;
+    paint(n.nw, top, left, grid, windowTop, windowLeft);
+    paint(n.ne, top, left + half, grid, windowTop, windowLeft);
+    paint(n.sw, top + half, left, grid, windowTop, windowLeft);
+    paint(n.se, top + half, left + half, grid, windowTop, windowLeft);
+}
+
+Grid HashLifeEngine::toGrid(int rows, int cols, std::int64_t top, std::int64_t left) const {
+    Grid grid(rows, cols);
+    paint(root_, originRow_, originCol_, grid, top, left);
+    return grid;
+}
+
+Grid HashLifeEngine::toGrid() const {
+    if (windowRows_ == 0) {
+        throw std::logic_error("No grid window loaded");
+    }
+    return toGrid(windowRows_, windowCols_, 0, 0);
+}
+
+bool HashLifeEngine::getCell(std::int64_t row, std::int64_t col) const {
+    NodeId id = root_;
+    std::int64_t top = originRow_;
+    std::int64_t left = originCol_;
+    std::int64_t size = std::int64_t{1} << nodes_[id].level;
+    if (row < top || row >= top + size || col < left || col >= left + size) {
+        return false;
+    }
+    while (nodes_[id].level > 0) {
+        const Node& n = nodes_[id];
+        size /= 2;
+        bool south = row >= top + size;
+        bool east = col >= left + size;
+        id = south ? (east ? n.se : n.sw) : (east ? n.ne : n.nw);
+        top += south ? size : 0;
+        left += east ? size : 0;
+    }
+    return id == kLiveCell;
+}
+
+void HashLifeEngine::setRoot(NodeId root, std::int64_t originRow, std::int64_t originCol) {
+    root_ = root;
+    originRow_ = originRow;
+    originCol_ = originCol;
+}
+
+// ==================== Bounds ====================
+
+HashLifeEngine::Extent HashLifeEngine::extent(NodeId id, std::unordered_map<NodeId, Extent>& memo) const {
+    const Node& n = nodes_[id];
+    if (n.level == 0) {
+        return Extent{0, 0, 0, 0};
+    }
+    auto found = memo.find(id);
+    if (found != memo.end()) {
+        return found->second;
+    }
+
+    std::int64_t half = std::int64_t{1} << (n.level - 1);
+    const NodeId quads[4] = {n.nw, n.ne, n.sw, n.se};
+    Extent result{std::numeric_limits<std::int64_t>::max(), std::numeric_limits<std::int64_t>::max(),
+                  std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::min()};
+    for (int q = 0; q < 4; ++q) {
+        if (nodes_[quads[q]].population == 0) {
+            continue;
+        }
+        Extent quad = extent(quads[q], memo);
+        std::int64_t row = (q / 2) * half;
+        std::int64_t col = (q % 2) * half;
+        result.top = std::min(result.top, quad.top + row);
+        result.left = std::min(result.left, quad.left + col);
+        result.bottom = std::max(result.bottom, quad.bottom + row);
+        result.right = std::max(result.right, quad.right + col);
+    }
+    memo.emplace(id, result);
+    return result;
+}
+
+HashLifeEngine::Bounds HashLifeEngine::getBounds() const {
+    if (nodes_[root_].population == 0) {
+        return Bounds{};
+    }
+    // One visit per distinct node, however often the tree shares it
+    std::unordered_map<NodeId, Extent> memo;
+    Extent e = extent(root_, memo);
+    return Bounds{originRow_ + e.top, originCol_ + e.left, e.bottom - e.top + 1, e.right - e.left + 1};
+}
+
+// ==================== Macrocell files ====================
+
+HashLifeEngine::NodeId HashLifeEngine::buildLeaf(std::uint64_t cells, int level, int top, int left) {
+    if (level == 0) {
+        return (cells >> (top * 8 + left)) & 1u ? kLiveCell : kDeadCell;
+    }
+    int half = 1 << (level - 1);
+    NodeId nw = buildLeaf(cells, level - 1, top, left);
+    NodeId ne = buildLeaf(cells, level - 1, top, left + half);
+    NodeId sw = buildLeaf(cells, level - 1, top + half, left);
+    NodeId se = buildLeaf(cells, level - 1, top + half, left + half);
+    return join(nw, ne, sw, se);
+}
+
+std::uint64_t HashLifeEngine::leafCells(NodeId id, int top, int left) const {
+    const Node& n = nodes_[id];
+    if (n.level == 0) {
+        return id == kLiveCell ? std::uint64_t{1} << (top * 8 + left) : 0;
+    }
+    if (n.population == 0) {
+        return 0;
+    }
+    int half = 1 << (n.level - 1);
+    return leafCells(n.nw, top, left) | leafCells(n.ne, top, left + half) |
+           leafCells(n.sw, top + half, left) | leafCells(n.se, top + half, left + half);
+}
+
+std::string HashLifeEngine::readMacrocell(std::istream& in) {
+    std::string line;
+    if (!std::getline(in, line) || line.compare(0, 4, "[M2]") != 0) {
+        throw std::runtime_error("Not a macrocell file (expected an [M2] header)");
+    }
+    clear();
+
+    std::string rule;
+    std::uint64_t generation = 0;
+    std::vector<NodeId> lines{kNone};  // Node of each numbered line; 0 names the empty node
+    std::uint64_t lineNumber = 1;
+    auto fail = [&](const std::string& message) {
+        throw std::runtime_error("Macrocell line " + std::to_string(lineNumber) + ": " + message);
+    };
+
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+        if (line[0] == '#') {
+            if (line.compare(0, 2, "#R") == 0) {
+                rule = trimmed(line.substr(2));
+            } else if (line.compare(0, 2, "#G") == 0) {
+                std::string text = trimmed(line.substr(2));
+                auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), generation);
+                if (error != std::errc() || end != text.data() + text.size()) {
+                    fail("Invalid generation");
+                }
+            }
+            continue;
+        }
+
+        if (line[0] == '.' || line[0] == '*' || line[0] == '$') {
+            // 8x8 leaf, one '$'-terminated row at a time; missing cells are dead
+            std::uint64_t cells = 0;
+            int row = 0;
+            int col = 0;
+            for (char c : line) {
+                if (c == '$') {
+                    ++row;
+                    col = 0;
+                    continue;
+                }
+                if (c != '.' && c != '*') {
+                    fail(std::string("Invalid leaf character '") + c + "'");
+                }
+                if (row >= 8 || col >= 8) {
+                    fail("Leaf is larger than 8x8");
+                }
+                if (c == '*') {
+                    cells |= std::uint64_t{1} << (row * 8 + col);
+                }
+                ++col;
+            }
+            lines.push_back(buildLeaf(cells, 3, 0, 0));
+            continue;
+        }
+
+        std::uint64_t fields[5];
+        const char* next = line.data();
+        const char* end = line.data() + line.size();
+        for (std::uint64_t& field : fields) {
+            while (next < end && std::isspace(static_cast<unsigned char>(*next))) {
+                ++next;
+            }
+            auto [after, error] = std::from_chars(next, end, field);
+            if (error != std::errc()) {
+                fail("Expected a leaf or \"level nw ne sw se\"");
+            }
+            next = after;
+        }
+        if (!trimmed(std::string(next, end)).empty()) {
+            fail("Unexpected text after the node");
+        }
+        if (fields[0] < 1 || fields[0] > static_cast<std::uint64_t>(kMaxMacrocellLevel)) {
+            fail("Node level must be in [1, " + std::to_string(kMaxMacrocellLevel) + "]");
+        }
+
+        int level = static_cast<int>(fields[0]);
+        NodeId children[4];
+        for (int i = 0; i < 4; ++i) {
+            std::uint64_t ref = fields[i + 1];
+            if (level == 1) {
+                // Level-1 lines hold cell states directly
+                if (ref > 1) {
+                    fail("Only two-state macrocells are supported");
+                }
+                children[i] = ref ? kLiveCell : kDeadCell;
+            } else if (ref == 0) {
+                children[i] = emptyNode(level - 1);
+            } else if (ref >= lines.size() || nodes_[lines[ref]].level != level - 1) {
+                fail("Node " + std::to_string(ref) + " is not an earlier node of level " + std::to_string(level - 1));
+            } else {
+                children[i] = lines[ref];
+            }
+        }
+        lines.push_back(join(children[0], children[1], children[2], children[3]));
+    }
+
+    // The last node is the root, centred on cell (0, 0)
+    if (lines.size() > 1) {
+        NodeId root = lines.back();
+        std::int64_t half = std::int64_t{1} << (nodes_[root].level - 1);
+        setRoot(root, -half, -half);
+        while (nodes_[root_].level < kMinRootLevel) {
+            root_ = expand(root_);
+        }
+    }
+    generation_ = generation;
+    windowRows_ = 0;
+    windowCols_ = 0;
+    return rule;
+}
+
+HashLifeEngine::NodeId HashLifeEngine::shifted(NodeId block, std::int64_t dy, std::int64_t dx,
+                                               std::unordered_map<NodeId, NodeId>& memo) {
+    Node n = nodes_[block];
+    if (dy == 0 && dx == 0) {
+        return n.nw;
+    }
+    if (n.population == 0) {
+        return emptyNode(n.level - 1);
+    }
+    auto found = memo.find(block);
+    if (found != memo.end()) {
+        return found->second;
+    }
+
+    // Each quadrant of the result lies in a 2x2 block of the 4x4 grandchildren
+    Node a = nodes_[n.nw];
+    Node b = nodes_[n.ne];
+    Node c = nodes_[n.sw];
+    Node d = nodes_[n.se];
+    const NodeId grand[4][4] = {{a.nw, a.ne, b.nw, b.ne}, {a.sw, a.se, b.sw, b.se},
+                                {c.nw, c.ne, d.nw, d.ne}, {c.sw, c.se, d.sw, d.se}};
+    std::int64_t quarter = std::int64_t{1} << (n.level - 2);
+    NodeId quads[4];
+    for (int q = 0; q < 4; ++q) {
+        std::int64_t y = dy + (q / 2) * quarter;
+        std::int64_t x = dx + (q % 2) * quarter;
+        int row = static_cast<int>(y / quarter);
+        int col = static_cast<int>(x / quarter);
+        NodeId inner = join(grand[row][col], grand[row][col + 1], grand[row + 1][col], grand[row + 1][col + 1]);
+        quads[q] = shifted(inner, y % quarter, x % quarter, memo);
+    }
+    NodeId result = join(quads[0], quads[1], quads[2], quads[3]);
+    memo.emplace(block, result);
+    return result;
+}
+
+HashLifeEngine::NodeId HashLifeEngine::window(int level, std::int64_t top, std::int64_t left,
+                                              std::unordered_map<NodeId, NodeId>& memo) {
+    int rootLevel = nodes_[root_].level;
+    std::int64_t size = std::int64_t{1} << level;
+    std::int64_t rootSize = std::int64_t{1} << rootLevel;
+    if (top >= originRow_ + rootSize || top + size <= originRow_ ||
+        left >= originCol_ + rootSize || left + size <= originCol_) {
+        return emptyNode(level);
+    }
+    if (level > rootLevel) {
+        std::int64_t half = size / 2;
+        NodeId nw = window(level - 1, top, left, memo);
+        NodeId ne = window(level - 1, top, left + half, memo);
+        NodeId sw = window(level - 1, top + half, left, memo);
+        NodeId se = window(level - 1, top + half, left + half, memo);
+        return join(nw, ne, sw, se);
+    }
+
+    // A root-sized square overlapping the root: place the root in the
+    // quadrant of a block that puts the square at a non-negative offset
+    std::int64_t dy = top - originRow_;
+    std::int64_t dx = left - originCol_;
+    NodeId e = emptyNode(rootLevel);
+    NodeId quads[4] = {e, e, e, e};
+    quads[(dy < 0 ? 2 : 0) + (dx < 0 ? 1 : 0)] = root_;
+    dy += dy < 0 ? rootSize : 0;
+    dx += dx < 0 ? rootSize : 0;
+    return shifted(join(quads[0], quads[1], quads[2], quads[3]), dy, dx, memo);
+}
+
+std::uint64_t HashLifeEngine::writeNode(NodeId id, std::ostream& out, std::unordered_map<NodeId, std::uint64_t>& lines,
+                                        std::uint64_t& lineCount) const {
+    const Node& n = nodes_[id];
+    if (n.population == 0) {
+        return 0;
+    }
+    auto found = lines.find(id);
+    if (found != lines.end()) {
+        return found->second;
+    }
+
+    if (n.level == 3) {
+        // Rows up to the last live cell, each up to its last live cell
+        std::uint64_t cells = leafCells(id, 0, 0);
+        std::string text;
+        int rows = 8 - std::countl_zero(cells) / 8;
+        for (int row = 0; row < rows; ++row) {
+            for (unsigned bits = (cells >> (row * 8)) & 0xFF; bits; bits >>= 1) {
+                text += (bits & 1) ? '*' : '.';
+            }
+            text += '$';
+        }
+        out << text << '\n';
+    } else {
+        std::uint64_t nw = writeNode(n.nw, out, lines, lineCount);
+        std::uint64_t ne = writeNode(n.ne, out, lines, lineCount);
+        std::uint64_t sw = writeNode(n.sw, out, lines, lineCount);
+        std::uint64_t se = writeNode(n.se, out, lines, lineCount);
+        out << static_cast<int>(n.level) << ' ' << nw << ' ' << ne << ' ' << sw << ' ' << se << '\n';
+    }
+    lines.emplace(id, ++lineCount);
+    return lineCount;
+}
+
+void HashLifeEngine::writeMacrocell(std::ostream& out, const std::string& rule) {
+    out << "[M2] (GameOfLife)\n";
+    if (!rule.empty()) {
+        out << "#R " << rule << "\n";
+    }
+    if (generation_ != 0) {
+        out << "#G " << generation_ << "\n";
+    }
+    if (nodes_[root_].population == 0) {
+        return;
+    }
+
+    // The smallest square centred on (0, 0) holding the root, re-joined
+    // from shifted copies of its nodes unless the root already is one
+    int rootLevel = nodes_[root_].level;
+    std::int64_t rootSize = std::int64_t{1} << rootLevel;
+    int level = rootLevel;
+    for (;; ++level) {
+        if (level > kMaxMacrocellLevel) {
+            throw std::overflow_error("Pattern lies too far from the origin for a macrocell file");
+        }
+        std::int64_t half = std::int64_t{1} << (level - 1);
+        if (originRow_ >= -half && originRow_ + rootSize <= half &&
+            originCol_ >= -half && originCol_ + rootSize <= half) {
+            break;
+        }
+    }
+    std::int64_t half = std::int64_t{1} << (level - 1);
+    std::unordered_map<NodeId, NodeId> shifts;
+    NodeId root = window(level, -half, -half, shifts);
+
+    std::unordered_map<NodeId, std::uint64_t> lines;
+    std::uint64_t lineCount = 0;
+    writeNode(root, out, lines, lineCount);
+}
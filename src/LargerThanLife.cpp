@@ -0,0 +1,462 @@
+#include "LargerThanLife.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace {
+
+struct NamedRule {
+    const char* name;
+    const char* notation;
+};
+
+const NamedRule kNamedRules[] = {
+    {"bosco", "R5,C0,M1,S34..58,B34..45,NM"},
+    {"majority", "R4,C0,M1,S41..81,B41..81,NM"},
+};
+
+// Small non-negative decimal; throws on anything else
+int parseNumber(const std::string& digits, const std::string& text) {
+    if (digits.empty() || digits.size() > 3 ||
+        !std::all_of(digits.begin(), digits.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
+        throw std::invalid_argument("Invalid number in Larger-than-Life rule: " + text);
+    }
+    return std::stoi(digits);
+}
+
+// "a..b" or a single count "a"
+void parseRange(const std::string& range, const std::string& text, int& low, int& high) {
+    std::size_t dots = range.find("..");
+    if (dots == std::string::npos) {
+        low = high = parseNumber(range, text);
+        return;
+    }
+    low = parseNumber(range.substr(0, dots), text);
+    high = parseNumber(range.substr(dots + 2), text);
+}
+
+inline int wrap(int index, int size) {
+    return ((index % size) + size) % size;
+}
+
+} // namespace
+
+// ==================== LargerThanLifeRule ====================
+
+LargerThanLifeRule::LargerThanLifeRule()
+    : LargerThanLifeRule(1, Neighborhood::Moore, false, 3, 3, 2, 3) {}
+
+LargerThanLifeRule::LargerThanLifeRule(int radius, Neighborhood neighborhood, bool countsMiddle,
+                                       int birthMin, int birthMax, int survivalMin, int survivalMax)
+    : radius_(radius), neighborhood_(neighborhood), countsMiddle_(countsMiddle),
+      birthMin_(birthMin), birthMax_(birthMax), survivalMin_(survivalMin), survivalMax_(survivalMax) {
+    if (radius < 1 || radius > kMaxRadius) {
+        throw std::invalid_argument("Larger-than-Life radius must be between 1 and 10");
+    }
+    int size = getNeighborhoodSize();
+    if (birthMin < 0 || birthMin > birthMax || birthMax > size ||
+        survivalMin < 0 || survivalMin > survivalMax || survivalMax > size) {
+        throw std::invalid_argument("Larger-than-Life ranges must lie within 0.." + std::to_string(size));
+    }
+}
+
+LargerThanLifeRule LargerThanLifeRule::parse(const std::string& text) {
+    std::string lower;
+    for (char c : text) {
+        if (!std::isspace(static_cast<unsigned char>(c))) {
+            lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    for (const NamedRule& named : kNamedRules) {
+        if (lower == named.name) {
+            return parse(named.notation);
+        }
+    }
+
+    int radius = -1;
+    int middle = 0;
+    int birthMin = -1, birthMax = -1;
+    int survivalMin = -1, survivalMax = -1;
+    Neighborhood neighborhood = Neighborhood::Moore;
+    std::string seen;
+
+    std::size_t start = 0;
+    while (start <= lower.size()) {
+        std::size_t comma = lower.find(',', start);
+        std::string part = lower.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        start = comma == std::string::npos ? lower.size() + 1 : comma + 1;
+
+        if (part.size() < 2 || seen.find(part[0]) != std::string::npos) {
+            throw std::invalid_argument("Larger-than-Life rule must look like R5,C0,M1,S34..58,B34..45,NM: " + text);
+        }
+        seen += part[0];
+        std::string value = part.substr(1);
+        switch (part[0]) {
+            case 'r':
+                radius = parseNumber(value, text);
+                break;
+            case 'c': {
+                int states = parseNumber(value, text);
+                if (states > 2) {
+                    throw std::invalid_argument("Multi-state Larger-than-Life rules are not supported: " + text);
+                }
+                break;
+            }
+            case 'm':
+                middle = parseNumber(value, text);
+                if (middle > 1) {
+                    throw std::invalid_argument("M must be 0 or 1 in Larger-than-Life rule: " + text);
+                }
+                break;
+            case 's':
+                parseRange(value, text, survivalMin, survivalMax);
+                break;
+            case 'b':
+                parseRange(value, text, birthMin, birthMax);
+                break;
+            case 'n':
+                if (value == "m") {
+                    neighborhood = Neighborhood::Moore;
+                } else if (value == "n") {
+                    neighborhood = Neighborhood::VonNeumann;
+                } else {
+                    throw std::invalid_argument("Neighbourhood must be NM or NN in Larger-than-Life rule: " + text);
+                }
+                break;
+            default:
+                throw std::invalid_argument("Unknown part '" + part + "' in Larger-than-Life rule: " + text);
+        }
+    }
+
+    if (radius < 0 || birthMin < 0 || survivalMin < 0) {
+        throw std::invalid_argument("Larger-than-Life rule needs R, S and B: " + text);
+    }
+    return LargerThanLifeRule(radius, neighborhood, middle == 1, birthMin, birthMax, survivalMin, survivalMax);
+}
+
+int LargerThanLifeRule::getNeighborhoodSize() const {
+    int cells = neighborhood_ == Neighborhood::Moore ? (2 * radius_ + 1) * (2 * radius_ + 1)
+                                                     : 2 * radius_ * (radius_ + 1) + 1;
+    return countsMiddle_ ? cells : cells - 1;
+}
+
+std::string LargerThanLifeRule::toString() const {
+    std::string text = "R";
+    text += std::to_string(radius_);
+    text += countsMiddle_ ? ",C0,M1" : ",C0,M0";
+    text += ",S";
+    text += std::to_string(survivalMin_);
+    text += "..";
+    text += std::to_string(survivalMax_);
+    text += ",B";
+    text += std::to_string(birthMin_);
+    text += "..";
+    text += std::to_string(birthMax_);
+    text += neighborhood_ == Neighborhood::Moore ? ",NM" : ",NN";
+    return text;
+}
+
+bool LargerThanLifeRule::operator==(const LargerThanLifeRule& other) const {
+    return radius_ == other.radius_ && neighborhood_ == other.neighborhood_ &&
+           countsMiddle_ == other.countsMiddle_ &&
+           birthMin_ == other.birthMin_ && birthMax_ == other.birthMax_ &&
+           survivalMin_ == other.survivalMin_ && survivalMax_ == other.survivalMax_;
+}
+
+// ==================== LargerThanLifeEngine ====================
+
+LargerThanLifeEngine::LargerThanLifeEngine(const Grid& grid, const LargerThanLifeRule& rule, bool toroidal)
+    : current_(std::make_unique<Grid>(grid)),
+      next_(std::make_unique<Grid>(grid.getRows(), grid.getCols())),
+      rule_(rule),
+      toroidal_(toroidal),
+      generation_(0),
+      isStable_(false) {
+}
+
+LargerThanLifeEngine::~LargerThanLifeEngine() = default;
+
+void LargerThanLifeEngine::setCurrentGrid(const Grid& grid) {
+    if (grid.getRows() != current_->getRows() || grid.getCols() != current_->getCols()) {
+        throw std::invalid_argument("Grid dimensions must match");
+    }
+    *current_ = grid;
+    isStable_ = false;
+}
+
+void LargerThanLifeEngine::setThreadCount(int threads) {
+    int resolved = ThreadPool::resolveThreadCount(threads);
+    if (resolved == getThreadCount()) {
+        return;
+    }
+    pool_ = resolved > 1 ? std::make_unique<ThreadPool>(resolved) : nullptr;
+}
+
+void LargerThanLifeEngine::step() {
+    int rows = current_->getRows();
+    // Each band re-reads a halo of 2R + 2 rows, so keep bands well above that
+    const int minBandRows = 32;
+    int bands = pool_ ? std::clamp(rows / minBandRows, 1, pool_->getThreadCount() * 4) : 1;
+    if (static_cast<int>(scratch_.size()) < bands) {
+        scratch_.resize(bands);
+    }
+
+    auto bandRows = [&](int band, int& rowBegin, int& rowEnd) {
+        rowBegin = static_cast<int>(static_cast<long long>(rows) * band / bands);
+        rowEnd = static_cast<int>(static_cast<long long>(rows) * (band + 1) / bands);
+    };
+    bool changed;
+    if (!pool_) {
+        changed = stepBand(0, rows, scratch_[0]);
+    } else {
+        std::atomic<bool> anyChanged(false);
+        pool_->parallelFor(bands, [&](int band) {
+            int rowBegin, rowEnd;
+            bandRows(band, rowBegin, rowEnd);
+            if (stepBand(rowBegin, rowEnd, scratch_[band])) {
+                anyChanged.store(true, std::memory_order_relaxed);
+            }
+        });
+        changed = anyChanged.load(std::memory_order_relaxed);
+    }
+
+    isStable_ = !changed;
+    std::swap(current_, next_);
+    ++generation_;
+}
+
+int LargerThanLifeEngine::countNeighbors(int row, int col) const {
+    int rows = current_->getRows();
+    int cols = current_->getCols();
+    int radius = rule_.getRadius();
+    bool moore = rule_.getNeighborhood() == LargerThanLifeRule::Neighborhood::Moore;
+    int count = 0;
+    for (int dr = -radius; dr <= radius; ++dr) {
+        int reach = moore ? radius : radius - std::abs(dr);
+        for (int dc = -reach; dc <= reach; ++dc) {
+            if (dr == 0 && dc == 0 && !rule_.countsMiddle()) {
+                continue;
+            }
+            int r = row + dr;
+            int c = col + dc;
+            if (toroidal_) {
+                r = wrap(r, rows);
+                c = wrap(c, cols);
+            } else if (r < 0 || r >= rows || c < 0 || c >= cols) {
+                continue;
+            }
+            count += current_->getCell(r, c);
+        }
+    }
+    return count;
+}
+
+bool LargerThanLifeEngine::stepBand(int rowBegin, int rowEnd, BandScratch& scratch) {
+    int cols = current_->getCols();
+    int halo = rule_.getRadius() + 1;
+    int width = cols + 2 * halo;
+    int height = rowEnd - rowBegin + 2 * halo;
+    bool moore = rule_.getNeighborhood() == LargerThanLifeRule::Neighborhood::Moore;
+
+    // Buffers only ever grow, so steady-state steps reuse them
+    auto reserve = [](auto& buffer, std::size_t size) {
+        if (buffer.size() < size) {
+            buffer.resize(size);
+        }
+    };
+    std::size_t cells = static_cast<std::size_t>(height) * width;
+    reserve(scratch.window, cells);
+    reserve(scratch.counts, width);
+    if (moore) {
+        reserve(scratch.columnSums, width);
+    } else {
+        reserve(scratch.diagDown, cells);
+        reserve(scratch.diagUp, cells);
+    }
+
+    fillWindow(rowBegin, rowEnd, scratch);
+    if (!moore) {
+        buildDiagonals(scratch, height);
+    }
+
+    const std::uint8_t* window = scratch.window.data();
+    const std::uint16_t* counts = scratch.counts.data();
+    int middle = rule_.countsMiddle() ? 0 : 1;
+    int words = current_->getWordsPerRow();
+    // Range tests as one unsigned compare each, so the cell loop has no branches
+    unsigned birthMin = static_cast<unsigned>(rule_.getBirthMin());
+    unsigned birthSpan = static_cast<unsigned>(rule_.getBirthMax() - rule_.getBirthMin());
+    unsigned survivalMin = static_cast<unsigned>(rule_.getSurvivalMin());
+    unsigned survivalSpan = static_cast<unsigned>(rule_.getSurvivalMax() - rule_.getSurvivalMin());
+    Grid::Word changed = 0;
+
+    for (int row = rowBegin; row < rowEnd; ++row) {
+        int y = halo + row - rowBegin;
+        if (moore) {
+            countMooreRow(scratch, y, row == rowBegin);
+        } else {
+            countVonNeumannRow(scratch, y, row == rowBegin);
+        }
+
+        const std::uint8_t* cellRow = window + static_cast<std::size_t>(y) * width + halo;
+        const std::uint16_t* countRow = counts + halo;
+        const Grid::Word* in = current_->rowWords(row);
+        Grid::Word* out = next_->rowWords(row);
+        for (int w = 0; w < words; ++w) {
+            int first = w * Grid::kWordBits;
+            int last = std::min(cols, first + Grid::kWordBits);
+            Grid::Word word = 0;
+            for (int col = first; col < last; ++col) {
+                unsigned alive = cellRow[col];
+                unsigned count = countRow[col] - (middle & alive);
+                unsigned born = (count - birthMin) <= birthSpan;
+                unsigned survives = (count - survivalMin) <= survivalSpan;
+                Grid::Word next = (alive & survives) | (~alive & 1u & born);
+                word |= next << (col - first);
+            }
+            changed |= word ^ in[w];
+            out[w] = word;
+        }
+    }
+    return changed != 0;
+}
+
+void LargerThanLifeEngine::fillWindow(int rowBegin, int rowEnd, BandScratch& scratch) const {
+    int rows = current_->getRows();
+    int cols = current_->getCols();
+    int halo = rule_.getRadius() + 1;
+    int width = cols + 2 * halo;
+    int height = rowEnd - rowBegin + 2 * halo;
+
+    for (int y = 0; y < height; ++y) {
+        std::uint8_t* dst = scratch.window.data() + static_cast<std::size_t>(y) * width;
+        int row = rowBegin - halo + y;
+        if (toroidal_) {
+            row = wrap(row, rows);
+        } else if (row < 0 || row >= rows) {
+            std::fill(dst, dst + width, 0);
+            continue;
+        }
+
+        const Grid::Word* words = current_->rowWords(row);
+        for (int col = 0; col < cols; ++col) {
+            dst[halo + col] = static_cast<std::uint8_t>((words[col >> 6] >> (col & 63)) & 1);
+        }
+        for (int k = 1; k <= halo; ++k) {
+            dst[halo - k] = toroidal_ ? dst[halo + wrap(-k, cols)] : 0;
+            dst[halo + cols - 1 + k] = toroidal_ ? dst[halo + wrap(cols - 1 + k, cols)] : 0;
+        }
+    }
+}
+
+void LargerThanLifeEngine::countMooreRow(BandScratch& scratch, int y, bool first) const {
+    int cols = current_->getCols();
+    int radius = rule_.getRadius();
+    int halo = radius + 1;
+    int width = cols + 2 * halo;
+    const std::uint8_t* window = scratch.window.data();
+    std::uint16_t* columns = scratch.columnSums.data();
+    std::uint16_t* counts = scratch.counts.data();
+
+    // Vertical sums of rows y - R .. y + R for every window column
+    if (first) {
+        std::fill(columns, columns + width, 0);
+        for (int dy = -radius; dy <= radius; ++dy) {
+            const std::uint8_t* src = window + static_cast<std::size_t>(y + dy) * width;
+            for (int x = 0; x < width; ++x) {
+                columns[x] += src[x];
+            }
+        }
+    } else {
+        const std::uint8_t* entering = window + static_cast<std::size_t>(y + radius) * width;
+        const std::uint8_t* leaving = window + static_cast<std::size_t>(y - radius - 1) * width;
+        for (int x = 0; x < width; ++x) {
+            columns[x] = static_cast<std::uint16_t>(columns[x] + entering[x] - leaving[x]);
+        }
+    }
+
+    // Horizontal running sum over 2R + 1 columns
+    std::uint16_t sum = 0;
+    for (int x = halo - radius; x <= halo + radius; ++x) {
+        sum = static_cast<std::uint16_t>(sum + columns[x]);
+    }
+    counts[halo] = sum;
+    for (int x = halo + 1; x < halo + cols; ++x) {
+        sum = static_cast<std::uint16_t>(sum + columns[x + radius] - columns[x - radius - 1]);
+        counts[x] = sum;
+    }
+}
+
+void LargerThanLifeEngine::buildDiagonals(BandScratch& scratch, int height) const {
+    int width = current_->getCols() + 2 * (rule_.getRadius() + 1);
+    const std::uint8_t* window = scratch.window.data();
+    std::uint16_t* down = scratch.diagDown.data();
+    std::uint16_t* up = scratch.diagUp.data();
+
+    // Sums wrap modulo 2^16; every segment read back is at most R + 1 cells,
+    // so differences of these prefixes are still exact
+    std::copy(window, window + width, down);
+    std::copy(window, window + width, up);
+    for (int y = 1; y < height; ++y) {
+        const std::uint8_t* src = window + static_cast<std::size_t>(y) * width;
+        std::uint16_t* downRow = down + static_cast<std::size_t>(y) * width;
+        std::uint16_t* upRow = up + static_cast<std::size_t>(y) * width;
+        const std::uint16_t* downAbove = downRow - width;
+        const std::uint16_t* upAbove = upRow - width;
+        downRow[0] = src[0];
+        for (int x = 1; x < width; ++x) {
+            downRow[x] = static_cast<std::uint16_t>(src[x] + downAbove[x - 1]);
+        }
+        for (int x = 0; x < width - 1; ++x) {
+            upRow[x] = static_cast<std::uint16_t>(src[x] + upAbove[x + 1]);
+        }
+        upRow[width - 1] = src[width - 1];
+    }
+}
+
+void LargerThanLifeEngine::countVonNeumannRow(BandScratch& scratch, int y, bool first) const {
+    int cols = current_->getCols();
+    int radius = rule_.getRadius();
+    int halo = radius + 1;
+    int width = cols + 2 * halo;
+    const std::uint8_t* window = scratch.window.data();
+    std::uint16_t* counts = scratch.counts.data();
+
+    if (first) {
+        // The band's first row is summed directly; the rest slide from it
+        for (int x = halo; x < halo + cols; ++x) {
+            int count = 0;
+            for (int dy = -radius; dy <= radius; ++dy) {
+                int reach = radius - std::abs(dy);
+                const std::uint8_t* src = window + static_cast<std::size_t>(y + dy) * width + x;
+                for (int dx = -reach; dx <= reach; ++dx) {
+                    count += src[dx];
+                }
+            }
+            counts[x] = static_cast<std::uint16_t>(count);
+        }
+        return;
+    }
+
+    // Moving the diamond down a row drops its upper edge, two diagonals
+    // meeting at (y - 1 - R, x), and gains its lower edge, two diagonals
+    // meeting at (y + R, x); each diagonal is a difference of prefix sums
+    auto at = [width](const auto* base, int row, int x) {
+        return base[static_cast<std::size_t>(row) * width + x];
+    };
+    const std::uint16_t* down = scratch.diagDown.data();
+    const std::uint16_t* up = scratch.diagUp.data();
+    int top = y - 1 - radius;
+    int bottom = y + radius;
+    for (int x = halo; x < halo + cols; ++x) {
+        std::uint16_t leaving = static_cast<std::uint16_t>(
+            (at(up, y - 1, x - radius) - at(up, top - 1, x + 1)) +
+            (at(down, y - 1, x + radius) - at(down, top - 1, x - 1)) - at(window, top, x));
+        std::uint16_t entering = static_cast<std::uint16_t>(
+            (at(down, bottom, x) - at(down, y - 1, x - radius - 1)) +
+            (at(up, bottom, x) - at(up, y - 1, x + radius + 1)) - at(window, bottom, x));
+        counts[x] = static_cast<std::uint16_t>(counts[x] - leaving + entering);
+    }
+}
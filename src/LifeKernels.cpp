@@ -0,0 +1,793 @@
+#if defined(__GNUC__) && defined(__x86_64__)
+#define LIFE_KERNELS_X86_SIMD 1
+// Vector-typed helpers below are always inlined into their target("...")
+// kernels, so the out-of-line vector ABI GCC warns about is never used
+#pragma GCC diagnostic ignored "-Wpsabi"
+#include <immintrin.h>
+#endif
+
+#include "LifeKernels.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <type_traits>
+
+namespace LifeKernels {
+
+namespace {
+
+// ==================== Rule policies ====================
+// Each policy maps the nine aligned neighbour bitboards to the next state.
+// Kernels are instantiated per policy, so fixed rules compile to straight-
+// line logic and only the generic policy reads its masks at run time.
+
+struct ConwayRule {
+    template <typename W>
+    LIFE_KERNELS_INLINE W operator()(const W& nw, const W& n, const W& ne, const W& w, const W& c,
+                                     const W& e, const W& sw, const W& s, const W& se) const {
+        return conwayNext(nw, n, ne, w, c, e, sw, s, se);
+    }
+};
+
+template <unsigned Birth, unsigned Survival>
+struct FixedRule {
+    template <typename W>
+    LIFE_KERNELS_INLINE W operator()(const W& nw, const W& n, const W& ne, const W& w, const W& c,
+                                     const W& e, const W& sw, const W& s, const W& se) const {
+        return ruleNext<Birth, Survival>(nw, n, ne, w, c, e, sw, s, se);
+    }
+};
+
+// Fallback for any other rule: per-count all-ones/all-zero masks looked up
+// from a table built once per call, then selected with the bit-sliced count
+struct TableRule {
+    Word born[9];
+    Word survives[9];
+
+    explicit TableRule(const Rule& rule) {
+        for (int count = 0; count <= 8; ++count) {
+            born[count] = rule.isBorn(count) ? ~Word{0} : 0;
+            survives[count] = rule.survives(count) ? ~Word{0} : 0;
+        }
+    }
+
+    template <typename W>
+    LIFE_KERNELS_INLINE W operator()(const W& nw, const W& n, const W& ne, const W& w, const W& c,
+                                     const W& e, const W& sw, const W& s, const W& se) const {
+        NeighbourCount<W> count = countNeighbours(nw, n, ne, w, e, sw, s, se);
+        W notC = ~c;
+        W result = countEquals<0>(count) & ((notC & born[0]) | (c & survives[0]));
+        result |= countEquals<1>(count) & ((notC & born[1]) | (c & survives[1]));
+        result |= countEquals<2>(count) & ((notC & born[2]) | (c & survives[2]));
+        result |= countEquals<3>(count) & ((notC & born[3]) | (c & survives[3]));
+        result |= countEquals<4>(count) & ((notC & born[4]) | (c & survives[4]));
+        result |= countEquals<5>(count) & ((notC & born[5]) | (c & survives[5]));
+        result |= countEquals<6>(count) & ((notC & born[6]) | (c & survives[6]));
+        result |= countEquals<7>(count) & ((notC & born[7]) | (c & survives[7]));
+        result |= countEquals<8>(count) & ((notC & born[8]) | (c & survives[8]));
+        return result;
+    }
+};
+
+// B/S masks as template arguments: bit n of each is neighbour count n
+constexpr unsigned counts(std::initializer_list<int> list) {
+    unsigned mask = 0;
+    for (int n : list) {
+        mask |= 1u << n;
+    }
+    return mask;
+}
+
+/**
+ * Calls fn with the policy for rule: Conway's own adder, a specialised
+ * FixedRule for the well-known rules below, or the generic TableRule.
+ */
+template <typename Fn>
+decltype(auto) withRule(const Rule& rule, Fn&& fn) {
+#define LIFE_KERNELS_FIXED_RULE(BIRTH, SURVIVAL)                                    \
+    if (rule.getBirthMask() == counts BIRTH && rule.getSurvivalMask() == counts SURVIVAL) { \
+        return fn(FixedRule<counts BIRTH, counts SURVIVAL>());                      \
+    }
+    if (rule.isConway()) {
+        return fn(ConwayRule());
+    }
+    LIFE_KERNELS_FIXED_RULE(({3, 6}), ({2, 3}))                     // HighLife
+    LIFE_KERNELS_FIXED_RULE(({3, 6, 7, 8}), ({3, 4, 6, 7, 8}))      // Day & Night
+    LIFE_KERNELS_FIXED_RULE(({2}), ({}))                            // Seeds
+    LIFE_KERNELS_FIXED_RULE(({3}), ({0, 1, 2, 3, 4, 5, 6, 7, 8}))   // Life without death
+    LIFE_KERNELS_FIXED_RULE(({3}), ({1, 2, 3, 4, 5}))               // Maze
+    LIFE_KERNELS_FIXED_RULE(({1, 3, 5, 7}), ({1, 3, 5, 7}))         // Replicator
+    LIFE_KERNELS_FIXED_RULE(({3, 6}), ({1, 2, 5}))                  // 2x2
+    LIFE_KERNELS_FIXED_RULE(({3, 5, 6, 7, 8}), ({5, 6, 7, 8}))      // Diamoeba
+    LIFE_KERNELS_FIXED_RULE(({3, 6, 8}), ({2, 4, 5}))               // Morley
+#undef LIFE_KERNELS_FIXED_RULE
+    return fn(TableRule(rule));
+}
+
+// ==================== Row kernels ====================
+
+// Westward neighbours of word w, supplying the wrapped-in last column for word 0.
+inline Word westAt(const Word* row, int w, int words, int lastBit, bool toroidal) {
+    if (w > 0) {
+        return westOf(row[w], row[w - 1]);
+    }
+    Word wrapped = toroidal ? (row[words - 1] >> lastBit) << 63 : 0;
+    return westOf(row[w], wrapped);
+}
+
+// Eastward neighbours of word w, supplying the wrapped-in first column for the last word.
+inline Word eastAt(const Word* row, int w, int words, int lastBit, bool toroidal) {
+    if (w + 1 < words) {
+        return eastOf(row[w], row[w + 1]);
+    }
+    Word wrapped = toroidal ? (row[0] & 1) << lastBit : 0;
+    return (row[w] >> 1) | wrapped;
+}
+
+// Next state of any single word w, wrapping or clipping at the row ends
+template <typename R>
+inline Word nextWordAt(const R& rule, const Word* above, const Word* row, const Word* below,
+                       int w, int words, int lastBit, bool toroidal) {
+    return rule(westAt(above, w, words, lastBit, toroidal), above[w],
+                eastAt(above, w, words, lastBit, toroidal),
+                westAt(row, w, words, lastBit, toroidal), row[w],
+                eastAt(row, w, words, lastBit, toroidal),
+                westAt(below, w, words, lastBit, toroidal), below[w],
+                eastAt(below, w, words, lastBit, toroidal));
+}
+
+// Interior words [begin, end) of one row; every word there has both neighbours.
+template <typename R>
+using InteriorFn = void (*)(const R& rule, const Word* above, const Word* row, const Word* below,
+                            Word* out, int begin, int end);
+
+// Scalar loop, also inlined as the tail of the SIMD kernels so it is compiled
+// for their target and no legacy-SSE code runs while upper lanes are dirty
+template <typename R>
+LIFE_KERNELS_INLINE void interiorWords(const R& rule, const Word* above, const Word* row,
+                                       const Word* below, Word* out, int w, int end) {
+    for (; w < end; ++w) {
+        out[w] = rule(westOf(above[w], above[w - 1]), above[w], eastOf(above[w], above[w + 1]),
+                      westOf(row[w], row[w - 1]), row[w], eastOf(row[w], row[w + 1]),
+                      westOf(below[w], below[w - 1]), below[w], eastOf(below[w], below[w + 1]));
+    }
+}
+
+template <typename R>
+void interiorScalar(const R& rule, const Word* above, const Word* row, const Word* below,
+                    Word* out, int begin, int end) {
+    interiorWords(rule, above, row, below, out, begin, end);
+}
+
+#ifdef LIFE_KERNELS_X86_SIMD
+
+// The SIMD kernels use compiler vector types so the rule policies are shared
+// with the scalar path; target attributes keep the rest of the binary portable.
+typedef Word Vec4 __attribute__((vector_size(32)));
+typedef Word Vec8 __attribute__((vector_size(64)));
+
+template <typename V>
+__attribute__((always_inline)) inline V loadWords(const Word* p) {
+    V v;
+    std::memcpy(&v, p, sizeof v);
+    return v;
+}
+
+template <typename V>
+__attribute__((always_inline)) inline void storeWords(Word* p, const V& v) {
+    std::memcpy(p, &v, sizeof v);
+}
+
+template <typename V, typename R>
+__attribute__((always_inline)) inline void storeNextWords(const R& rule, const Word* above, const Word* row,
+                                                          const Word* below, Word* out, int w) {
+    V a = loadWords<V>(above + w);
+    V r = loadWords<V>(row + w);
+    V b = loadWords<V>(below + w);
+    storeWords<V>(out + w,
+                  rule((a << 1) | (loadWords<V>(above + w - 1) >> 63), a,
+                       (a >> 1) | (loadWords<V>(above + w + 1) << 63),
+                       (r << 1) | (loadWords<V>(row + w - 1) >> 63), r,
+                       (r >> 1) | (loadWords<V>(row + w + 1) << 63),
+                       (b << 1) | (loadWords<V>(below + w - 1) >> 63), b,
+                       (b >> 1) | (loadWords<V>(below + w + 1) << 63)));
+}
+
+// Advances words from w while a whole vector fits before end; returns the next word
+template <typename V, typename R>
+__attribute__((always_inline)) inline int interiorLanes(const R& rule, const Word* above, const Word* row,
+                                                        const Word* below, Word* out,
+                                                        int w, int end) {
+    constexpr int lanes = sizeof(V) / sizeof(Word);
+    for (; w + lanes <= end; w += lanes) {
+        storeNextWords<V>(rule, above, row, below, out, w);
+    }
+    return w;
+}
+
+template <typename R>
+__attribute__((target("avx2")))
+void interiorAvx2(const R& rule, const Word* above, const Word* row, const Word* below,
+                  Word* out, int begin, int end) {
+    int w = interiorLanes<Vec4>(rule, above, row, below, out, begin, end);
+    interiorWords(rule, above, row, below, out, w, end);
+}
+
+template <typename R>
+__attribute__((target("avx512f")))
+void interiorAvx512(const R& rule, const Word* above, const Word* row, const Word* below,
+                    Word* out, int begin, int end) {
+    int w = interiorLanes<Vec8>(rule, above, row, below, out, begin, end);
+    w = interiorLanes<Vec4>(rule, above, row, below, out, w, end);
+    interiorWords(rule, above, row, below, out, w, end);
+}
+
+#endif
+
+template <typename R>
+InteriorFn<R> interiorFor(Isa isa) {
+#ifdef LIFE_KERNELS_X86_SIMD
+    switch (isa) {
+        case Isa::Avx512:
+            return interiorAvx512<R>;
+        case Isa::Avx2:
+            return interiorAvx2<R>;
+        case Isa::Scalar:
+            break;
+    }
+#else
+    (void)isa;
+#endif
+    return interiorScalar<R>;
+}
+
+// ==================== Change counting ====================
+
+// Births and deaths of one output word: its flipped bits that are now set or clear
+LIFE_KERNELS_INLINE void countFlips(StepCounts& counts, Word before, Word after) {
+    Word flipped = before ^ after;
+    counts.births += std::popcount(flipped & after);
+    counts.deaths += std::popcount(flipped & before);
+}
+
+// Counts one written row; returns the OR of its flipped bits
+LIFE_KERNELS_INLINE Word countRowWords(const Word* before, const Word* after, int words,
+                                       StepCounts& counts) {
+    // Local sums: the word pointers may alias the counters, which would
+    // force a store per word
+    Word changed = 0;
+    std::int64_t births = 0;
+    std::int64_t deaths = 0;
+    for (int w = 0; w < words; ++w) {
+        Word flipped = before[w] ^ after[w];
+        changed |= flipped;
+        births += std::popcount(flipped & after[w]);
+        deaths += std::popcount(flipped & before[w]);
+    }
+    counts.births += births;
+    counts.deaths += deaths;
+    return changed;
+}
+
+using CountRowFn = Word (*)(const Word* before, const Word* after, int words, StepCounts& counts);
+
+Word countRowScalar(const Word* before, const Word* after, int words, StepCounts& counts) {
+    return countRowWords(before, after, words, counts);
+}
+
+#ifdef LIFE_KERNELS_X86_SIMD
+// AVX2 has no vector popcount, but a byte shuffle looks up each nibble's
+// count, 32 bytes at a time (Mula's method); the byte counts are then
+// summed into 64-bit lanes. Baseline x86-64 has no POPCNT, so the tail
+// words are compiled for the instruction, which every AVX2 CPU has.
+// Set bits of each 64-bit lane of v
+__attribute__((target("avx2"), always_inline)) inline __m256i laneCounts(__m256i v) {
+    const __m256i nibbleCounts = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                  0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibbles = _mm256_set1_epi8(0x0F);
+    __m256i lo = _mm256_shuffle_epi8(nibbleCounts, _mm256_and_si256(v, lowNibbles));
+    __m256i hi = _mm256_shuffle_epi8(nibbleCounts, _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibbles));
+    return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2,popcnt")))
+Word countRowAvx2(const Word* before, const Word* after, int words, StepCounts& counts) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i changed = zero;
+    __m256i births = zero;
+    __m256i deaths = zero;
+    int w = 0;
+    for (; w + 4 <= words; w += 4) {
+        __m256i was = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(before + w));
+        __m256i now = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(after + w));
+        __m256i flipped = _mm256_xor_si256(was, now);
+        changed = _mm256_or_si256(changed, flipped);
+        births = _mm256_add_epi64(births, laneCounts(_mm256_and_si256(flipped, now)));
+        deaths = _mm256_add_epi64(deaths, laneCounts(_mm256_and_si256(flipped, was)));
+    }
+    alignas(32) Word lanes[3][4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[0]), changed);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[1]), births);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[2]), deaths);
+    counts.births += static_cast<std::int64_t>(lanes[1][0] + lanes[1][1] + lanes[1][2] + lanes[1][3]);
+    counts.deaths += static_cast<std::int64_t>(lanes[2][0] + lanes[2][1] + lanes[2][2] + lanes[2][3]);
+    Word tail = countRowWords(before + w, after + w, words - w, counts);
+    return tail | lanes[0][0] | lanes[0][1] | lanes[0][2] | lanes[0][3];
+}
+
+// With VPOPCNTDQ (Ice Lake and later) AVX-512 counts 8 words per instruction
+__attribute__((target("avx512f,avx512vpopcntdq,popcnt")))
+Word countRowAvx512(const Word* before, const Word* after, int words, StepCounts& counts) {
+    __m512i changed = _mm512_setzero_si512();
+    __m512i births = _mm512_setzero_si512();
+    __m512i deaths = _mm512_setzero_si512();
+    int w = 0;
+    for (; w + 8 <= words; w += 8) {
+        __m512i was = _mm512_loadu_si512(before + w);
+        __m512i now = _mm512_loadu_si512(after + w);
+        __m512i flipped = _mm512_xor_si512(was, now);
+        changed = _mm512_or_si512(changed, flipped);
+        births = _mm512_add_epi64(births, _mm512_popcnt_epi64(_mm512_and_si512(flipped, now)));
+        deaths = _mm512_add_epi64(deaths, _mm512_popcnt_epi64(_mm512_and_si512(flipped, was)));
+    }
+    alignas(64) Word lanes[3][8];
+    _mm512_store_si512(lanes[0], births);
+    _mm512_store_si512(lanes[1], deaths);
+    _mm512_store_si512(lanes[2], changed);
+    Word flipped = countRowWords(before + w, after + w, words - w, counts);
+    for (int lane = 0; lane < 8; ++lane) {
+        counts.births += static_cast<std::int64_t>(lanes[0][lane]);
+        counts.deaths += static_cast<std::int64_t>(lanes[1][lane]);
+        flipped |= lanes[2][lane];
+    }
+    return flipped;
+}
+#endif
+
+CountRowFn countRowFor(Isa isa) {
+#ifdef LIFE_KERNELS_X86_SIMD
+    static const bool vectorPopcount = __builtin_cpu_supports("avx512vpopcntdq");
+    if (isa == Isa::Avx512 && vectorPopcount) {
+        return countRowAvx512;
+    }
+    if (isa != Isa::Scalar) {
+        return countRowAvx2;
+    }
+#else
+    (void)isa;
+#endif
+    return countRowScalar;
+}
+
+std::atomic<Isa>& activeIsaSlot() {
+    static std::atomic<Isa> slot(detectIsa());
+    return slot;
+}
+
+} // namespace
+
+bool isSupported(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar:
+            return true;
+#ifdef LIFE_KERNELS_X86_SIMD
+        case Isa::Avx2:
+            return __builtin_cpu_supports("avx2");
+        case Isa::Avx512:
+            return __builtin_cpu_supports("avx512f");
+#else
+        default:
+            return false;
+#endif
+    }
+    return false;
+}
+
+Isa detectIsa() {
+    static const Isa best = isSupported(Isa::Avx512) ? Isa::Avx512
+                          : isSupported(Isa::Avx2)   ? Isa::Avx2
+                                                     : Isa::Scalar;
+    return best;
+}
+
+Isa activeIsa() {
+    return activeIsaSlot().load(std::memory_order_relaxed);
+}
+
+bool setActiveIsa(Isa isa) {
+    if (!isSupported(isa)) {
+        return false;
+    }
+    activeIsaSlot().store(isa, std::memory_order_relaxed);
+    return true;
+}
+
+std::string isaName(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar:
+            return "scalar";
+        case Isa::Avx2:
+            return "avx2";
+        case Isa::Avx512:
+            return "avx512";
+    }
+    return "unknown";
+}
+
+bool selfCheck(std::string* report) {
+    std::ostringstream oss;
+    bool allPassed = true;
+    Isa previous = activeIsa();
+    // Conway's adder, a compile-time specialised rule and the generic table
+    const Rule rules[] = {Rule(), Rule::parse("B36/S23"), Rule::parse("B0245/S1368")};
+
+    for (Isa isa : {Isa::Scalar, Isa::Avx2, Isa::Avx512}) {
+        if (!setActiveIsa(isa)) {
+            oss << isaName(isa) << ": not supported, skipped\n";
+            continue;
+        }
+
+        bool passed = true;
+        std::mt19937 rng(20251201u);
+        for (const Rule& rule : rules) {
+            // Widths chosen so every SIMD kernel also runs its scalar tail
+            for (int cols : {1, 64, 200, 700, 1100}) {
+                for (bool toroidal : {false, true}) {
+                    Grid current(33, cols);
+                    for (Word* word = current.data(); word != current.data() + current.wordCount(); ++word) {
+                        *word = (static_cast<Word>(rng()) << 32) | rng();
+                    }
+                    for (int row = 0; row < current.getRows(); ++row) {
+                        current.rowWords(row)[current.getWordsPerRow() - 1] &= current.lastWordMask();
+                    }
+
+                    Grid next(current.getRows(), cols);
+                    step(current, next, toroidal, rule);
+                    for (int row = 0; row < current.getRows() && passed; ++row) {
+                        for (int col = 0; col < cols; ++col) {
+                            int neighbors = current.countNeighbors(row, col, toroidal);
+                            if (next.getCell(row, col) != rule.nextState(current.getCell(row, col), neighbors)) {
+                                passed = false;
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        oss << isaName(isa) << ": " << (passed ? "ok" : "MISMATCH") << "\n";
+        allPassed = allPassed && passed;
+    }
+
+    setActiveIsa(previous);
+    if (report) {
+        *report = oss.str();
+    }
+    return allPassed;
+}
+
+bool isSpecialized(const Rule& rule) {
+    return withRule(rule, [](const auto& policy) {
+        return !std::is_same_v<std::decay_t<decltype(policy)>, TableRule>;
+    });
+}
+
+namespace {
+
+template <typename R>
+void stepRowWith(const R& rule, InteriorFn<R> interior, const Word* above, const Word* row,
+                 const Word* below, Word* out, int words, int cols, bool toroidal) {
+    int lastBit = (cols - 1) & 63;
+    Word lastMask = lastBit == 63 ? ~Word{0} : ((Word{1} << (lastBit + 1)) - 1);
+
+    out[0] = nextWordAt(rule, above, row, below, 0, words, lastBit, toroidal);
+    if (words > 2) {
+        interior(rule, above, row, below, out, 1, words - 1);
+    }
+    if (words > 1) {
+        out[words - 1] = nextWordAt(rule, above, row, below, words - 1, words, lastBit, toroidal);
+    }
+    out[words - 1] &= lastMask;
+}
+
+// Rows above and below, wrapped on a torus or the grid's zero row past a bounded edge
+inline void neighbourRows(const Grid& grid, int row, bool toroidal,
+                          const Word*& above, const Word*& below) {
+    int rows = grid.getRows();
+    if (toroidal) {
+        above = grid.rowWords(row == 0 ? rows - 1 : row - 1);
+        below = grid.rowWords(row == rows - 1 ? 0 : row + 1);
+    } else {
+        above = row == 0 ? grid.zeroRow() : grid.rowWords(row - 1);
+        below = row == rows - 1 ? grid.zeroRow() : grid.rowWords(row + 1);
+    }
+}
+
+} // namespace
+
+void stepRow(const Word* above, const Word* row, const Word* below, Word* out,
+             int words, int cols, bool toroidal, const Rule& rule) {
+    withRule(rule, [&](const auto& policy) {
+        using Policy = std::decay_t<decltype(policy)>;
+        stepRowWith(policy, interiorFor<Policy>(activeIsa()), above, row, below, out, words, cols, toroidal);
+    });
+}
+
+bool stepTile(const Grid& current, Grid& next, int tileRow, int tileCol, bool toroidal,
+              const Rule& rule, StepCounts* counts) {
+    int words = current.getWordsPerRow();
+    int lastBit = (current.getCols() - 1) & 63;
+    Word mask = tileCol == words - 1 ? current.lastWordMask() : ~Word{0};
+    int rowBegin = tileRow * kTileRows;
+    int rowEnd = std::min(current.getRows(), rowBegin + kTileRows);
+
+    return withRule(rule, [&](const auto& policy) {
+        Word changed = 0;
+        StepCounts tileCounts;
+        for (int row = rowBegin; row < rowEnd; ++row) {
+            const Word* above;
+            const Word* below;
+            neighbourRows(current, row, toroidal, above, below);
+            const Word* middle = current.rowWords(row);
+            Word result = nextWordAt(policy, above, middle, below, tileCol, words, lastBit, toroidal) & mask;
+            changed |= result ^ middle[tileCol];
+            countFlips(tileCounts, middle[tileCol], result);
+            next.rowWords(row)[tileCol] = result;
+        }
+        if (counts) {
+            *counts += tileCounts;
+        }
+        return changed != 0;
+    });
+}
+
+void stepWords(const Grid& current, Grid& next, const std::uint32_t* indices, std::size_t count,
+               bool toroidal, const Rule& rule, StepCounts* counts) {
+    int words = current.getWordsPerRow();
+    int lastBit = (current.getCols() - 1) & 63;
+    Word lastMask = current.lastWordMask();
+
+    withRule(rule, [&](const auto& policy) {
+        StepCounts wordCounts;
+        for (std::size_t i = 0; i < count; ++i) {
+            int row = static_cast<int>(indices[i] / static_cast<std::uint32_t>(words));
+            int w = static_cast<int>(indices[i] % static_cast<std::uint32_t>(words));
+            const Word* above;
+            const Word* below;
+            neighbourRows(current, row, toroidal, above, below);
+            const Word* middle = current.rowWords(row);
+            Word result = nextWordAt(policy, above, middle, below, w, words, lastBit, toroidal);
+            if (w == words - 1) {
+                result &= lastMask;
+            }
+            countFlips(wordCounts, middle[w], result);
+            next.rowWords(row)[w] = result;
+        }
+        if (counts) {
+            *counts += wordCounts;
+        }
+    });
+}
+
+bool stepRows(const Grid& current, Grid& next, int rowBegin, int rowEnd, bool toroidal,
+              const Rule& rule, StepCounts* counts) {
+    int cols = current.getCols();
+    int words = current.getWordsPerRow();
+
+    // The rule and ISA are resolved once per call, not per row
+    return withRule(rule, [&](const auto& policy) {
+        using Policy = std::decay_t<decltype(policy)>;
+        Isa isa = activeIsa();
+        InteriorFn<Policy> interior = interiorFor<Policy>(isa);
+        CountRowFn countRow = countRowFor(isa);
+        Word changed = 0;
+        for (int row = rowBegin; row < rowEnd; ++row) {
+            const Word* above;
+            const Word* below;
+            neighbourRows(current, row, toroidal, above, below);
+            const Word* middle = current.rowWords(row);
+            Word* out = next.rowWords(row);
+            stepRowWith(policy, interior, above, middle, below, out, words, cols, toroidal);
+            // The rows are still hot in L1, so detecting and counting change
+            // here is nearly free
+            if (counts) {
+                changed |= countRow(middle, out, words, *counts);
+            } else {
+                for (int w = 0; w < words; ++w) {
+                    changed |= out[w] ^ middle[w];
+                }
+            }
+        }
+        return changed != 0;
+    });
+}
+
+// ==================== Lookup-table kernel ====================
+
+namespace {
+
+// Conway's table is built by the compiler and lives in read-only data
+constexpr BlockTable kConwayTable = makeBlockTable(counts({3}), counts({2, 3}));
+
+// Row i of the grid, wrapped on a torus or the zero row past a bounded edge
+inline const Word* rowAt(const Grid& grid, int row, bool toroidal) {
+    int rows = grid.getRows();
+    if (row >= 0 && row < rows) {
+        return grid.rowWords(row);
+    }
+    if (toroidal) {
+        return grid.rowWords((row + rows) % rows);
+    }
+    return grid.zeroRow();
+}
+
+// Columns -1..63 of word w as bits 0..64 of lo, plus column 64 as bit 1 of hi
+inline void widenWord(const Word* row, int w, int words, int lastBit, bool toroidal,
+                      Word& lo, Word& hi) {
+    Word word = row[w];
+    Word west = w > 0 ? row[w - 1] >> 63 : (toroidal ? row[words - 1] >> lastBit : 0);
+    Word east = w + 1 < words ? row[w + 1] & 1 : 0;
+    if (w + 1 == words && toroidal) {
+        // The wrapped-in first column sits just past the last one
+        if (lastBit < 63) {
+            word |= (row[0] & 1) << (lastBit + 1);
+        } else {
+            east = row[0] & 1;
+        }
+    }
+    lo = (word << 1) | west;
+    hi = (word >> 63) | (east << 1);
+}
+
+} // namespace
+
+const BlockTable& blockTable(const Rule& rule) {
+    if (rule.isConway()) {
+        return kConwayTable;
+    }
+    // Other rules are tabulated on first use; entries are never evicted, the
+    // same handful of rules is reused for the whole run
+    static std::mutex mutex;
+    static std::map<std::uint32_t, std::unique_ptr<BlockTable>> tables;
+    std::uint32_t key = (static_cast<std::uint32_t>(rule.getBirthMask()) << 16) | rule.getSurvivalMask();
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<BlockTable>& table = tables[key];
+    if (!table) {
+        table = std::make_unique<BlockTable>(makeBlockTable(rule.getBirthMask(), rule.getSurvivalMask()));
+    }
+    return *table;
+}
+
+bool stepRowsLookup(const Grid& current, Grid& next, int rowBegin, int rowEnd, bool toroidal,
+                    const BlockTable& table, StepCounts* counts) {
+    int words = current.getWordsPerRow();
+    int lastBit = (current.getCols() - 1) & 63;
+    Word changed = 0;
+
+    for (int row = rowBegin; row < rowEnd; row += 2) {
+        bool pair = row + 1 < rowEnd;
+        const Word* in[4];
+        for (int i = 0; i < 4; ++i) {
+            in[i] = rowAt(current, row - 1 + i, toroidal);
+        }
+        const Word* middle[2] = {current.rowWords(row), pair ? current.rowWords(row + 1) : nullptr};
+        Word* out[2] = {next.rowWords(row), pair ? next.rowWords(row + 1) : nullptr};
+
+        for (int w = 0; w < words; ++w) {
+            Word lo[4];
+            Word hi[4];
+            for (int i = 0; i < 4; ++i) {
+                widenWord(in[i], w, words, lastBit, toroidal, lo[i], hi[i]);
+            }
+            // Each step consumes two columns; the two spill-over columns
+            // (63 and 64) are shifted in behind the first step
+            Word top = 0;
+            Word bottom = 0;
+            for (int shift = 0; shift < 64; shift += 2) {
+                unsigned index = static_cast<unsigned>(
+                    (lo[0] & 0xF) | ((lo[1] & 0xF) << 4) | ((lo[2] & 0xF) << 8) | ((lo[3] & 0xF) << 12));
+                Word entry = table[index];
+                top |= (entry & 3) << shift;
+                bottom |= (entry >> 2) << shift;
+                for (int i = 0; i < 4; ++i) {
+                    lo[i] = (lo[i] >> 2) | (hi[i] << 62);
+                    hi[i] = 0;
+                }
+            }
+            if (w + 1 == words) {
+                top &= current.lastWordMask();
+                bottom &= current.lastWordMask();
+            }
+            out[0][w] = top;
+            changed |= top ^ middle[0][w];
+            if (pair) {
+                out[1][w] = bottom;
+                changed |= bottom ^ middle[1][w];
+            }
+        }
+    }
+    if (counts) {
+        CountRowFn countRow = countRowFor(activeIsa());
+        for (int row = rowBegin; row < rowEnd; ++row) {
+            countRow(current.rowWords(row), next.rowWords(row), words, *counts);
+        }
+    }
+    return changed != 0;
+}
+
+// ==================== Multi-state kernel ====================
+
+namespace {
+
+template <int B>
+bool stepStateRowsWith(const Grid& alive, Grid& nextAlive, const MultiStateGrid& current,
+                       MultiStateGrid& next, int rowBegin, int rowEnd, StepCounts* counts) {
+    using L = MultiStateGrid::Lanes<B>;
+    const Word lastState = static_cast<Word>(current.getStateCount() - 1);
+    const Word laneMask = (Word{1} << B) - 1;
+    const bool decays = lastState >= 2;  // Two-state rules go straight back to dead
+    int planeWords = alive.getWordsPerRow();
+    Word changed = 0;
+    StepCounts liveCounts;
+
+    for (int row = rowBegin; row < rowEnd; ++row) {
+        const Word* live = alive.rowWords(row);
+        Word* born = nextAlive.rowWords(row);
+        const Word* states = current.rowWords(row);
+        Word* out = next.rowWords(row);
+
+        for (int w = 0; w < planeWords; ++w) {
+            // Dying cells: states 2 and up that were not redrawn as live
+            Word liveLanes[B];
+            Word dyingLanes[B];
+            Word dying = 0;
+            for (int j = 0; j < B; ++j) {
+                Word s = states[w * B + j];
+                liveLanes[j] = L::spread(live[w] >> (j * L::kCells));
+                dyingLanes[j] = L::nonZero(s) & ~L::equal(s, 1) & ~liveLanes[j];
+                dying |= L::gather(dyingLanes[j]) << (j * L::kCells);
+            }
+            Word nextLive = born[w] & ~dying;
+            born[w] = nextLive;
+            countFlips(liveCounts, live[w], nextLive);
+
+            for (int j = 0; j < B; ++j) {
+                Word s = states[w * B + j];
+                Word nextLanes = L::spread(nextLive >> (j * L::kCells));
+                // Live cells that die start decaying at state 2; dying cells
+                // count up and the last state returns to dead
+                Word decayLanes = decays ? liveLanes[j] & ~nextLanes : 0;
+                Word ageLanes = dyingLanes[j] & ~L::equal(s, lastState);
+                Word result = nextLanes | (decayLanes << 1) | ((s + ageLanes) & (ageLanes * laneMask));
+                changed |= result ^ s;
+                out[w * B + j] = result;
+            }
+        }
+    }
+    if (counts) {
+        *counts += liveCounts;
+    }
+    return changed != 0;
+}
+
+} // namespace
+
+bool stepStateRows(const Grid& alive, Grid& nextAlive, const MultiStateGrid& current,
+                   MultiStateGrid& next, int rowBegin, int rowEnd, StepCounts* counts) {
+    switch (current.getBitsPerCell()) {
+        case 2:
+            return stepStateRowsWith<2>(alive, nextAlive, current, next, rowBegin, rowEnd, counts);
+        case 4:
+            return stepStateRowsWith<4>(alive, nextAlive, current, next, rowBegin, rowEnd, counts);
+        default:
+            return stepStateRowsWith<8>(alive, nextAlive, current, next, rowBegin, rowEnd, counts);
+    }
+}
+
+} // namespace LifeKernels
@@ -0,0 +1,133 @@
+#include "MultiStateGrid.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+using Word = MultiStateGrid::Word;
+
+// Calls f with the Lanes helpers for the grid's lane width
+template <typename F>
+decltype(auto) withLanes(int bits, F&& f) {
+    switch (bits) {
+        case 2:
+            return f(MultiStateGrid::Lanes<2>{});
+        case 4:
+            return f(MultiStateGrid::Lanes<4>{});
+        default:
+            return f(MultiStateGrid::Lanes<8>{});
+    }
+}
+
+} // namespace
+
+MultiStateGrid::MultiStateGrid(int rows, int cols, int states)
+    : rows_(rows), cols_(cols), states_(states), bits_(0), wordsPerRow_(0) {
+    if (rows <= 0 || cols <= 0) {
+        throw std::invalid_argument("Grid dimensions must be positive");
+    }
+    if (states < 2 || states > 256) {
+        throw std::invalid_argument("State count must be between 2 and 256");
+    }
+    bits_ = states <= 4 ? 2 : (states <= 16 ? 4 : 8);
+    wordsPerRow_ = (cols + Grid::kWordBits - 1) / Grid::kWordBits * bits_;
+    words_.assign(static_cast<std::size_t>(rows) * wordsPerRow_, 0);
+}
+
+MultiStateGrid::MultiStateGrid(const Grid& grid, int states)
+    : MultiStateGrid(grid.getRows(), grid.getCols(), states) {
+    withLanes(bits_, [&](auto lanes) {
+        using L = decltype(lanes);
+        for (int row = 0; row < rows_; ++row) {
+            const Word* plane = grid.rowWords(row);
+            Word* out = rowWords(row);
+            for (int w = 0; w < wordsPerRow_; ++w) {
+                // One bit per cell out to the low bit of each lane
+                out[w] = L::spread(plane[w / bits_] >> ((w % bits_) * L::kCells));
+            }
+        }
+    });
+}
+
+void MultiStateGrid::checkPosition(int row, int col) const {
+    if (row < 0 || row >= rows_ || col < 0 || col >= cols_) {
+        throw std::out_of_range("Cell position out of bounds");
+    }
+}
+
+int MultiStateGrid::getState(int row, int col) const {
+    checkPosition(row, col);
+    int cellsPerWord = getCellsPerWord();
+    Word word = rowWords(row)[col / cellsPerWord];
+    Word laneMask = (Word{1} << bits_) - 1;
+    return static_cast<int>((word >> ((col % cellsPerWord) * bits_)) & laneMask);
+}
+
+void MultiStateGrid::setState(int row, int col, int state) {
+    checkPosition(row, col);
+    if (state < 0 || state >= states_) {
+        throw std::invalid_argument("Cell state outside the rule's state count");
+    }
+    int cellsPerWord = getCellsPerWord();
+    int shift = (col % cellsPerWord) * bits_;
+    Word laneMask = ((Word{1} << bits_) - 1) << shift;
+    Word& word = rowWords(row)[col / cellsPerWord];
+    word = (word & ~laneMask) | (static_cast<Word>(state) << shift);
+}
+
+void MultiStateGrid::clear() {
+    std::fill(words_.begin(), words_.end(), 0);
+}
+
+// Padding lanes are zero, so whole words can be compared and popcounted
+
+int MultiStateGrid::countLiving() const {
+    return withLanes(bits_, [this](auto lanes) {
+        using L = decltype(lanes);
+        std::int64_t count = 0;
+        for (Word word : words_) {
+            count += std::popcount(L::equal(word, 1));
+        }
+        return static_cast<int>(count);
+    });
+}
+
+int MultiStateGrid::countNonDead() const {
+    return withLanes(bits_, [this](auto lanes) {
+        using L = decltype(lanes);
+        std::int64_t count = 0;
+        for (Word word : words_) {
+            count += std::popcount(L::nonZero(word));
+        }
+        return static_cast<int>(count);
+    });
+}
+
+Grid MultiStateGrid::toGrid() const {
+    Grid grid(rows_, cols_);
+    withLanes(bits_, [&](auto lanes) {
+        using L = decltype(lanes);
+        constexpr int bits = Grid::kWordBits / L::kCells;
+        int planeWords = grid.getWordsPerRow();
+        for (int row = 0; row < rows_; ++row) {
+            const Word* states = rowWords(row);
+            Word* plane = grid.rowWords(row);
+            for (int w = 0; w < planeWords; ++w) {
+                // Each of the bits state words fills kCells bits of the plane word
+                Word live = 0;
+                for (int j = 0; j < bits; ++j) {
+                    live |= L::gather(L::equal(states[w * bits + j], 1)) << (j * L::kCells);
+                }
+                plane[w] = live;
+            }
+        }
+    });
+    return grid;
+}
+
+bool MultiStateGrid::operator==(const MultiStateGrid& other) const {
+    return rows_ == other.rows_ && cols_ == other.cols_ && states_ == other.states_ &&
+           words_ == other.words_;
+}
@@ -0,0 +1,352 @@
+#include "PatternCensus.hpp"
+#include "LifeKernels.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+// Live cells [begin, end) of one row
+struct Run {
+    int row;
+    int begin;
+    int end;
+};
+
+// Appends the runs of rows [rowBegin, rowEnd), joining runs that cross words
+void collectRuns(const Grid& grid, int rowBegin, int rowEnd, std::vector<Run>& runs) {
+    int words = grid.getWordsPerRow();
+    for (int row = rowBegin; row < rowEnd; ++row) {
+        const Grid::Word* rowWords = grid.rowWords(row);
+        bool open = false;
+        Run current{row, 0, 0};
+        for (int w = 0; w < words; ++w) {
+            Grid::Word bits = rowWords[w];
+            int base = w * Grid::kWordBits;
+            while (bits) {
+                int first = std::countr_zero(bits);
+                int length = std::countr_one(bits >> first);
+                int begin = base + first;
+                if (open && begin == current.end) {
+                    current.end += length;
+                } else {
+                    if (open) {
+                        runs.push_back(current);
+                    }
+                    current = {row, begin, begin + length};
+                    open = true;
+                }
+                if (first + length >= Grid::kWordBits) {
+                    break;
+                }
+                bits &= ~((Grid::Word(1) << (first + length)) - 1);
+            }
+        }
+        if (open) {
+            runs.push_back(current);
+        }
+    }
+}
+
+// Union-find over run indices in which a parent never has a larger index
+// than its child, so one forward pass resolves every run to its root
+std::uint32_t findRoot(std::vector<std::uint32_t>& parent, std::uint32_t x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+void unite(std::vector<std::uint32_t>& parent, std::uint32_t a, std::uint32_t b) {
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a < b) {
+        parent[b] = a;
+    } else if (b < a) {
+        parent[a] = b;
+    }
+}
+
+// Joins the runs of two rows that have cells within 2 columns of each other
+void uniteRows(std::vector<std::uint32_t>& parent, const std::vector<Run>& runs,
+               std::uint32_t above, std::uint32_t aboveEnd, std::uint32_t below, std::uint32_t belowEnd) {
+    while (above < aboveEnd && below < belowEnd) {
+        const Run& a = runs[above];
+        const Run& b = runs[below];
+        if (a.begin <= b.end + 1 && b.begin <= a.end + 1) {
+            unite(parent, above, below);
+        }
+        if (a.end < b.end) {
+            ++above;
+        } else {
+            ++below;
+        }
+    }
+}
+
+// Joins neighbouring runs of one row separated by a single dead cell
+void uniteWithinRow(std::vector<std::uint32_t>& parent, const std::vector<Run>& runs,
+                    std::uint32_t first, std::uint32_t end) {
+    for (std::uint32_t i = first + 1; i < end; ++i) {
+        if (runs[i].begin - runs[i - 1].end == 1) {
+            unite(parent, i - 1, i);
+        }
+    }
+}
+
+// Murmur3's 64-bit finaliser
+std::uint64_t mix(std::uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+std::uint64_t cellTerm(int row, int col) {
+    return mix((static_cast<std::uint64_t>(row) << 32) | static_cast<std::uint32_t>(col));
+}
+
+} // namespace
+
+std::int64_t Census::count(const std::string& key) const {
+    for (const auto& entry : counts) {
+        if (entry.first == key) {
+            return entry.second;
+        }
+    }
+    return 0;
+}
+
+std::string Census::summary() const {
+    std::string text;
+    for (const auto& [name, count] : counts) {
+        if (!text.empty()) {
+            text += ", ";
+        }
+        text += std::to_string(count) + " ";
+        if (count == 1 || name == "unknown" || name.back() == 's') {
+            text += name;
+        } else if (name.back() == 'f') {
+            text += name.substr(0, name.size() - 1) + "ves";  // loaf -> loaves
+        } else {
+            text += name + "s";
+        }
+    }
+    return text.empty() ? "empty" : text;
+}
+
+PatternCensus::PatternCensus(const PatternLibrary& library, int threads) {
+    int resolved = ThreadPool::resolveThreadCount(threads);
+    if (resolved > 1) {
+        pool_ = std::make_unique<ThreadPool>(resolved);
+    }
+    for (const std::string& name : library.getPatternNames()) {
+        learn(library, name);
+    }
+}
+
+PatternCensus::~PatternCensus() = default;
+
+template <typename Task>
+void PatternCensus::forEach(int count, const Task& task) const {
+    if (pool_) {
+        pool_->parallelFor(count, task);
+    } else {
+        for (int i = 0; i < count; ++i) {
+            task(i);
+        }
+    }
+}
+
+void PatternCensus::learn(const PatternLibrary& library, const std::string& name) {
+    const PatternLibrary::Pattern pattern = library.getPattern(name);
+    // Room for a c/2 ship to travel for kMaxPhases generations
+    const int margin = kMaxPhases / 2 + 2;
+    Grid grid(pattern.height + 2 * margin, pattern.width + 2 * margin);
+    library.insertPattern(grid, name, margin, margin);
+    Grid next(grid.getRows(), grid.getCols());
+
+    std::vector<ShapeKey> start = islandKeys(grid);
+    if (start.size() != 1) {
+        return;  // Not a single island, so never matched as a whole
+    }
+
+    // Oscillators and spaceships contribute every phase, once the pattern
+    // comes back to its starting shape; anything else only its drawn shape
+    std::vector<ShapeKey> phases = start;
+    for (int gen = 1; gen <= kMaxPhases; ++gen) {
+        LifeKernels::step(grid, next, false);
+        std::swap(grid, next);
+        std::vector<ShapeKey> keys = islandKeys(grid);
+        if (keys.size() != 1) {
+            phases.resize(1);
+            break;
+        }
+        if (keys[0] == start[0]) {
+            break;
+        }
+        phases.push_back(keys[0]);
+        if (gen == kMaxPhases) {
+            phases.resize(1);
+        }
+    }
+
+    int index = static_cast<int>(names_.size());
+    names_.push_back(name);
+    for (const ShapeKey& key : phases) {
+        known_.emplace(key, index);
+    }
+}
+
+std::vector<PatternCensus::ShapeKey> PatternCensus::islandKeys(const Grid& grid) const {
+    int rows = grid.getRows();
+    int threads = getThreadCount();
+    int bandCount = std::max(1, std::min(rows, threads * 4));
+    int bandRows = (rows + bandCount - 1) / bandCount;
+    bandCount = (rows + bandRows - 1) / bandRows;
+
+    // Runs of each band, then concatenated in row order
+    std::vector<std::vector<Run>> bandRuns(bandCount);
+    forEach(bandCount, [&](int band) {
+        collectRuns(grid, band * bandRows, std::min(rows, (band + 1) * bandRows), bandRuns[band]);
+    });
+    std::size_t total = 0;
+    for (const auto& band : bandRuns) {
+        total += band.size();
+    }
+    std::vector<Run> runs;
+    runs.reserve(total);
+    for (auto& band : bandRuns) {
+        runs.insert(runs.end(), band.begin(), band.end());
+        std::vector<Run>().swap(band);
+    }
+    std::uint32_t runCount = static_cast<std::uint32_t>(runs.size());
+
+    // First run of each row (rowStart[rows] == runCount)
+    std::vector<std::uint32_t> rowStart(rows + 1, runCount);
+    for (std::uint32_t i = runCount; i-- > 0;) {
+        rowStart[runs[i].row] = i;
+    }
+    for (int row = rows - 1; row >= 0; --row) {
+        rowStart[row] = std::min(rowStart[row], rowStart[row + 1]);
+    }
+
+    // Each row joins itself and the two rows above. Bands only touch the
+    // parents of their own runs; pairs across a seam are joined after
+    std::vector<std::uint32_t> parent(runCount);
+    for (std::uint32_t i = 0; i < runCount; ++i) {
+        parent[i] = i;
+    }
+    auto uniteRowPair = [&](int row, int above) {
+        uniteRows(parent, runs, rowStart[above], rowStart[above + 1], rowStart[row], rowStart[row + 1]);
+    };
+    forEach(bandCount, [&](int band) {
+        int rowBegin = band * bandRows;
+        int rowEnd = std::min(rows, rowBegin + bandRows);
+        for (int row = rowBegin; row < rowEnd; ++row) {
+            uniteWithinRow(parent, runs, rowStart[row], rowStart[row + 1]);
+            for (int above = std::max(rowBegin, row - 2); above < row; ++above) {
+                uniteRowPair(row, above);
+            }
+        }
+    });
+    for (int band = 1; band < bandCount; ++band) {
+        int seam = band * bandRows;
+        for (int row = seam; row < std::min(rows, seam + 2); ++row) {
+            for (int above = std::max(0, row - 2); above < seam; ++above) {
+                uniteRowPair(row, above);
+            }
+        }
+    }
+
+    // Resolve roots, number the islands and group their runs
+    std::vector<std::uint32_t> islandOf(runCount);
+    std::uint32_t islandCount = 0;
+    for (std::uint32_t i = 0; i < runCount; ++i) {
+        parent[i] = parent[parent[i]];
+        islandOf[i] = parent[i] == i ? islandCount++ : islandOf[parent[i]];
+    }
+    std::vector<std::uint32_t> islandStart(islandCount + 1, 0);
+    for (std::uint32_t i = 0; i < runCount; ++i) {
+        ++islandStart[islandOf[i] + 1];
+    }
+    for (std::uint32_t island = 0; island < islandCount; ++island) {
+        islandStart[island + 1] += islandStart[island];
+    }
+    std::vector<std::uint32_t> order(runCount);
+    {
+        std::vector<std::uint32_t> fill(islandStart.begin(), islandStart.end() - 1);
+        for (std::uint32_t i = 0; i < runCount; ++i) {
+            order[fill[islandOf[i]]++] = i;
+        }
+    }
+
+    std::vector<ShapeKey> keys(islandCount);
+    const std::uint32_t chunkIslands = 1024;
+    int chunks = static_cast<int>((islandCount + chunkIslands - 1) / chunkIslands);
+    forEach(chunks, [&](int chunk) {
+        std::uint32_t end = std::min(islandCount, (static_cast<std::uint32_t>(chunk) + 1) * chunkIslands);
+        for (std::uint32_t island = chunk * chunkIslands; island < end; ++island) {
+            const std::uint32_t* first = order.data() + islandStart[island];
+            const std::uint32_t* last = order.data() + islandStart[island + 1];
+            int top = runs[*first].row;  // Runs are in row order
+            int bottom = runs[*(last - 1)].row;
+            int left = runs[*first].begin;
+            int right = runs[*first].end;
+            std::int64_t population = 0;
+            for (const std::uint32_t* it = first; it != last; ++it) {
+                left = std::min(left, runs[*it].begin);
+                right = std::max(right, runs[*it].end);
+                population += runs[*it].end - runs[*it].begin;
+            }
+            int h = bottom - top + 1;
+            int w = right - left;
+
+            // Hash sums under the 8 symmetries: identity, mirrors, half
+            // turn, then the same four transposed
+            std::uint64_t sums[8] = {};
+            for (const std::uint32_t* it = first; it != last; ++it) {
+                int r = runs[*it].row - top;
+                int rr = h - 1 - r;
+                for (int c = runs[*it].begin - left; c < runs[*it].end - left; ++c) {
+                    int cc = w - 1 - c;
+                    sums[0] += cellTerm(r, c);
+                    sums[1] += cellTerm(r, cc);
+                    sums[2] += cellTerm(rr, c);
+                    sums[3] += cellTerm(rr, cc);
+                    sums[4] += cellTerm(c, r);
+                    sums[5] += cellTerm(c, rr);
+                    sums[6] += cellTerm(cc, r);
+                    sums[7] += cellTerm(cc, rr);
+                }
+            }
+            // The smaller dimension goes first; a square island picks from all 8
+            const std::uint64_t* begin = h < w ? sums : (h > w ? sums + 4 : sums);
+            const std::uint64_t* finish = h == w ? sums + 8 : begin + 4;
+            keys[island] = {std::min(h, w), std::max(h, w), population, *std::min_element(begin, finish)};
+        }
+    });
+    return keys;
+}
+
+Census PatternCensus::take(const Grid& grid) const {
+    std::vector<ShapeKey> keys = islandKeys(grid);
+    std::vector<std::int64_t> tally(names_.size() + 1, 0);  // Last slot: unknown
+    for (const ShapeKey& key : keys) {
+        auto it = known_.find(key);
+        ++tally[it == known_.end() ? names_.size() : static_cast<std::size_t>(it->second)];
+    }
+
+    Census census;
+    census.islands = static_cast<std::int64_t>(keys.size());
+    for (std::size_t i = 0; i < tally.size(); ++i) {
+        if (tally[i] > 0) {
+            census.counts.emplace_back(i < names_.size() ? names_[i] : "unknown", tally[i]);
+        }
+    }
+    std::stable_sort(census.counts.begin(), census.counts.end(),
+                     [](const auto& a, const auto& b) { return a.second > b.second; });
+    return census;
+}
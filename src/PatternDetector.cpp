@@ -1,80 +1,341 @@
 #include "PatternDetector.hpp"
-#include <sstream>
 #include <algorithm>
+#include <bit>
+
+namespace {
+
+// Odd bases, so every power has an inverse mod 2^64
+constexpr std::uint64_t kRowBaseLow = 0x9E3779B97F4A7C15ull;
+constexpr std::uint64_t kRowBaseHigh = 0xC2B2AE3D27D4EB4Full;
+constexpr std::uint64_t kColBaseLow = 0x165667B19E3779F9ull;
+constexpr std::uint64_t kColBaseHigh = 0xD6E8FEB86659FD93ull;
+
+// Newton's iteration doubles the correct low bits: 3, 6, 12, 24, 48, 96
+constexpr std::uint64_t inverse(std::uint64_t odd) {
+    std::uint64_t inv = odd;
+    for (int i = 0; i < 5; ++i) {
+        inv *= 2 - odd * inv;
+    }
+    return inv;
+}
+
+constexpr std::uint64_t power(std::uint64_t base, int exponent) {
+    std::uint64_t result = 1;
+    while (exponent > 0) {
+        if (exponent & 1) {
+            result *= base;
+        }
+        base *= base;
+        exponent >>= 1;
+    }
+    return result;
+}
+
+static_assert(kRowBaseLow * inverse(kRowBaseLow) == 1);
+
+void fillPowers(std::vector<GridHash>& powers, int count, std::uint64_t low, std::uint64_t high) {
+    powers.resize(count);
+    GridHash value{1, 1};
+    for (GridHash& entry : powers) {
+        entry = value;
+        value.low *= low;
+        value.high *= high;
+    }
+}
+
+// Shortest displacement around a torus of the given size
+int wrapDisplacement(int delta, int size) {
+    delta %= size;
+    if (delta > size / 2) {
+        delta -= size;
+    } else if (delta < -size / 2) {
+        delta += size;
+    }
+    return delta;
+}
+
+} // namespace
 
 PatternDetector::PatternDetector()
     : currentPattern_(PatternType::UNKNOWN),
       oscillatorPeriod_(0),
       stableGenerations_(0),
+      spaceshipDx_(0),
+      spaceshipDy_(0),
+      seenStates_(kTableSlots),
+      seenShapes_(kTableSlots),
+      seenCount_(0),
+      shapeCount_(0),
+      shapeGeneration_(-1),
+      top_(0),
+      bottom_(-1),
+      left_(0),
+      right_(-1),
+      toroidal_(false),
+      verifyMatches_(false),
       lastPopulation_(0),
       samePopulationCount_(0) {
 }
 
-void PatternDetector::update(const Grid& grid, int generation) {
-    std::string gridState = gridToString(grid);
-    
-    // Count current population
-    int population = 0;
-    for (int r = 0; r < grid.getRows(); ++r) {
-        for (int c = 0; c < grid.getCols(); ++c) {
-            if (grid.getCell(r, c)) population++;
-        }
+void PatternDetector::update(const Grid& grid, int generation, bool toroidal) {
+    toroidal_ = toroidal;
+    rebuildShape(grid, generation);
+    update(grid, generation, grid.countLiving(), GridHash::of(grid));
+}
+
+void PatternDetector::update(const GameEngine& engine) {
+    toroidal_ = engine.isToroidal();
+    trackShape(engine);
+    int population = engine.getPopulation();
+    if (engine.isStable() && population > 0) {
+        // Nothing flipped: a still life, no need to look the state up
+        currentPattern_ = PatternType::STILL_LIFE;
+        oscillatorPeriod_ = 0;
+        stableGenerations_++;
+        samePopulationCount_++;
+        lastPopulation_ = population;
+        return;
     }
-    
+    update(engine.getCurrentGrid(), engine.getGeneration(), population, engine.getStateHash());
+}
+
+void PatternDetector::update(const Grid& grid, int generation, int population, const GridHash& hash) {
     // Check for extinction
     if (population == 0) {
         currentPattern_ = PatternType::EXTINCT;
+        lastPopulation_ = 0;
         return;
     }
     
     // Track population changes
-    if (population == lastPopulation_) {
+    int previousPopulation = lastPopulation_;
+    if (population == previousPopulation) {
         samePopulationCount_++;
     } else {
         samePopulationCount_ = 0;
     }
     lastPopulation_ = population;
     
-    // Add to history (keep last 100 states)
-    gridHistory_.push_back(gridState);
-    if (gridHistory_.size() > 100) {
-        gridHistory_.erase(gridHistory_.begin());
+    // Check if we've seen this state before
+    SeenState& slot = findSlot(seenStates_, hash);
+    bool seen = slot.generation >= 0;
+    if (seen && verifyMatches_ && !sameAsRecent(grid, slot.generation)) {
+        // Hash collision: the newer state takes over the slot
+        seen = false;
+        slot.generation = generation;
     }
     
-    // Check if we've seen this state before
-    if (gridStates_.find(gridState) != gridStates_.end()) {
+    // ... or the same shape somewhere else
+    GridHash key = shapeKey();
+    SeenState& shape = findSlot(seenShapes_, key);
+    int shapePeriod = 0;
+    if (shape.generation >= 0) {
+        shapePeriod = generation - shape.generation;
+    } else {
+        shape.hash = key;
+        ++shapeCount_;
+    }
+    int dx = left_ - shape.left;
+    int dy = top_ - shape.top;
+    if (toroidal_) {
+        dx = wrapDisplacement(dx, static_cast<int>(colCounts_.size()));
+        dy = wrapDisplacement(dy, static_cast<int>(rowCounts_.size()));
+    }
+    shape.generation = generation;
+    shape.top = top_;
+    shape.left = left_;
+    
+    if (!seen && slot.generation < 0) {
+        slot = {hash, generation};
+        ++seenCount_;
+    }
+    
+    if (seen) {
         // We found a repeating pattern!
-        int lastSeen = gridStates_[gridState];
-        int period = generation - lastSeen;
+        int period = generation - slot.generation;
+        slot.generation = generation;  // Measure the next period from here
         
         if (period == 0 || period == 1) {
             // Still life (never changes)
             currentPattern_ = PatternType::STILL_LIFE;
             oscillatorPeriod_ = 0;
             stableGenerations_++;
-        } else if (period > 1 && period <= 30) {
+        } else if (period > 1 && period <= kMaxPeriod) {
             // Oscillator (repeating pattern)
             currentPattern_ = PatternType::OSCILLATOR;
             oscillatorPeriod_ = period;
             stableGenerations_++;
         }
+    } else if (shapePeriod > 0 && shapePeriod <= kMaxPeriod && (dx != 0 || dy != 0)) {
+        // Same cells, moved: a spaceship
+        currentPattern_ = PatternType::SPACESHIP;
+        oscillatorPeriod_ = shapePeriod;
+        spaceshipDx_ = dx;
+        spaceshipDy_ = dy;
     } else {
-        gridStates_[gridState] = generation;
-        
         // Not repeating yet, check if growing/shrinking
         if (samePopulationCount_ < 3) {
-            if (population > lastPopulation_) {
+            if (population > previousPopulation) {
                 currentPattern_ = PatternType::GROWING;
-            } else if (population < lastPopulation_) {
+            } else if (population < previousPopulation) {
                 currentPattern_ = PatternType::SHRINKING;
             }
         }
     }
     
-    // Clear old states to prevent memory issues
-    if (gridStates_.size() > 1000) {
-        gridStates_.clear();
+    if (verifyMatches_) {
+        remember(grid, generation);
+    }
+    
+    // Start over before probe sequences get long
+    if (seenCount_ > kTableSlots / 2 || shapeCount_ > kTableSlots / 2) {
+        clearSeenStates();
+    }
+}
+
+void PatternDetector::trackShape(const GameEngine& engine) {
+    const Grid& grid = engine.getCurrentGrid();
+    int generation = engine.getGeneration();
+    bool sameShape = rowCounts_.size() == static_cast<std::size_t>(grid.getRows()) &&
+                     colCounts_.size() == static_cast<std::size_t>(grid.getCols());
+    if (!engine.hasCompleteChanges() || !sameShape || shapeGeneration_ != generation - 1) {
+        rebuildShape(grid, generation);
+        return;
+    }
+    for (const GameEngine::CellChange& change : engine.getChanges()) {
+        flipShapeCell(change.row, change.col, change.alive);
     }
+    tightenBounds();
+    shapeGeneration_ = generation;
+}
+
+void PatternDetector::rebuildShape(const Grid& grid, int generation) {
+    int rows = grid.getRows();
+    int cols = grid.getCols();
+    if (rowPowers_.size() != static_cast<std::size_t>(rows)) {
+        fillPowers(rowPowers_, rows, kRowBaseLow, kRowBaseHigh);
+    }
+    if (colPowers_.size() != static_cast<std::size_t>(cols)) {
+        fillPowers(colPowers_, cols, kColBaseLow, kColBaseHigh);
+    }
+    rowCounts_.assign(rows, 0);
+    colCounts_.assign(cols, 0);
+    shapeSum_ = GridHash{};
+    top_ = rows;
+    bottom_ = -1;
+    left_ = cols;
+    right_ = -1;
+    
+    // Visits set bits only, so sparse grids cost one pass over the words
+    int words = grid.getWordsPerRow();
+    for (int row = 0; row < rows; ++row) {
+        const Grid::Word* rowWords = grid.rowWords(row);
+        for (int w = 0; w < words; ++w) {
+            for (Grid::Word bits = rowWords[w]; bits; bits &= bits - 1) {
+                flipShapeCell(row, w * Grid::kWordBits + std::countr_zero(bits), true);
+            }
+        }
+    }
+    tightenBounds();
+    shapeGeneration_ = generation;
+}
+
+void PatternDetector::flipShapeCell(int row, int col, bool alive) {
+    const GridHash& rowPower = rowPowers_[row];
+    const GridHash& colPower = colPowers_[col];
+    std::uint64_t low = rowPower.low * colPower.low;
+    std::uint64_t high = rowPower.high * colPower.high;
+    if (alive) {
+        shapeSum_.low += low;
+        shapeSum_.high += high;
+        ++rowCounts_[row];
+        ++colCounts_[col];
+        top_ = std::min(top_, row);
+        bottom_ = std::max(bottom_, row);
+        left_ = std::min(left_, col);
+        right_ = std::max(right_, col);
+    } else {
+        // Bounds are pulled in by tightenBounds() once all flips are applied
+        shapeSum_.low -= low;
+        shapeSum_.high -= high;
+        --rowCounts_[row];
+        --colCounts_[col];
+    }
+}
+
+void PatternDetector::tightenBounds() {
+    while (top_ <= bottom_ && rowCounts_[top_] == 0) {
+        ++top_;
+    }
+    while (bottom_ >= top_ && rowCounts_[bottom_] == 0) {
+        --bottom_;
+    }
+    while (left_ <= right_ && colCounts_[left_] == 0) {
+        ++left_;
+    }
+    while (right_ >= left_ && colCounts_[right_] == 0) {
+        --right_;
+    }
+}
+
+GridHash PatternDetector::shapeKey() const {
+    static constexpr std::uint64_t rowInverseLow = inverse(kRowBaseLow);
+    static constexpr std::uint64_t rowInverseHigh = inverse(kRowBaseHigh);
+    static constexpr std::uint64_t colInverseLow = inverse(kColBaseLow);
+    static constexpr std::uint64_t colInverseHigh = inverse(kColBaseHigh);
+    
+    // Moving every cell by (dy, dx) multiplies the sum by A^dy * B^dx, so
+    // dividing by the corner's powers leaves a position-free value
+    GridHash key;
+    key.low = shapeSum_.low * power(rowInverseLow, top_) * power(colInverseLow, left_);
+    key.high = shapeSum_.high * power(rowInverseHigh, top_) * power(colInverseHigh, left_);
+    key.high ^= (static_cast<std::uint64_t>(bottom_ - top_) << 32) ^
+                static_cast<std::uint32_t>(right_ - left_);
+    return key;
+}
+
+void PatternDetector::setVerifyMatches(bool verify) {
+    verifyMatches_ = verify;
+    if (verify) {
+        recentGrids_.resize(kMaxPeriod + 1);
+        recentGenerations_.assign(kMaxPeriod + 1, -1);
+    } else {
+        recentGrids_.clear();
+        recentGenerations_.clear();
+    }
+}
+
+PatternDetector::SeenState& PatternDetector::findSlot(std::vector<SeenState>& table, const GridHash& hash) {
+    std::size_t index = hash.low & (kTableSlots - 1);
+    while (table[index].generation >= 0 && !(table[index].hash == hash)) {
+        index = (index + 1) & (kTableSlots - 1);
+    }
+    return table[index];
+}
+
+bool PatternDetector::sameAsRecent(const Grid& grid, int generation) const {
+    std::size_t index = static_cast<std::size_t>(generation) % recentGrids_.size();
+    if (recentGenerations_[index] != generation) {
+        return true;  // Too old to check; periods that long are not reported
+    }
+    return *recentGrids_[index] == grid;
+}
+
+void PatternDetector::remember(const Grid& grid, int generation) {
+    std::size_t index = static_cast<std::size_t>(generation) % recentGrids_.size();
+    if (recentGrids_[index]) {
+        *recentGrids_[index] = grid;  // Same shape: reuses the word buffer
+    } else {
+        recentGrids_[index] = std::make_unique<Grid>(grid);
+    }
+    recentGenerations_[index] = generation;
+}
+
+void PatternDetector::clearSeenStates() {
+    std::fill(seenStates_.begin(), seenStates_.end(), SeenState{});
+    std::fill(seenShapes_.begin(), seenShapes_.end(), SeenState{});
+    seenCount_ = 0;
+    shapeCount_ = 0;
 }
 
 std::string PatternDetector::getPatternName() const {
@@ -84,7 +345,7 @@ std::string PatternDetector::getPatternName() const {
         case PatternType::OSCILLATOR:
             return "Oscillator (Period " + std::to_string(oscillatorPeriod_) + ")";
         case PatternType::SPACESHIP:
-            return "Spaceship";
+            return "Spaceship (Period " + std::to_string(oscillatorPeriod_) + ")";
         case PatternType::GROWING:
             return "Growing";
         case PatternType::SHRINKING:
@@ -103,7 +364,8 @@ std::string PatternDetector::getPatternDescription() const {
         case PatternType::OSCILLATOR:
             return "Pattern repeats every " + std::to_string(oscillatorPeriod_) + " generations";
         case PatternType::SPACESHIP:
-            return "Pattern moving across grid";
+            return "Pattern moves (" + std::to_string(spaceshipDx_) + ", " + std::to_string(spaceshipDy_) +
+                   ") cells every " + std::to_string(oscillatorPeriod_) + " generations";
         case PatternType::GROWING:
             return "Population is increasing";
         case PatternType::SHRINKING:
@@ -124,18 +386,11 @@ void PatternDetector::reset() {
     currentPattern_ = PatternType::UNKNOWN;
     oscillatorPeriod_ = 0;
     stableGenerations_ = 0;
-    gridHistory_.clear();
-    gridStates_.clear();
+    spaceshipDx_ = 0;
+    spaceshipDy_ = 0;
+    clearSeenStates();
+    shapeGeneration_ = -1;
+    std::fill(recentGenerations_.begin(), recentGenerations_.end(), -1);
     lastPopulation_ = 0;
     samePopulationCount_ = 0;
 }
-
-std::string PatternDetector::gridToString(const Grid& grid) const {
-    std::ostringstream oss;
-    for (int r = 0; r < grid.getRows(); ++r) {
-        for (int c = 0; c < grid.getCols(); ++c) {
-            oss << (grid.getCell(r, c) ? '1' : '0');
-        }
-    }
-    return oss.str();
-}
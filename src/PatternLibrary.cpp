@@ -91,6 +91,40 @@ void PatternLibrary::initializePatterns() {
          {0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,1,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0},
          {0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0},
          {0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}});
+    
+    // 11-16. The commonest still lifes after the block, so censuses of
+    // random soups name most of what settles
+    addPattern("beehive", "Beehive", "Six-cell still life, the most common after the block",
+        {{0, 1, 1, 0},
+         {1, 0, 0, 1},
+         {0, 1, 1, 0}});
+    
+    addPattern("loaf", "Loaf", "Seven-cell still life",
+        {{0, 1, 1, 0},
+         {1, 0, 0, 1},
+         {0, 1, 0, 1},
+         {0, 0, 1, 0}});
+    
+    addPattern("boat", "Boat", "Five-cell still life",
+        {{1, 1, 0},
+         {1, 0, 1},
+         {0, 1, 0}});
+    
+    addPattern("ship", "Ship", "Six-cell still life",
+        {{1, 1, 0},
+         {1, 0, 1},
+         {0, 1, 1}});
+    
+    addPattern("tub", "Tub", "Four-cell still life",
+        {{0, 1, 0},
+         {1, 0, 1},
+         {0, 1, 0}});
+    
+    addPattern("pond", "Pond", "Eight-cell still life",
+        {{0, 1, 1, 0},
+         {1, 0, 0, 1},
+         {1, 0, 0, 1},
+         {0, 1, 1, 0}});
 }
 
 PatternLibrary::Pattern PatternLibrary::getPattern(const std::string& name) const {
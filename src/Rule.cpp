@@ -0,0 +1,144 @@
+#include "Rule.hpp"
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+constexpr std::uint16_t kCountMask = 0x1FF;  // Neighbour counts 0..8
+constexpr int kMaxStates = 256;              // One byte per cell in MultiStateGrid
+
+struct NamedRule {
+    const char* name;
+    const char* notation;
+};
+
+const NamedRule kNamedRules[] = {
+    {"conway", "B3/S23"},
+    {"life", "B3/S23"},
+    {"highlife", "B36/S23"},
+    {"daynight", "B3678/S34678"},
+    {"seeds", "B2/S"},
+    {"lifewithoutdeath", "B3/S012345678"},
+    {"maze", "B3/S12345"},
+    {"replicator", "B1357/S1357"},
+    {"2x2", "B36/S125"},
+    {"diamoeba", "B35678/S5678"},
+    {"morley", "B368/S245"},
+    {"briansbrain", "B2/S/C3"},
+    {"starwars", "B2/S345/C4"},
+};
+
+// Digits 0-8 to a count mask; throws on anything else or repeats
+std::uint16_t parseCounts(const std::string& digits, const std::string& text) {
+    std::uint16_t mask = 0;
+    for (char c : digits) {
+        if (c < '0' || c > '8') {
+            throw std::invalid_argument("Invalid neighbour count '" + std::string(1, c) + "' in rule: " + text);
+        }
+        std::uint16_t bit = static_cast<std::uint16_t>(1u << (c - '0'));
+        if (mask & bit) {
+            throw std::invalid_argument("Repeated neighbour count in rule: " + text);
+        }
+        mask |= bit;
+    }
+    return mask;
+}
+
+// Decimal state count, optionally prefixed with 'c'
+int parseStates(std::string digits, const std::string& text) {
+    if (!digits.empty() && digits[0] == 'c') {
+        digits.erase(0, 1);
+    }
+    if (digits.empty() || digits.size() > 3 ||
+        !std::all_of(digits.begin(), digits.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
+        throw std::invalid_argument("Invalid state count in rule: " + text);
+    }
+    return std::stoi(digits);
+}
+
+} // namespace
+
+Rule::Rule() : birth_(1u << 3), survival_((1u << 2) | (1u << 3)), states_(2) {}
+
+Rule::Rule(std::uint16_t birthMask, std::uint16_t survivalMask, int states)
+    : birth_(birthMask), survival_(survivalMask), states_(states) {
+    if ((birthMask | survivalMask) & ~kCountMask) {
+        throw std::invalid_argument("Rule masks only cover neighbour counts 0-8");
+    }
+    if (states < 2 || states > kMaxStates) {
+        throw std::invalid_argument("Rule state count must be between 2 and 256");
+    }
+}
+
+Rule Rule::parse(const std::string& text) {
+    std::string lower;
+    for (char c : text) {
+        if (!std::isspace(static_cast<unsigned char>(c))) {
+            lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+
+    for (const NamedRule& named : kNamedRules) {
+        if (lower == named.name) {
+            return parse(named.notation);
+        }
+    }
+
+    std::size_t slash = lower.find('/');
+    if (slash == std::string::npos) {
+        throw std::invalid_argument("Rule must look like B3/S23: " + text);
+    }
+    std::string first = lower.substr(0, slash);
+    std::string second = lower.substr(slash + 1);
+
+    // Optional third part: the Generations state count
+    int states = 2;
+    std::size_t third = second.find('/');
+    if (third != std::string::npos) {
+        states = parseStates(second.substr(third + 1), text);
+        second.erase(third);
+    }
+
+    // Legacy "23/3" lists survival first, with no letters
+    if ((first.empty() || std::isdigit(static_cast<unsigned char>(first[0]))) &&
+        (second.empty() || std::isdigit(static_cast<unsigned char>(second[0])))) {
+        return Rule(parseCounts(second, text), parseCounts(first, text), states);
+    }
+
+    if (!first.empty() && first[0] == 's') {
+        std::swap(first, second);  // "S23/B3"
+    }
+    if (first.empty() || first[0] != 'b' || second.empty() || second[0] != 's') {
+        throw std::invalid_argument("Rule must look like B3/S23: " + text);
+    }
+    return Rule(parseCounts(first.substr(1), text), parseCounts(second.substr(1), text), states);
+}
+
+std::string Rule::toString() const {
+    std::string text = "B";
+    for (int n = 0; n <= 8; ++n) {
+        if (isBorn(n)) {
+            text += static_cast<char>('0' + n);
+        }
+    }
+    text += "/S";
+    for (int n = 0; n <= 8; ++n) {
+        if (survives(n)) {
+            text += static_cast<char>('0' + n);
+        }
+    }
+    if (isMultiState()) {
+        text += "/C" + std::to_string(states_);
+    }
+    return text;
+}
+
+std::vector<std::string> Rule::namedRules() {
+    std::vector<std::string> names;
+    for (const NamedRule& named : kNamedRules) {
+        names.push_back(named.name);
+    }
+    return names;
+}
@@ -0,0 +1,224 @@
+#include "SoupSearch.hpp"
+#include "PatternDetector.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// splitmix64: a seed gives the same soup on every platform, unlike rand()
+std::uint64_t nextRandom(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Fills in how a soup ended once the detector has seen it die out or repeat
+bool settled(const PatternDetector& detector, SoupResult& result) {
+    using PatternType = PatternDetector::PatternType;
+    PatternType type = detector.getPatternType();
+    if (type == PatternType::EXTINCT) {
+        result.stabilized = true;
+        return true;
+    }
+    if (detector.isStable() || type == PatternType::SPACESHIP) {
+        // The state first repeats here, so the cycle began one period ago
+        result.stabilized = true;
+        result.period = type == PatternType::STILL_LIFE ? 1 : detector.getOscillatorPeriod();
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+SoupSearch::SoupSearch(const SoupSearchOptions& options)
+    : options_(options), census_(PatternLibrary(), 1) {
+    if (options.soups < 0) {
+        throw std::invalid_argument("Soup count cannot be negative");
+    }
+    if (options.soupSize <= 0 || options.boardSize <= 0) {
+        throw std::invalid_argument("Soup and board sizes must be positive");
+    }
+    if (options.soupSize > options.boardSize) {
+        throw std::invalid_argument("Soup must fit on the board");
+    }
+    if (options.density < 0.0 || options.density > 1.0) {
+        throw std::invalid_argument("Soup density must be between 0 and 1");
+    }
+    if (options.maxGenerations < 0) {
+        throw std::invalid_argument("Generation cap cannot be negative");
+    }
+}
+
+Grid SoupSearch::makeSoup(std::uint64_t seed) const {
+    Grid grid(options_.boardSize, options_.boardSize);
+    int offset = (options_.boardSize - options_.soupSize) / 2;
+    // Compare against the top 53 bits so density 1.0 fills every cell
+    std::uint64_t threshold = static_cast<std::uint64_t>(options_.density * 9007199254740992.0);
+    std::uint64_t state = seed;
+    for (int row = 0; row < options_.soupSize; ++row) {
+        for (int col = 0; col < options_.soupSize; ++col) {
+            if ((nextRandom(state) >> 11) < threshold) {
+                grid.setCell(offset + row, offset + col, true);
+            }
+        }
+    }
+    return grid;
+}
+
+SoupResult SoupSearch::runSoup(std::uint64_t seed) const {
+    GameEngine engine(makeSoup(seed), options_.toroidal);
+    engine.setBackend(options_.backend);
+    engine.setRule(options_.rule);
+    engine.setChangeTracking(true);  // Keeps the state hash incremental on every backend
+
+    PatternDetector detector;
+    SoupResult result;
+    result.seed = seed;
+    detector.update(engine);
+
+    bool capped = options_.maxGenerations > 0;
+    while (!settled(detector, result)) {
+        if (capped && engine.getGeneration() >= options_.maxGenerations) {
+            break;
+        }
+        engine.step();
+        detector.update(engine);
+    }
+
+    result.lifespan = engine.getGeneration() - result.period;
+    result.population = engine.getPopulation();
+    if (options_.census) {
+        result.census = census_.take(engine.getCurrentGrid());
+    }
+    return result;
+}
+
+SoupSearchResult SoupSearch::run() const {
+    SoupSearchResult result;
+    result.soups.resize(options_.soups);
+    std::vector<std::uint64_t> generations(options_.soups, 0);
+    std::vector<std::string> errors(options_.soups);
+
+    ThreadPool pool(ThreadPool::resolveThreadCount(options_.threads));
+    result.threads = pool.getThreadCount();
+
+    auto start = std::chrono::steady_clock::now();
+    pool.parallelFor(options_.soups, [&](int index) {
+        // Pool tasks must not throw; failures are rethrown after the sweep
+        try {
+            result.soups[index] = runSoup(options_.firstSeed + static_cast<std::uint64_t>(index));
+            generations[index] = result.soups[index].lifespan + result.soups[index].period;
+        } catch (const std::exception& e) {
+            errors[index] = e.what();
+        }
+    });
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (int i = 0; i < options_.soups; ++i) {
+        if (!errors[i].empty()) {
+            throw std::runtime_error("Soup " + std::to_string(options_.firstSeed + i) + " failed: " + errors[i]);
+        }
+        result.generations += generations[i];
+    }
+    return result;
+}
+
+namespace {
+
+// Longest-lived soup first, lowest seed on ties
+std::vector<const SoupResult*> longestLived(const SoupSearchResult& result, std::size_t count) {
+    std::vector<const SoupResult*> order;
+    order.reserve(result.soups.size());
+    for (const SoupResult& soup : result.soups) {
+        order.push_back(&soup);
+    }
+    count = std::min(count, order.size());
+    std::partial_sort(order.begin(), order.begin() + count, order.end(), [](const SoupResult* a, const SoupResult* b) {
+        return a->lifespan != b->lifespan ? a->lifespan > b->lifespan : a->seed < b->seed;
+    });
+    order.resize(count);
+    return order;
+}
+
+} // namespace
+
+std::string SoupSearch::formatText(const SoupSearchResult& result) {
+    std::size_t unsettled = 0;
+    for (const SoupResult& soup : result.soups) {
+        unsettled += soup.stabilized ? 0 : 1;
+    }
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    oss << "Soups:       " << result.soups.size() << " on " << result.threads << " thread(s)";
+    if (unsettled) {
+        oss << ", " << unsettled << " still running at the cap";
+    }
+    oss << "\n";
+    oss << "Generations: " << result.generations << "\n";
+    oss << "Elapsed:     " << result.seconds << " s\n";
+    oss << std::setprecision(1);
+    oss << "Throughput:  " << result.soupsPerSecond() << " soups/s, "
+        << (result.seconds > 0.0 ? result.generations / result.seconds : 0.0) << " gen/s\n";
+    std::vector<const SoupResult*> top = longestLived(result, 10);
+    if (!top.empty()) {
+        oss << "Longest lived:\n";
+    }
+    for (const SoupResult* soup : top) {
+        oss << "  seed " << soup->seed << ": " << soup->lifespan << " generations"
+            << (soup->stabilized ? "" : " (capped)") << ", population " << soup->population;
+        if (!soup->census.counts.empty()) {
+            oss << ", " << soup->census.summary();
+        }
+        oss << "\n";
+    }
+    return oss.str();
+}
+
+std::string SoupSearch::formatJson(const SoupSearchResult& result) {
+    std::ostringstream oss;
+    oss << std::setprecision(6);
+    oss << "{"
+        << "\"soups\": " << result.soups.size() << ", "
+        << "\"threads\": " << result.threads << ", "
+        << "\"generations\": " << result.generations << ", "
+        << "\"seconds\": " << result.seconds << ", "
+        << "\"soups_per_second\": " << result.soupsPerSecond() << ", "
+        << "\"results\": [";
+    for (std::size_t i = 0; i < result.soups.size(); ++i) {
+        const SoupResult& soup = result.soups[i];
+        oss << (i ? ", " : "") << "{"
+            << "\"seed\": " << soup.seed << ", "
+            << "\"lifespan\": " << soup.lifespan << ", "
+            << "\"period\": " << soup.period << ", "
+            << "\"stabilized\": " << (soup.stabilized ? "true" : "false") << ", "
+            << "\"population\": " << soup.population << ", "
+            << "\"census\": {";
+        for (std::size_t j = 0; j < soup.census.counts.size(); ++j) {
+            oss << (j ? ", " : "") << "\"" << soup.census.counts[j].first << "\": " << soup.census.counts[j].second;
+        }
+        oss << "}}";
+    }
+    oss << "]}\n";
+    return oss.str();
+}
+
+std::string SoupSearch::formatCsv(const SoupSearchResult& result) {
+    std::ostringstream oss;
+    oss << "seed,lifespan,period,stabilized,population,islands,census\n";
+    for (const SoupResult& soup : result.soups) {
+        // Census entries are "key=count" joined by ';', quoted as a single field
+        oss << soup.seed << "," << soup.lifespan << "," << soup.period << ","
+            << (soup.stabilized ? 1 : 0) << "," << soup.population << "," << soup.census.islands << ",\"";
+        for (std::size_t j = 0; j < soup.census.counts.size(); ++j) {
+            oss << (j ? ";" : "") << soup.census.counts[j].first << "=" << soup.census.counts[j].second;
+        }
+        oss << "\"\n";
+    }
+    return oss.str();
+}
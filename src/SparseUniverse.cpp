@@ -0,0 +1,251 @@
+#include "SparseUniverse.hpp"
+#include "LifeKernels.hpp"
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+constexpr std::int64_t kChunkLimit = std::int64_t{1} << 31;  // Chunk coordinates fit in int32_t
+constexpr Grid::Word kEastBit = Grid::Word{1} << 63;
+
+} // namespace
+
+SparseUniverse::SparseUniverse() : generation_(0) {}
+
+SparseUniverse::SparseUniverse(const Grid& grid, std::int64_t top, std::int64_t left)
+    : SparseUniverse() {
+    placeGrid(grid, top, left);
+}
+
+// ==================== Chunk addressing ====================
+
+std::uint64_t SparseUniverse::chunkKey(std::int64_t chunkRow, std::int64_t chunkCol) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(chunkRow)) << 32) |
+           static_cast<std::uint32_t>(chunkCol);
+}
+
+std::int64_t SparseUniverse::keyRow(std::uint64_t key) {
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(key >> 32));
+}
+
+std::int64_t SparseUniverse::keyCol(std::uint64_t key) {
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(key));
+}
+
+void SparseUniverse::checkCoordinates(std::int64_t row, std::int64_t col) {
+    if (row < -kCoordinateLimit || row >= kCoordinateLimit ||
+        col < -kCoordinateLimit || col >= kCoordinateLimit) {
+        throw std::out_of_range("Cell coordinates outside the sparse universe");
+    }
+}
+
+const SparseUniverse::Chunk* SparseUniverse::findChunk(std::int64_t chunkRow, std::int64_t chunkCol) const {
+    // Past the edge there are no chunks; chunkKey() would wrap to the far side
+    if (chunkRow < -kChunkLimit || chunkRow >= kChunkLimit || chunkCol < -kChunkLimit || chunkCol >= kChunkLimit) {
+        return nullptr;
+    }
+    auto it = chunks_.find(chunkKey(chunkRow, chunkCol));
+    return it == chunks_.end() ? nullptr : &it->second;
+}
+
+// ==================== Cell access ====================
+
+bool SparseUniverse::getCell(std::int64_t row, std::int64_t col) const {
+    if (row < -kCoordinateLimit || row >= kCoordinateLimit ||
+        col < -kCoordinateLimit || col >= kCoordinateLimit) {
+        return false;
+    }
+    const Chunk* chunk = findChunk(row >> kChunkShift, col >> kChunkShift);
+    return chunk && (((*chunk)[row & (kChunkSize - 1)] >> (col & (kChunkSize - 1))) & 1u);
+}
+
+void SparseUniverse::setCell(std::int64_t row, std::int64_t col, bool alive) {
+    checkCoordinates(row, col);
+    std::uint64_t key = chunkKey(row >> kChunkShift, col >> kChunkShift);
+    Word bit = Word{1} << (col & (kChunkSize - 1));
+    int chunkRow = static_cast<int>(row & (kChunkSize - 1));
+
+    if (alive) {
+        // operator[] value-initializes a new chunk to all dead
+        chunks_[key][chunkRow] |= bit;
+        return;
+    }
+
+    auto it = chunks_.find(key);
+    if (it == chunks_.end()) {
+        return;
+    }
+    it->second[chunkRow] &= ~bit;
+    if (std::all_of(it->second.begin(), it->second.end(), [](Word w) { return w == 0; })) {
+        chunks_.erase(it);
+    }
+}
+
+void SparseUniverse::clear() {
+    chunks_.clear();
+    generation_ = 0;
+}
+
+std::uint64_t SparseUniverse::getPopulation() const {
+    std::uint64_t population = 0;
+    for (const auto& entry : chunks_) {
+        for (Word word : entry.second) {
+            population += std::popcount(word);
+        }
+    }
+    return population;
+}
+
+bool SparseUniverse::getBounds(std::int64_t& top, std::int64_t& left,
+                               std::int64_t& bottom, std::int64_t& right) const {
+    if (chunks_.empty()) {
+        return false;
+    }
+    top = left = std::numeric_limits<std::int64_t>::max();
+    bottom = right = std::numeric_limits<std::int64_t>::min();
+
+    for (const auto& [key, chunk] : chunks_) {
+        std::int64_t baseRow = keyRow(key) * kChunkSize;
+        std::int64_t baseCol = keyCol(key) * kChunkSize;
+        Word columns = 0;
+        for (int row = 0; row < kChunkSize; ++row) {
+            if (chunk[row] != 0) {
+                top = std::min(top, baseRow + row);
+                bottom = std::max(bottom, baseRow + row);
+                columns |= chunk[row];
+            }
+        }
+        left = std::min<std::int64_t>(left, baseCol + std::countr_zero(columns));
+        right = std::max<std::int64_t>(right, baseCol + 63 - std::countl_zero(columns));
+    }
+    return true;
+}
+
+// ==================== Grid conversion ====================
+
+void SparseUniverse::placeGrid(const Grid& grid, std::int64_t top, std::int64_t left) {
+    for (int row = 0; row < grid.getRows(); ++row) {
+        const Word* words = grid.rowWords(row);
+        for (int w = 0; w < grid.getWordsPerRow(); ++w) {
+            for (Word bits = words[w]; bits != 0; bits &= bits - 1) {
+                setCell(top + row, left + w * Grid::kWordBits + std::countr_zero(bits), true);
+            }
+        }
+    }
+}
+
+Grid SparseUniverse::toGrid(int rows, int cols, std::int64_t top, std::int64_t left) const {
+    Grid grid(rows, cols);
+    for (const auto& [key, chunk] : chunks_) {
+        std::int64_t baseRow = keyRow(key) * kChunkSize;
+        std::int64_t baseCol = keyCol(key) * kChunkSize;
+        if (baseRow >= top + rows || baseRow + kChunkSize <= top ||
+            baseCol >= left + cols || baseCol + kChunkSize <= left) {
+            continue;
+        }
+        for (int row = 0; row < kChunkSize; ++row) {
+            std::int64_t gridRow = baseRow + row - top;
+            if (gridRow < 0 || gridRow >= rows) {
+                continue;
+            }
+            for (Word bits = chunk[row]; bits != 0; bits &= bits - 1) {
+                std::int64_t gridCol = baseCol + std::countr_zero(bits) - left;
+                if (gridCol >= 0 && gridCol < cols) {
+                    grid.setCell(static_cast<int>(gridRow), static_cast<int>(gridCol), true);
+                }
+            }
+        }
+    }
+    return grid;
+}
+
+// ==================== Evolution ====================
+
+void SparseUniverse::collectCandidates() {
+    candidates_.clear();
+    for (const auto& [key, chunk] : chunks_) {
+        std::int64_t chunkRow = keyRow(key);
+        std::int64_t chunkCol = keyCol(key);
+        candidates_.push_back(key);
+
+        // A neighbouring chunk can only gain cells next to a live edge cell
+        Word columns = 0;
+        for (Word word : chunk) {
+            columns |= word;
+        }
+        const bool north = chunk[0] != 0;
+        const bool south = chunk[kChunkSize - 1] != 0;
+        const bool west = columns & 1u;
+        const bool east = columns & kEastBit;
+        const bool reach[3][3] = {
+            {(chunk[0] & 1u) != 0, north, (chunk[0] & kEastBit) != 0},
+            {west, false, east},
+            {(chunk[kChunkSize - 1] & 1u) != 0, south, (chunk[kChunkSize - 1] & kEastBit) != 0}};
+
+        for (int dr = -1; dr <= 1; ++dr) {
+            for (int dc = -1; dc <= 1; ++dc) {
+                std::int64_t row = chunkRow + dr;
+                std::int64_t col = chunkCol + dc;
+                // Births past the coordinate limit are clipped
+                if (reach[dr + 1][dc + 1] && row >= -kChunkLimit && row < kChunkLimit &&
+                    col >= -kChunkLimit && col < kChunkLimit) {
+                    candidates_.push_back(chunkKey(row, col));
+                }
+            }
+        }
+    }
+    std::sort(candidates_.begin(), candidates_.end());
+    candidates_.erase(std::unique(candidates_.begin(), candidates_.end()), candidates_.end());
+}
+
+bool SparseUniverse::stepChunk(std::int64_t chunkRow, std::int64_t chunkCol, Chunk& out) const {
+    static const Chunk kEmpty{};
+    const Chunk* around[3][3];
+    for (int dr = -1; dr <= 1; ++dr) {
+        for (int dc = -1; dc <= 1; ++dc) {
+            const Chunk* chunk = findChunk(chunkRow + dr, chunkCol + dc);
+            around[dr + 1][dc + 1] = chunk ? chunk : &kEmpty;
+        }
+    }
+
+    // Rows -1 and kChunkSize come from the chunks above and below
+    auto rowOf = [&](int row, int column) -> Word {
+        if (row < 0) {
+            return (*around[0][column])[kChunkSize - 1];
+        }
+        if (row >= kChunkSize) {
+            return (*around[2][column])[0];
+        }
+        return (*around[1][column])[row];
+    };
+
+    Word any = 0;
+    for (int row = 0; row < kChunkSize; ++row) {
+        Word aw = rowOf(row - 1, 0), a = rowOf(row - 1, 1), ae = rowOf(row - 1, 2);
+        Word mw = rowOf(row, 0), m = rowOf(row, 1), me = rowOf(row, 2);
+        Word bw = rowOf(row + 1, 0), b = rowOf(row + 1, 1), be = rowOf(row + 1, 2);
+        out[row] = LifeKernels::conwayNext(LifeKernels::westOf(a, aw), a, LifeKernels::eastOf(a, ae),
+                                           LifeKernels::westOf(m, mw), m, LifeKernels::eastOf(m, me),
+                                           LifeKernels::westOf(b, bw), b, LifeKernels::eastOf(b, be));
+        any |= out[row];
+    }
+    return any != 0;
+}
+
+void SparseUniverse::step() {
+    collectCandidates();
+    next_.clear();
+    next_.reserve(candidates_.size());
+
+    Chunk result;
+    for (std::uint64_t key : candidates_) {
+        // Chunks whose next generation is empty are simply not carried over
+        if (stepChunk(keyRow(key), keyCol(key), result)) {
+            next_.emplace(key, result);
+        }
+    }
+    chunks_.swap(next_);
+    ++generation_;
+}
@@ -0,0 +1,147 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+namespace {
+
+std::uint64_t packRange(std::uint32_t begin, std::uint32_t end) {
+    return (static_cast<std::uint64_t>(begin) << 32) | end;
+}
+
+std::uint32_t rangeBegin(std::uint64_t range) {
+    return static_cast<std::uint32_t>(range >> 32);
+}
+
+std::uint32_t rangeEnd(std::uint64_t range) {
+    return static_cast<std::uint32_t>(range);
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(int threadCount)
+    : slices_(std::max(1, threadCount)),
+      taskFn_(nullptr),
+      taskContext_(nullptr),
+      pendingWorkers_(0),
+      epoch_(0),
+      stopping_(false) {
+    int workerCount = std::max(1, threadCount) - 1;
+    workers_.reserve(workerCount);
+    for (int i = 0; i < workerCount; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i + 1);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+int ThreadPool::resolveThreadCount(int requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void ThreadPool::run(int count, TaskFn fn, void* context) {
+    if (count <= 0) {
+        return;
+    }
+    if (workers_.empty() || count == 1) {
+        for (int i = 0; i < count; ++i) {
+            fn(context, i);
+        }
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        taskFn_ = fn;
+        taskContext_ = context;
+        int threads = static_cast<int>(slices_.size());
+        for (int t = 0; t < threads; ++t) {
+            auto begin = static_cast<std::uint32_t>(static_cast<long long>(count) * t / threads);
+            auto end = static_cast<std::uint32_t>(static_cast<long long>(count) * (t + 1) / threads);
+            slices_[t].range.store(packRange(begin, end), std::memory_order_relaxed);
+        }
+        pendingWorkers_ = static_cast<int>(workers_.size());
+        ++epoch_;
+    }
+    wake_.notify_all();
+    
+    drain(0);
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return pendingWorkers_ == 0; });
+}
+
+bool ThreadPool::popFront(int self, int& index) {
+    auto& range = slices_[self].range;
+    std::uint64_t current = range.load(std::memory_order_acquire);
+    while (rangeBegin(current) < rangeEnd(current)) {
+        std::uint64_t taken = packRange(rangeBegin(current) + 1, rangeEnd(current));
+        if (range.compare_exchange_weak(current, taken, std::memory_order_acq_rel)) {
+            index = static_cast<int>(rangeBegin(current));
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::steal(int self) {
+    int threads = static_cast<int>(slices_.size());
+    for (int offset = 1; offset < threads; ++offset) {
+        auto& victim = slices_[(self + offset) % threads].range;
+        std::uint64_t current = victim.load(std::memory_order_acquire);
+        while (rangeBegin(current) < rangeEnd(current)) {
+            std::uint32_t begin = rangeBegin(current);
+            std::uint32_t end = rangeEnd(current);
+            std::uint32_t middle = begin + (end - begin) / 2;
+            if (victim.compare_exchange_weak(current, packRange(begin, middle),
+                                             std::memory_order_acq_rel)) {
+                // Our own slice is empty, so only other thieves can race on it
+                slices_[self].range.store(packRange(middle, end), std::memory_order_release);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void ThreadPool::drain(int self) {
+    int index;
+    do {
+        while (popFront(self, index)) {
+            taskFn_(taskContext_, index);
+        }
+    } while (steal(self));
+}
+
+void ThreadPool::workerLoop(int self) {
+    std::uint64_t seenEpoch = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stopping_ || epoch_ != seenEpoch; });
+            if (stopping_) {
+                return;
+            }
+            seenEpoch = epoch_;
+        }
+        
+        drain(self);
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--pendingWorkers_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+}
@@ -0,0 +1,34 @@
+/**
+ * @file TestHelpers.hpp
+ * @brief Fixtures shared by the test suites: seeded random grids and whole-file I/O
+ */
+
+#pragma once
+#include "../Grid.hpp"
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+
+/// Each cell alive with probability @p density; the same seed gives the same grid
+inline Grid randomGrid(int rows, int cols, double density, unsigned seed) {
+    Grid grid(rows, cols);
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution alive(density);
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            grid.setCell(row, col, alive(rng));
+        }
+    }
+    return grid;
+}
+
+inline std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+inline void writeFile(const std::string& path, const std::string& bytes) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << bytes;
+}
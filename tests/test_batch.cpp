@@ -0,0 +1,260 @@
+/**
+ * @file test_batch.cpp
+ * @brief Tests for the headless batch runner, soup search and their command-line options
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "../Config.hpp"
+#include "../GameEngine.hpp"
+#include "../include/BatchRunner.hpp"
+#include "../include/SoupSearch.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool parseArgs(Config& config, std::vector<std::string> args) {
+    std::vector<char*> argv;
+    static char program[] = "GameOfLife_Console";
+    argv.push_back(program);
+    for (auto& arg : args) {
+        argv.push_back(arg.data());
+    }
+    return config.parse(static_cast<int>(argv.size()), argv.data());
+}
+
+} // namespace
+
+TEST_CASE("Config parses headless options", "[batch][config]") {
+    Config config;
+    REQUIRE(config.getGenerations() == 100);
+    REQUIRE_FALSE(config.runUntilStable());
+    REQUIRE(config.getReportFormat() == "text");
+
+    REQUIRE(parseArgs(config, {"--generations=5000", "--until-stable", "--threads=4",
+                               "--output=out.txt", "--report=json"}));
+    REQUIRE(config.getGenerations() == 5000);
+    REQUIRE(config.runUntilStable());
+    REQUIRE(config.getThreads() == 4);
+    REQUIRE(config.getOutputPath() == "out.txt");
+    REQUIRE(config.getReportFormat() == "json");
+
+    Config bad;
+    REQUIRE_FALSE(parseArgs(bad, {"--report=xml"}));
+    REQUIRE_FALSE(parseArgs(bad, {"--generations=-1"}));
+}
+
+TEST_CASE("BatchRunner runs a fixed number of generations", "[batch]") {
+    GameEngine engine(32, 32);
+    engine.getCurrentGridMutable().setCell(10, 10, true);
+    engine.getCurrentGridMutable().setCell(10, 11, true);
+    engine.getCurrentGridMutable().setCell(10, 12, true);
+
+    BatchResult result = BatchRunner(25, false).run(engine);
+    REQUIRE(result.generations == 25);
+    REQUIRE_FALSE(result.stabilized);
+    REQUIRE(engine.getGeneration() == 25);
+    REQUIRE(result.cellUpdates == 25u * 32u * 32u);
+    REQUIRE(result.population == 3);
+}
+
+TEST_CASE("BatchRunner stops when the grid stabilizes", "[batch]") {
+    // A pre-block settles into a still life after one generation
+    GameEngine engine(16, 16);
+    engine.getCurrentGridMutable().setCell(5, 5, true);
+    engine.getCurrentGridMutable().setCell(5, 6, true);
+    engine.getCurrentGridMutable().setCell(6, 5, true);
+
+    BatchResult result = BatchRunner(0, true).run(engine);
+    REQUIRE(result.stabilized);
+    REQUIRE(result.generations == 2);
+    REQUIRE(result.population == 4);
+}
+
+TEST_CASE("BatchRunner reports throughput and memory", "[batch]") {
+    GameEngine engine(64, 64);
+    BatchResult result = BatchRunner(10, false).run(engine);
+
+    std::string json = BatchRunner::formatJson(result, engine);
+    REQUIRE(json.front() == '{');
+    REQUIRE(json.find("\"generations\": 10") != std::string::npos);
+    REQUIRE(json.find("\"engine\": \"bitparallel\"") != std::string::npos);
+    REQUIRE(json.find("\"peak_rss_bytes\"") != std::string::npos);
+
+    std::string text = BatchRunner::formatText(result, engine);
+    REQUIRE(text.find("gen/s") != std::string::npos);
+    REQUIRE(text.find("Peak RSS") != std::string::npos);
+
+#if defined(__linux__) || defined(__APPLE__) || defined(_WIN32)
+    REQUIRE(BatchRunner::peakResidentBytes() > 0);
+#endif
+}
+
+TEST_CASE("BatchRunner reports a census of the final grid", "[batch][census]") {
+    Config config;
+    REQUIRE_FALSE(config.takeCensus());
+    REQUIRE(parseArgs(config, {"--census"}));
+    REQUIRE(config.takeCensus());
+
+    // A pre-block settles into a block; the blinker keeps blinking
+    GameEngine engine(32, 32);
+    Grid& grid = engine.getCurrentGridMutable();
+    grid.setCell(5, 5, true);
+    grid.setCell(5, 6, true);
+    grid.setCell(6, 5, true);
+    grid.setCell(20, 10, true);
+    grid.setCell(20, 11, true);
+    grid.setCell(20, 12, true);
+
+    BatchResult result = BatchRunner(3, false, true).run(engine);
+    REQUIRE(result.censusTaken);
+    REQUIRE(result.census.islands == 2);
+    REQUIRE(result.census.count("block") == 1);
+    REQUIRE(result.census.count("blinker") == 1);
+
+    std::string text = BatchRunner::formatText(result, engine);
+    REQUIRE(text.find("Census:      1 blinker, 1 block\n") != std::string::npos);
+    std::string json = BatchRunner::formatJson(result, engine);
+    REQUIRE(json.find("\"block\": 1") != std::string::npos);
+    REQUIRE(json.find("\"islands\": 2") != std::string::npos);
+}
+
+TEST_CASE("BatchRunner rejects negative limits", "[batch]") {
+    REQUIRE_THROWS_AS(BatchRunner(-1, false), std::invalid_argument);
+}
+
+TEST_CASE("BatchRunner jumps a HashLife universe to the generation limit", "[batch][hashlife]") {
+    Config config;
+    REQUIRE_FALSE(config.useHashLife());
+    REQUIRE(parseArgs(config, {"--engine=hashlife", "--generations=5206"}));
+    REQUIRE(config.useHashLife());
+    Config highLife;
+    REQUIRE_FALSE(parseArgs(highLife, {"--engine=hashlife", "--rule=highlife"}));
+    Config stable;
+    REQUIRE_FALSE(parseArgs(stable, {"--engine=hashlife", "--until-stable"}));
+    Config bounded;
+    REQUIRE_FALSE(parseArgs(bounded, {"--engine=hashlife", "--toroidal=1"}));
+
+    // Acorn settles at 633 cells after 5206 generations, far outside its 3x7 start
+    Grid acorn(3, 7);
+    acorn.setCell(0, 1, true);
+    acorn.setCell(1, 3, true);
+    acorn.setCell(2, 0, true);
+    acorn.setCell(2, 1, true);
+    acorn.setCell(2, 4, true);
+    acorn.setCell(2, 5, true);
+    acorn.setCell(2, 6, true);
+    HashLifeEngine engine(acorn);
+    BatchResult result = BatchRunner(config.getGenerations(), false).run(engine);
+    REQUIRE(result.generations == 5206);
+    REQUIRE(engine.getGeneration() == 5206);
+    REQUIRE(result.population == 633);
+    REQUIRE(result.cellUpdates == 0);
+
+    REQUIRE(BatchRunner::formatText(result, engine).find("Population:  633\n") != std::string::npos);
+    std::string json = BatchRunner::formatJson(result, engine);
+    REQUIRE(json.find("\"engine\": \"hashlife\"") != std::string::npos);
+    REQUIRE(json.find("\"population\": 633") != std::string::npos);
+
+    REQUIRE_THROWS_AS(BatchRunner(0, true).run(engine), std::invalid_argument);
+    REQUIRE_THROWS_AS(BatchRunner(10, false, true).run(engine), std::invalid_argument);
+}
+
+TEST_CASE("Config parses soup search options", "[batch][soup][config]") {
+    Config config;
+    REQUIRE(config.getSoups() == 0);
+    REQUIRE_FALSE(config.hasGenerations());
+
+    REQUIRE(parseArgs(config, {"--soups=500", "--seed=42", "--soup-size=20", "--board-size=128",
+                               "--density=0.375", "--generations=20000", "--report=csv"}));
+    REQUIRE(config.getSoups() == 500);
+    REQUIRE(config.getSeed() == 42);
+    REQUIRE(config.getSoupSize() == 20);
+    REQUIRE(config.getBoardSize() == 128);
+    REQUIRE(config.getDensity() == 0.375);
+    REQUIRE(config.hasGenerations());
+    REQUIRE(config.getReportFormat() == "csv");
+
+    Config bad;
+    REQUIRE_FALSE(parseArgs(bad, {"--report=csv"}));
+    Config dense;
+    REQUIRE_FALSE(parseArgs(dense, {"--soups=1", "--density=1.5"}));
+    Config crowded;
+    REQUIRE_FALSE(parseArgs(crowded, {"--soups=1", "--soup-size=64", "--board-size=32"}));
+}
+
+TEST_CASE("SoupSearch runs every seed until it settles", "[batch][soup]") {
+    SoupSearchOptions options;
+    options.soups = 24;
+    options.firstSeed = 100;
+    options.boardSize = 128;
+    options.threads = 3;
+    SoupSearch search(options);
+
+    SoupSearchResult result = search.run();
+    REQUIRE(result.soups.size() == 24);
+    REQUIRE(result.threads == 3);
+    std::uint64_t generations = 0;
+    for (std::size_t i = 0; i < result.soups.size(); ++i) {
+        const SoupResult& soup = result.soups[i];
+        REQUIRE(soup.seed == 100 + i);
+        REQUIRE(soup.stabilized);
+        generations += soup.lifespan + soup.period;
+
+        // Replaying the soup reaches a state that repeats after one period
+        GameEngine engine(search.makeSoup(soup.seed));
+        for (int g = 0; g < soup.lifespan; ++g) {
+            engine.step();
+        }
+        Grid first = engine.getCurrentGrid();
+        REQUIRE(first.countLiving() == soup.population);
+        for (int g = 0; g < soup.period; ++g) {
+            engine.step();
+        }
+        REQUIRE(engine.getCurrentGrid() == first);
+        REQUIRE((soup.census.islands > 0) == (soup.population > 0));
+    }
+    REQUIRE(result.generations == generations);
+    REQUIRE(result.soupsPerSecond() > 0.0);
+}
+
+TEST_CASE("SoupSearch results depend only on the seed", "[batch][soup]") {
+    SoupSearchOptions options;
+    options.soups = 6;
+    options.boardSize = 96;
+    options.threads = 1;
+    SoupSearchResult serial = SoupSearch(options).run();
+    options.threads = 4;
+    options.backend = GameEngine::Backend::BitParallel;
+    SoupSearchResult parallel = SoupSearch(options).run();
+
+    REQUIRE(SoupSearch::formatCsv(serial) == SoupSearch::formatCsv(parallel));
+
+    std::string csv = SoupSearch::formatCsv(serial);
+    REQUIRE(csv.rfind("seed,lifespan,period,stabilized,population,islands,census\n", 0) == 0);
+    REQUIRE(std::count(csv.begin(), csv.end(), '\n') == 7);
+    std::string json = SoupSearch::formatJson(serial);
+    REQUIRE(json.find("\"soups\": 6") != std::string::npos);
+    REQUIRE(json.find("\"soups_per_second\"") != std::string::npos);
+    REQUIRE(SoupSearch::formatText(serial).find("Longest lived:") != std::string::npos);
+}
+
+TEST_CASE("SoupSearch handles empty and capped soups", "[batch][soup]") {
+    SoupSearchOptions options;
+    options.soups = 1;
+    options.density = 0.0;
+    SoupResult empty = SoupSearch(options).runSoup(7);
+    REQUIRE(empty.stabilized);
+    REQUIRE(empty.lifespan == 0);
+    REQUIRE(empty.population == 0);
+
+    options.density = 0.5;
+    options.maxGenerations = 3;
+    SoupResult capped = SoupSearch(options).runSoup(7);
+    REQUIRE_FALSE(capped.stabilized);
+    REQUIRE(capped.lifespan == 3);
+
+    options.soupSize = 300;
+    REQUIRE_THROWS_AS(SoupSearch(options), std::invalid_argument);
+}
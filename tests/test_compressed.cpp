@@ -0,0 +1,146 @@
+/**
+ * @file test_compressed.cpp
+ * @brief Tests for tiled, compressed snapshots
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "../Grid.hpp"
+#include "../GameEngine.hpp"
+#include "../TextFileIO.hpp"
+#include "../include/CompressedSnapshot.hpp"
+#include "TestHelpers.hpp"
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+TEST_CASE("Compressed snapshots round-trip dense and sparse boards", "[compressed][io]") {
+    const std::string path = "test_compressed.golz";
+    for (int cols : {1, 64, 130}) {
+        for (unsigned oneIn : {2u, 3u, 50u}) {
+            Grid grid = randomGrid(137, cols, 1.0 / oneIn, static_cast<unsigned>(cols) + oneIn);
+            CompressedSnapshot::save(grid, path, Rule::parse("highlife"), 1234567890123ull, true);
+            REQUIRE(CompressedSnapshot::isSnapshot(path));
+            REQUIRE(readFile(path).compare(0, 4, "GOLZ") == 0);
+
+            Snapshot snapshot = CompressedSnapshot::load(path);
+            REQUIRE_FALSE(snapshot.grid.hasExternalStorage());
+            REQUIRE(snapshot.grid == grid);
+            REQUIRE(snapshot.rule == Rule::parse("B36/S23"));
+            REQUIRE(snapshot.generation == 1234567890123ull);
+            REQUIRE(snapshot.toroidal);
+        }
+    }
+
+    // TextFileIO picks the format from the name and the magic
+    Grid grid = randomGrid(40, 90, 0.3, 5u);
+    TextFileIO().saveGrid(grid, path, Rule::parse("B2/S"));
+    REQUIRE(*TextFileIO().loadGrid(path) == grid);
+    REQUIRE(TextFileIO().loadRule(path) == "B2/S");
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Compressed snapshots skip empty tiles", "[compressed][io]") {
+    const std::string path = "test_compressed.golz";
+    Grid grid(4096, 4096);  // 4096 tiles, 2 MiB of packed words
+    CompressedSnapshot::save(grid, path);
+    std::size_t emptyBytes = readFile(path).size();
+    REQUIRE(emptyBytes < 128);
+
+    // A glider costs one index entry and a few bytes of tile data
+    grid.setCell(2000, 3001, true);
+    grid.setCell(2001, 3002, true);
+    grid.setCell(2002, 3000, true);
+    grid.setCell(2002, 3001, true);
+    grid.setCell(2002, 3002, true);
+    CompressedSnapshot::save(grid, path);
+    REQUIRE(readFile(path).size() < emptyBytes + 24 + 32);
+    REQUIRE(CompressedSnapshot::load(path).grid == grid);
+
+    // Thread count does not change the bytes written
+    Grid soup = randomGrid(300, 300, 0.15, 9u);
+    CompressedSnapshot::save(soup, path, Rule(), 0, false, 1);
+    std::string serial = readFile(path);
+    CompressedSnapshot::save(soup, path, Rule(), 0, false, 4);
+    REQUIRE(readFile(path) == serial);
+    REQUIRE(CompressedSnapshot::load(path, 1).grid == soup);
+    REQUIRE(CompressedSnapshot::load(path, 4).grid == soup);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Compressed snapshot regions match the whole board", "[compressed][io]") {
+    const std::string path = "test_compressed.golz";
+    Grid grid = randomGrid(300, 260, 0.25, 11u);
+    CompressedSnapshot::save(grid, path);
+
+    struct Window { int top, left, rows, cols; };
+    for (Window w : {Window{0, 0, 300, 260}, Window{0, 0, 1, 1}, Window{63, 63, 2, 2},
+                     Window{10, 37, 130, 150}, Window{299, 259, 1, 1}, Window{128, 64, 64, 64},
+                     Window{5, 200, 200, 60}}) {
+        Grid region = CompressedSnapshot::loadRegion(path, w.top, w.left, w.rows, w.cols);
+        REQUIRE(region.getRows() == w.rows);
+        REQUIRE(region.getCols() == w.cols);
+        Grid expected(w.rows, w.cols);
+        for (int row = 0; row < w.rows; ++row) {
+            for (int col = 0; col < w.cols; ++col) {
+                expected.setCell(row, col, grid.getCell(w.top + row, w.left + col));
+            }
+        }
+        REQUIRE(region == expected);
+    }
+
+    REQUIRE_THROWS_AS(CompressedSnapshot::loadRegion(path, 0, 0, 0, 5), std::out_of_range);
+    REQUIRE_THROWS_AS(CompressedSnapshot::loadRegion(path, 250, 0, 51, 5), std::out_of_range);
+    REQUIRE_THROWS_AS(CompressedSnapshot::loadRegion(path, 0, -1, 5, 5), std::out_of_range);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Compressed snapshots resume engines and reject damaged files", "[compressed][io]") {
+    const std::string path = "test_compressed.golz";
+    GameEngine engine(randomGrid(100, 100, 0.3, 13u), true);
+    engine.setRule(Rule::parse("B36/S23"));
+    for (int i = 0; i < 7; ++i) {
+        engine.step();
+    }
+    CompressedSnapshot::save(engine, path, 2);
+
+    Snapshot snapshot = CompressedSnapshot::load(path);
+    GameEngine resumed(std::move(snapshot.grid), snapshot.toroidal);
+    resumed.setRule(snapshot.rule);
+    resumed.setGeneration(static_cast<int>(snapshot.generation));
+    engine.step();
+    resumed.step();
+    REQUIRE(resumed.getGeneration() == 8);
+    REQUIRE(resumed.getCurrentGrid() == engine.getCurrentGrid());
+
+    std::string bytes = readFile(path);
+    writeFile(path, bytes.substr(0, bytes.size() - 1));
+    REQUIRE_THROWS_AS(CompressedSnapshot::load(path), std::runtime_error);
+    // The rule sits in the header, ahead of the missing tile data
+    REQUIRE(CompressedSnapshot::loadRule(path) == Rule::parse("B36/S23"));
+    REQUIRE(TextFileIO().loadRule(path) == "B36/S23");
+
+    std::string badIndex = bytes;
+    badIndex[52 + 7 + 19] = '\x7f';  // First tile's size now runs past the data
+    std::string badVersion = bytes;
+    badVersion[4] = 99;
+    std::string badMagic = bytes;
+    badMagic[3] = 'B';
+    // Sizes far past the end of the file are rejected before anything is allocated
+    std::string hugeIndex = bytes;
+    std::string hugeData = bytes;
+    for (int i = 0; i < 4; ++i) {
+        hugeIndex[12 + i] = hugeIndex[16 + i] = i == 3 ? '\x7f' : '\xff';  // 2^31 - 1 square board
+    }
+    for (int i = 0; i < 8; ++i) {
+        hugeIndex[36 + i] = i == 5 ? '\x01' : '\0';  // 2^40 tiles
+        hugeData[44 + i] = '\xff';
+    }
+    for (const std::string& damaged : {badIndex, badVersion, badMagic, hugeIndex, hugeData}) {
+        writeFile(path, damaged);
+        REQUIRE_THROWS_AS(CompressedSnapshot::load(path), std::runtime_error);
+    }
+    writeFile(path, "GOLZ");
+    REQUIRE_THROWS_AS(CompressedSnapshot::load(path), std::runtime_error);
+    REQUIRE_THROWS_AS(CompressedSnapshot::load("missing_snapshot.golz"), std::runtime_error);
+    std::remove(path.c_str());
+}
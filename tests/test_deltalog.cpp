@@ -0,0 +1,235 @@
+/**
+ * @file test_deltalog.cpp
+ * @brief Tests for the streaming delta log and its SPSC queue
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "../Grid.hpp"
+#include "../GameEngine.hpp"
+#include "../include/DeltaLog.hpp"
+#include "../include/SpscQueue.hpp"
+#include "TestHelpers.hpp"
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Delta logs replay every generation and seek to any of them", "[deltalog][io]") {
+    const std::string path = "test_deltalog.gold";
+    GameEngine engine(randomGrid(70, 130, 0.3, 3u), true);
+    engine.setRule(Rule::parse("highlife"));
+    std::vector<Grid> expected{engine.getCurrentGrid()};
+    std::uint64_t keyframes = 0;
+    {
+        DeltaLogWriter log(path, engine, 50);
+        for (int i = 0; i < 200; ++i) {
+            engine.step();
+            log.record(engine);
+            expected.push_back(engine.getCurrentGrid());
+        }
+        log.close();
+        REQUIRE(log.getRecordCount() == 201);
+        // At least every 50 generations, and wherever the soup flips more
+        // cells than it has alive
+        keyframes = log.getKeyframeCount();
+        REQUIRE(keyframes >= 5);
+        REQUIRE(keyframes < 100);
+    }
+
+    DeltaLogReader reader(path);
+    REQUIRE(reader.hasIndex());
+    REQUIRE(reader.getRows() == 70);
+    REQUIRE(reader.getCols() == 130);
+    REQUIRE(reader.getRule() == Rule::parse("B36/S23"));
+    REQUIRE(reader.isToroidal());
+    REQUIRE(reader.getFirstGeneration() == 0);
+    REQUIRE(reader.getLastGeneration() == 200);
+    REQUIRE(reader.getKeyframeCount() == keyframes);
+
+    REQUIRE(reader.getGrid() == expected[0]);
+    for (std::uint64_t generation = 1; generation <= 200; ++generation) {
+        REQUIRE(reader.next());
+        REQUIRE(reader.getGeneration() == generation);
+        REQUIRE(reader.getGrid() == expected[generation]);
+    }
+    REQUIRE_FALSE(reader.next());
+
+    // Backwards, forwards within a keyframe span, and across keyframes
+    for (std::uint64_t generation : {0u, 199u, 3u, 49u, 50u, 51u, 120u, 121u, 7u, 200u, 150u}) {
+        reader.seek(generation);
+        REQUIRE(reader.getGeneration() == generation);
+        REQUIRE(reader.getGrid() == expected[generation]);
+    }
+    REQUIRE_THROWS_AS(reader.seek(201), std::out_of_range);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Delta logs store a glider's flips, not its board", "[deltalog][io]") {
+    const std::string path = "test_deltalog.gold";
+    Grid grid(1024, 1024);  // 128 KiB of packed words per keyframe
+    grid.setCell(1, 2, true);
+    grid.setCell(2, 3, true);
+    grid.setCell(3, 1, true);
+    grid.setCell(3, 2, true);
+    grid.setCell(3, 3, true);
+    GameEngine engine(std::move(grid), false);
+    DeltaLogWriter log(path, engine);
+    for (int i = 0; i < 1000; ++i) {
+        engine.step();
+        log.record(engine);
+    }
+    log.close();
+    // Generation 0 and the first step, whose change list the engine does
+    // not vouch for; deltas after that
+    REQUIRE(log.getKeyframeCount() == 2);
+
+    // A glider flips about six cells a step: a few bytes per generation
+    REQUIRE(readFile(path).size() < 1000 * 16);
+    DeltaLogReader reader(path);
+    reader.seek(1000);
+    REQUIRE(reader.getGrid() == engine.getCurrentGrid());
+    REQUIRE(reader.getGrid().countLiving() == 5);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Delta logs fall back to keyframes when deltas are unavailable", "[deltalog][io]") {
+    const std::string path = "test_deltalog.gold";
+    // Still lifes and a blinker: few flips for their population
+    Grid grid(40, 40);
+    for (auto [top, left] : {std::pair{5, 5}, std::pair{5, 30}, std::pair{30, 5}}) {
+        grid.setCell(top, left, true);
+        grid.setCell(top, left + 1, true);
+        grid.setCell(top + 1, left, true);
+        grid.setCell(top + 1, left + 1, true);
+    }
+    grid.setCell(30, 29, true);
+    grid.setCell(30, 30, true);
+    grid.setCell(30, 31, true);
+    GameEngine engine(std::move(grid), false);
+    std::vector<std::pair<std::uint64_t, Grid>> expected{{0, engine.getCurrentGrid()}};
+    {
+        DeltaLogWriter log(path, engine, 1000);
+        engine.step();
+        log.record(engine);
+        expected.emplace_back(1, engine.getCurrentGrid());
+        engine.step();
+        log.record(engine);
+        expected.emplace_back(2, engine.getCurrentGrid());
+        REQUIRE(log.getKeyframeCount() == 2);  // The first step after construction counts as an edit
+
+        // An edit between steps leaves the change list incomplete
+        Grid& edited = engine.getCurrentGridMutable();
+        edited.setCell(20, 20, !edited.getCell(20, 20));
+        engine.step();
+        log.record(engine);
+        expected.emplace_back(3, engine.getCurrentGrid());
+        REQUIRE(log.getKeyframeCount() == 3);
+
+        // Skipped generations are not covered by the last step's changes
+        engine.step();
+        engine.step();
+        log.record(engine);
+        expected.emplace_back(5, engine.getCurrentGrid());
+        REQUIRE(log.getKeyframeCount() == 4);
+        engine.step();
+        log.record(engine);
+        expected.emplace_back(6, engine.getCurrentGrid());
+
+        REQUIRE_THROWS_AS(log.record(engine), std::invalid_argument);
+        log.close();
+        REQUIRE(log.getRecordCount() == 6);
+        REQUIRE(log.getKeyframeCount() == 4);
+        REQUIRE_THROWS_AS(log.record(engine), std::logic_error);
+    }
+
+    DeltaLogReader reader(path);
+    REQUIRE(reader.getKeyframeCount() == 4);
+    for (const auto& [generation, grid] : expected) {
+        reader.seek(generation);
+        REQUIRE(reader.getGeneration() == generation);
+        REQUIRE(reader.getGrid() == grid);
+    }
+    // Generation 4 was never recorded: seek lands on the one before it
+    reader.seek(4);
+    REQUIRE(reader.getGeneration() == 3);
+    REQUIRE(reader.getGrid() == expected[3].second);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Delta logs recover from a missing index and reject other files", "[deltalog][io]") {
+    const std::string path = "test_deltalog.gold";
+    GameEngine engine(randomGrid(50, 70, 0.3, 7u), false);
+    std::vector<Grid> expected{engine.getCurrentGrid()};
+    std::uint64_t keyframes = 0;
+    {
+        DeltaLogWriter log(path, engine, 10);
+        for (int i = 0; i < 30; ++i) {
+            engine.step();
+            log.record(engine);
+            expected.push_back(engine.getCurrentGrid());
+        }
+        keyframes = log.getKeyframeCount();
+    }
+    std::string bytes = readFile(path);
+    REQUIRE(bytes.compare(bytes.size() - 8, 8, "GOLDINDX") == 0);
+
+    // As if the writer had stopped partway through the last record
+    std::uint64_t indexOffset = 0;
+    for (int i = 7; i >= 0; --i) {
+        indexOffset = (indexOffset << 8) | static_cast<unsigned char>(bytes[bytes.size() - 16 + i]);
+    }
+    std::string records = bytes.substr(0, indexOffset);
+    writeFile(path, records.substr(0, records.size() - 1));
+    DeltaLogReader recovered(path);
+    REQUIRE_FALSE(recovered.hasIndex());
+    REQUIRE(recovered.getKeyframeCount() == keyframes);
+    REQUIRE(recovered.getLastGeneration() == 29);
+    recovered.seek(29);
+    REQUIRE(recovered.getGrid() == expected[29]);
+    recovered.seek(12);
+    REQUIRE(recovered.getGrid() == expected[12]);
+
+    std::string badMagic = bytes;
+    badMagic[0] = 'X';
+    std::string badVersion = bytes;
+    badVersion[4] = 99;
+    for (const std::string& damaged : {badMagic, badVersion, bytes.substr(0, 20)}) {
+        writeFile(path, damaged);
+        REQUIRE_THROWS_AS(DeltaLogReader(path), std::runtime_error);
+    }
+    REQUIRE_THROWS_AS(DeltaLogReader("missing_log.gold"), std::runtime_error);
+    REQUIRE_THROWS_AS(DeltaLogWriter(path, engine, 0), std::invalid_argument);
+    REQUIRE(DeltaLogWriter::isDeltaLogFileName("run.GOLD"));
+    REQUIRE_FALSE(DeltaLogWriter::isDeltaLogFileName("run.golz"));
+    std::remove(path.c_str());
+}
+
+TEST_CASE("SpscQueue hands values across threads in order", "[deltalog][threads]") {
+    SpscQueue<int> queue(5);
+    REQUIRE(queue.capacity() == 8);
+
+    constexpr int kCount = 100000;
+    std::thread producer([&queue] {
+        for (int i = 1; i <= kCount; ++i) {
+            queue.push(i);
+        }
+    });
+    bool ordered = true;
+    for (int i = 1; i <= kCount; ++i) {
+        ordered = ordered && queue.pop() == i;
+    }
+    producer.join();
+    REQUIRE(ordered);
+
+    int value = 0;
+    REQUIRE_FALSE(queue.tryPop(value));
+    for (int i = 0; i < 8; ++i) {
+        int item = i;
+        REQUIRE(queue.tryPush(item));
+    }
+    int extra = 8;
+    REQUIRE_FALSE(queue.tryPush(extra));
+    REQUIRE(queue.tryPop(value));
+    REQUIRE(value == 0);
+}
@@ -0,0 +1,150 @@
+/**
+ * @file test_engine.cpp
+ * @brief Tests for GameEngine buffer management using Catch2 v3
+ *
+ * Replaces the global allocation functions with counting versions, so
+ * steady-state stepping can be checked for heap allocations.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "../Grid.hpp"
+#include "../GameEngine.hpp"
+#include "TestHelpers.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<long> allocationCount(0);
+
+void* countedAllocate(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* countedAllocateAligned(std::size_t size, std::align_val_t alignment) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    std::size_t align = static_cast<std::size_t>(alignment);
+    std::size_t rounded = (size + align - 1) / align * align;
+    if (void* p = std::aligned_alloc(align, rounded == 0 ? align : rounded)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new[](std::size_t size) { return countedAllocate(size); }
+void* operator new(std::size_t size, std::align_val_t a) { return countedAllocateAligned(size, a); }
+void* operator new[](std::size_t size, std::align_val_t a) { return countedAllocateAligned(size, a); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+TEST_CASE("Steady-state stepping performs no heap allocations", "[engine][alloc]") {
+    Grid start = randomGrid(256, 300, 0.3, 42u);
+    
+    const GameEngine::Backend backends[] = {
+        GameEngine::Backend::Reference,
+        GameEngine::Backend::BitParallel,
+        GameEngine::Backend::Tiled,
+        GameEngine::Backend::Lookup,
+        GameEngine::Backend::Incremental
+    };
+    for (auto backend : backends) {
+        for (int threads : {1, 4}) {
+            for (const char* rule : {"B3/S23", "B2/S/C3"}) {
+                GameEngine engine(start, true);
+                engine.setBackend(backend);
+                engine.setThreadCount(threads);
+                engine.setRule(Rule::parse(rule));
+                engine.step();  // First step sizes the tile tables
+                
+                long before = allocationCount.load();
+                for (int gen = 0; gen < 25; ++gen) {
+                    engine.step();
+                }
+                long allocations = allocationCount.load() - before;
+                
+                INFO("backend " << GameEngine::backendName(backend) << ", threads " << threads << ", rule " << rule);
+                REQUIRE(allocations == 0);
+            }
+        }
+    }
+}
+
+TEST_CASE("Double buffering keeps the stable flag exact", "[engine]") {
+    GameEngine engine(10, 10);
+    Grid& grid = engine.getCurrentGridMutable();
+    grid.setCell(4, 4, true);
+    grid.setCell(4, 5, true);
+    grid.setCell(5, 4, true);
+    grid.setCell(5, 5, true);
+    
+    engine.step();
+    REQUIRE(engine.isStable());
+    
+    // A blinker next to the block keeps changing every generation
+    engine.getCurrentGridMutable().setCell(1, 1, true);
+    engine.getCurrentGridMutable().setCell(1, 2, true);
+    engine.getCurrentGridMutable().setCell(1, 3, true);
+    engine.step();
+    REQUIRE_FALSE(engine.isStable());
+    engine.step();
+    REQUIRE_FALSE(engine.isStable());
+}
+
+TEST_CASE("Population, births and deaths come from the step", "[engine][population]") {
+    Grid start = randomGrid(150, 300, 0.25, 7u);
+    
+    const GameEngine::Backend backends[] = {
+        GameEngine::Backend::Reference,
+        GameEngine::Backend::BitParallel,
+        GameEngine::Backend::Tiled,
+        GameEngine::Backend::Lookup,
+        GameEngine::Backend::Incremental
+    };
+    for (auto backend : backends) {
+        for (int threads : {1, 4}) {
+            for (const char* rule : {"B3/S23", "B36/S23", "B2/S345/C4"}) {
+                INFO("backend " << GameEngine::backendName(backend) << ", threads " << threads << ", rule " << rule);
+                GameEngine engine(start, true);
+                engine.setBackend(backend);
+                engine.setThreadCount(threads);
+                engine.setRule(Rule::parse(rule));
+                REQUIRE(engine.getPopulation() == start.countLiving());
+                
+                for (int gen = 0; gen < 12; ++gen) {
+                    if (gen == 6) {
+                        // Edits are picked up by a recount
+                        engine.getCurrentGridMutable().setCell(0, 0, !engine.getCurrentGrid().getCell(0, 0));
+                    }
+                    Grid before = engine.getCurrentGrid();
+                    engine.step();
+                    const Grid& after = engine.getCurrentGrid();
+                    int births = 0;
+                    int deaths = 0;
+                    for (int row = 0; row < after.getRows(); ++row) {
+                        for (int col = 0; col < after.getCols(); ++col) {
+                            births += after.getCell(row, col) && !before.getCell(row, col);
+                            deaths += before.getCell(row, col) && !after.getCell(row, col);
+                        }
+                    }
+                    REQUIRE(engine.getBirths() == births);
+                    REQUIRE(engine.getDeaths() == deaths);
+                    REQUIRE(engine.getPopulation() == after.countLiving());
+                }
+            }
+        }
+    }
+}
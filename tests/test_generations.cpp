@@ -0,0 +1,299 @@
+/**
+ * @file test_generations.cpp
+ * @brief Tests for multi-state (Generations) rules and the packed MultiStateGrid
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "../Grid.hpp"
+#include "../GameEngine.hpp"
+#include "../TextFileIO.hpp"
+#include "../include/CompressedSnapshot.hpp"
+#include "../include/MultiStateGrid.hpp"
+#include <cstdio>
+#include <random>
+
+namespace {
+
+MultiStateGrid randomStates(int rows, int cols, int states, unsigned seed) {
+    MultiStateGrid grid(rows, cols, states);
+    std::mt19937 rng(seed);
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            // Mostly dead, a third live, the rest spread over the decaying states
+            unsigned roll = rng() % 6;
+            int state = roll < 3 ? 0 : (roll < 5 ? 1 : static_cast<int>(rng() % states));
+            grid.setState(row, col, state);
+        }
+    }
+    return grid;
+}
+
+// Cell-by-cell Generations step, straight from the rule's definition
+MultiStateGrid referenceStep(const MultiStateGrid& current, const Rule& rule, bool toroidal) {
+    int rows = current.getRows();
+    int cols = current.getCols();
+    MultiStateGrid next(rows, cols, current.getStateCount());
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            int neighbors = 0;
+            for (int dr = -1; dr <= 1; ++dr) {
+                for (int dc = -1; dc <= 1; ++dc) {
+                    int r = row + dr;
+                    int c = col + dc;
+                    if (dr == 0 && dc == 0) continue;
+                    if (toroidal) {
+                        r = (r + rows) % rows;
+                        c = (c + cols) % cols;
+                    } else if (r < 0 || r >= rows || c < 0 || c >= cols) {
+                        continue;
+                    }
+                    neighbors += current.getState(r, c) == 1;
+                }
+            }
+            int state = current.getState(row, col);
+            int result = 0;
+            if (state == 0) {
+                result = rule.isBorn(neighbors) ? 1 : 0;
+            } else if (state == 1) {
+                result = rule.survives(neighbors) ? 1 : 2 % rule.getStateCount();
+            } else {
+                result = (state + 1) % rule.getStateCount();
+            }
+            next.setState(row, col, result);
+        }
+    }
+    return next;
+}
+
+} // namespace
+
+TEST_CASE("MultiStateGrid packs states into 2, 4 or 8 bits", "[generations][grid]") {
+    REQUIRE(MultiStateGrid(3, 70, 3).getBitsPerCell() == 2);
+    REQUIRE(MultiStateGrid(3, 70, 4).getBitsPerCell() == 2);
+    REQUIRE(MultiStateGrid(3, 70, 5).getBitsPerCell() == 4);
+    REQUIRE(MultiStateGrid(3, 70, 16).getBitsPerCell() == 4);
+    REQUIRE(MultiStateGrid(3, 70, 17).getBitsPerCell() == 8);
+    REQUIRE(MultiStateGrid(3, 70, 256).getBitsPerCell() == 8);
+    REQUIRE(MultiStateGrid(3, 70, 4).getWordsPerRow() == 4);  // Two Grid words, 2 bits each
+
+    for (int states : {3, 16, 256}) {
+        MultiStateGrid grid(5, 130, states);
+        grid.setState(0, 0, 1);
+        grid.setState(4, 129, states - 1);
+        grid.setState(2, 64, 2);
+        REQUIRE(grid.getState(0, 0) == 1);
+        REQUIRE(grid.getState(4, 129) == states - 1);
+        REQUIRE(grid.getState(2, 64) == 2);
+        REQUIRE(grid.getState(2, 63) == 0);
+        REQUIRE(grid.countLiving() == 1);
+        REQUIRE(grid.countNonDead() == 3);
+        REQUIRE(grid.toGrid().countLiving() == 1);
+    }
+
+    Grid plane(4, 100);
+    plane.setCell(1, 63, true);
+    plane.setCell(3, 99, true);
+    MultiStateGrid fromPlane(plane, 5);
+    REQUIRE(fromPlane.getState(1, 63) == 1);
+    REQUIRE(fromPlane.getState(3, 99) == 1);
+    REQUIRE(fromPlane.countNonDead() == 2);
+    REQUIRE(fromPlane.toGrid() == plane);
+
+    // Word-level counts and live plane agree with the cells, padding lanes included
+    for (int states : {4, 9, 200}) {
+        MultiStateGrid random = randomStates(7, 150, states, static_cast<unsigned>(states));
+        Grid live(7, 150);
+        int living = 0;
+        int nonDead = 0;
+        for (int row = 0; row < 7; ++row) {
+            for (int col = 0; col < 150; ++col) {
+                int state = random.getState(row, col);
+                living += state == 1;
+                nonDead += state != 0;
+                live.setCell(row, col, state == 1);
+            }
+        }
+        REQUIRE(random.countLiving() == living);
+        REQUIRE(random.countNonDead() == nonDead);
+        REQUIRE(random.toGrid() == live);
+        REQUIRE(MultiStateGrid(live, states).toGrid() == live);
+    }
+
+    MultiStateGrid grid(2, 2, 3);
+    REQUIRE_THROWS_AS(grid.setState(0, 0, 3), std::invalid_argument);
+    REQUIRE_THROWS_AS(grid.setState(2, 0, 1), std::out_of_range);
+    REQUIRE_THROWS_AS(grid.getState(0, -1), std::out_of_range);
+    REQUIRE_THROWS_AS(MultiStateGrid(2, 2, 257), std::invalid_argument);
+    REQUIRE_THROWS_AS(MultiStateGrid(0, 2, 3), std::invalid_argument);
+}
+
+TEST_CASE("Generations rule notation", "[generations][rules]") {
+    Rule brain = Rule::parse("B2/S/C3");
+    REQUIRE(brain.getStateCount() == 3);
+    REQUIRE(brain.isMultiState());
+    REQUIRE(brain.toString() == "B2/S/C3");
+    REQUIRE(Rule::parse("briansbrain") == brain);
+    REQUIRE(Rule::parse("/2/3") == brain);                      // Legacy survival/birth/states
+    REQUIRE(Rule::parse("345/2/4") == Rule::parse("starwars"));
+    REQUIRE(Rule::parse("B2/S345/4").toString() == "B2/S345/C4");
+    REQUIRE(Rule::parse("B3/S23/C2") == Rule());
+    REQUIRE_FALSE(Rule::parse("B36/S23").isMultiState());
+
+    REQUIRE_THROWS_AS(Rule::parse("B2/S/C1"), std::invalid_argument);
+    REQUIRE_THROWS_AS(Rule::parse("B2/S/C257"), std::invalid_argument);
+    REQUIRE_THROWS_AS(Rule::parse("B2/S/Cx"), std::invalid_argument);
+    REQUIRE_THROWS_AS(Rule::parse("B2/S/C3/4"), std::invalid_argument);
+}
+
+TEST_CASE("Packed Generations kernel matches the cell-by-cell rule", "[generations][kernels]") {
+    // 2-, 4- and 8-bit lanes, widths around word boundaries
+    const char* rules[] = {"B2/S/C3", "B2/S345/C4", "B3/S23/C5", "B34/S12/C16", "B2/S13/C17", "B3/S234/C256"};
+    for (const char* text : rules) {
+        Rule rule = Rule::parse(text);
+        for (int cols : {1, 31, 64, 65, 130}) {
+            for (bool toroidal : {false, true}) {
+                INFO(text << ", " << cols << " columns" << (toroidal ? ", toroidal" : ""));
+                MultiStateGrid expected = randomStates(13, cols, rule.getStateCount(), 17u + cols);
+                GameEngine engine(expected.toGrid(), toroidal);
+                engine.setRule(rule);
+                engine.setCellStates(expected);
+                for (int gen = 0; gen < 10; ++gen) {
+                    expected = referenceStep(expected, rule, toroidal);
+                    engine.step();
+                    REQUIRE(*engine.getCellStates() == expected);
+                    REQUIRE(engine.getCurrentGrid() == expected.toGrid());
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Generations engine integration", "[generations][engine]") {
+    Rule brain = Rule::parse("briansbrain");
+
+    SECTION("Threaded bands match a serial step") {
+        MultiStateGrid start = randomStates(203, 333, 3, 5u);
+        GameEngine serial(start.toGrid(), true);
+        GameEngine parallel(start.toGrid(), true);
+        for (GameEngine* engine : {&serial, &parallel}) {
+            engine->setRule(brain);
+            engine->setCellStates(start);
+        }
+        parallel.setThreadCount(3);
+        for (int gen = 0; gen < 20; ++gen) {
+            serial.step();
+            parallel.step();
+            REQUIRE(*parallel.getCellStates() == *serial.getCellStates());
+        }
+    }
+
+    SECTION("Edits to the current grid win over stale states") {
+        Grid start(8, 8);
+        start.setCell(3, 3, true);
+        start.setCell(3, 4, true);
+        GameEngine engine(start, false);
+        engine.setRule(brain);
+        engine.step();  // Both cells start decaying; four are born above and below
+        REQUIRE(engine.getCellStates()->getState(3, 3) == 2);
+
+        // Drawing on a decaying cell makes it live; erasing a live one makes it dead
+        engine.getCurrentGridMutable().setCell(3, 3, true);
+        engine.getCurrentGridMutable().setCell(2, 3, false);
+        MultiStateGrid edited = *engine.getCellStates();
+        edited.setState(3, 3, 1);
+        edited.setState(2, 3, 0);
+        engine.step();
+        REQUIRE(*engine.getCellStates() == referenceStep(edited, brain, false));
+    }
+
+    SECTION("Switching rules creates and drops the states") {
+        Grid start(10, 10);
+        start.setCell(5, 5, true);
+        GameEngine engine(start, false);
+        REQUIRE(engine.getCellStates() == nullptr);
+        engine.setRule(brain);
+        REQUIRE(engine.getCellStates() != nullptr);
+        REQUIRE(engine.getCellStates()->getState(5, 5) == 1);
+        REQUIRE_THROWS_AS(engine.setCellStates(MultiStateGrid(10, 10, 4)), std::invalid_argument);
+        REQUIRE_THROWS_AS(engine.setCellStates(MultiStateGrid(9, 10, 3)), std::invalid_argument);
+        engine.setRule(Rule());
+        REQUIRE(engine.getCellStates() == nullptr);
+        REQUIRE_THROWS_AS(engine.setCellStates(MultiStateGrid(10, 10, 3)), std::invalid_argument);
+    }
+
+    SECTION("Settles to an empty, stable board") {
+        Grid start(6, 6);
+        start.setCell(2, 2, true);
+        GameEngine engine(start, false);
+        engine.setRule(brain);
+        engine.step();  // Lone cell starts decaying
+        engine.step();  // and is dead again
+        REQUIRE(engine.getCellStates()->countNonDead() == 0);
+        REQUIRE_FALSE(engine.isStable());
+        engine.step();
+        REQUIRE(engine.isStable());
+    }
+}
+
+TEST_CASE("Multi-state text files", "[generations][io]") {
+    const char* path = "test_generations.txt";
+    MultiStateGrid states = randomStates(7, 9, 4, 3u);
+    TextFileIO fileIO;
+    fileIO.saveStates(states, path);
+
+    REQUIRE(*fileIO.loadStates(path) == states);
+    REQUIRE(*fileIO.loadGrid(path) == states.toGrid());  // Two-state view keeps state 1
+
+    // Two-state files load as two-state grids
+    fileIO.saveGrid(states.toGrid(), path);
+    std::unique_ptr<MultiStateGrid> plain = fileIO.loadStates(path);
+    REQUIRE(plain->getStateCount() == 2);
+    REQUIRE(plain->toGrid() == states.toGrid());
+    std::remove(path);
+
+    // RLE takes its state count from the rule, with letters for the states
+    const char* rlePath = "test_generations.rle";
+    MultiStateGrid many = randomStates(6, 70, 40, 5u);
+    fileIO.saveStates(many, rlePath, Rule::parse("B2/S/C40"));
+    REQUIRE(fileIO.loadRule(rlePath) == "B2/S/C40");
+    REQUIRE(*fileIO.loadStates(rlePath) == many);
+    REQUIRE(*fileIO.loadGrid(rlePath) == many.toGrid());
+    REQUIRE_THROWS_AS(fileIO.saveStates(many, rlePath), std::invalid_argument);
+    std::remove(rlePath);
+}
+
+TEST_CASE("Pattern files load grid, rule and states in one pass", "[generations][io]") {
+    TextFileIO fileIO;
+
+    // Multi-state RLE: the rule from the header, the states, and state 1 as the grid
+    const char* rlePath = "test_pattern.rle";
+    MultiStateGrid many = randomStates(9, 40, 6, 7u);
+    fileIO.saveStates(many, rlePath, Rule::parse("B2/S34/C6"));
+    LoadedPattern fromRle = fileIO.loadPattern(rlePath);
+    REQUIRE(fromRle.rule == "B2/S34/C6");
+    REQUIRE(fromRle.states);
+    REQUIRE(*fromRle.states == many);
+    REQUIRE(*fromRle.grid == many.toGrid());
+    REQUIRE(fromRle.generation == 0);
+    std::remove(rlePath);
+
+    // Two-state matrix: no rule and no states
+    const char* matrixPath = "test_pattern.txt";
+    fileIO.saveGrid(many.toGrid(), matrixPath);
+    LoadedPattern fromMatrix = fileIO.loadPattern(matrixPath);
+    REQUIRE(fromMatrix.rule.empty());
+    REQUIRE_FALSE(fromMatrix.states);
+    REQUIRE(*fromMatrix.grid == many.toGrid());
+    std::remove(matrixPath);
+
+    // Snapshots bring back where the run stopped
+    const char* snapshotPath = "test_pattern.golz";
+    CompressedSnapshot::save(many.toGrid(), snapshotPath, Rule::parse("highlife"), 321, true, 2);
+    LoadedPattern fromSnapshot = fileIO.loadPattern(snapshotPath, 2);
+    REQUIRE(Rule::parse(fromSnapshot.rule) == Rule::parse("B36/S23"));
+    REQUIRE_FALSE(fromSnapshot.states);
+    REQUIRE(*fromSnapshot.grid == many.toGrid());
+    REQUIRE(fromSnapshot.generation == 321);
+    REQUIRE(fromSnapshot.toroidal);
+    std::remove(snapshotPath);
+}
@@ -168,6 +168,31 @@ TEST_CASE("Grid copy and equality", "[grid]") {
         grid2.setCell(2, 2, false);
         REQUIRE(grid2 != grid1);
     }
+    
+    SECTION("Moves leave an empty grid behind") {
+        Grid copy(grid1);
+        Grid moved(std::move(grid1));
+        REQUIRE(moved == copy);
+        REQUIRE(grid1.getRows() == 0);
+        REQUIRE(grid1.getCols() == 0);
+        REQUIRE(grid1.countLiving() == 0);
+        REQUIRE_THROWS_AS(grid1.getCell(0, 0), std::out_of_range);
+        
+        Grid target(3, 3);
+        target = std::move(moved);
+        REQUIRE(target == copy);
+        REQUIRE(moved.getRows() == 0);
+        REQUIRE(moved.countLiving() == 0);
+        
+        // Self-move keeps the cells
+        Grid& alias = target;
+        target = std::move(alias);
+        REQUIRE(target == copy);
+        
+        // Moved-from grids can be assigned again
+        grid1 = copy;
+        REQUIRE(grid1 == copy);
+    }
 }
 
 TEST_CASE("Grid file I/O", "[grid][io]") {
@@ -213,3 +238,34 @@ TEST_CASE("Grid toString", "[grid]") {
         REQUIRE(str.find("█") != std::string::npos);
     }
 }
+
+TEST_CASE("Grid bit-packed word layout", "[grid][words]") {
+    Grid grid(3, 70);
+    
+    SECTION("Rows are padded to whole 64-bit words") {
+        REQUIRE(grid.getWordsPerRow() == 2);
+        REQUIRE(grid.wordCount() == 6);
+        REQUIRE(grid.lastWordMask() == ((Grid::Word{1} << 6) - 1));
+    }
+    
+    SECTION("Cells map to bits of their row's words") {
+        grid.setCell(1, 0, true);
+        grid.setCell(1, 65, true);
+        REQUIRE(grid.rowWords(1)[0] == 1);
+        REQUIRE(grid.rowWords(1)[1] == (Grid::Word{1} << 1));
+        REQUIRE(grid.rowWords(0)[0] == 0);
+        REQUIRE(grid.rowWords(2)[1] == 0);
+    }
+    
+    SECTION("Counting and equality see word writes") {
+        grid.rowWords(2)[0] = 0xFF;
+        REQUIRE(grid.countLiving() == 8);
+        REQUIRE(grid.getCell(2, 7) == true);
+        
+        Grid other(3, 70);
+        for (int col = 0; col < 8; ++col) {
+            other.setCell(2, col, true);
+        }
+        REQUIRE(other == grid);
+    }
+}
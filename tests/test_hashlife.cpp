@@ -0,0 +1,225 @@
+/**
+ * @file test_hashlife.cpp
+ * @brief Tests for the memoized quadtree (HashLife) engine
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "../Grid.hpp"
+#include "../GameEngine.hpp"
+#include "../TextFileIO.hpp"
+#include "../include/HashLife.hpp"
+#include "TestHelpers.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Random soup in the middle of an otherwise empty grid, far from the edges
+Grid centredSoup(int size, int soupSize, unsigned seed) {
+    Grid grid(size, size);
+    Grid soup = randomGrid(soupSize, soupSize, 0.4, seed);
+    int offset = (size - soupSize) / 2;
+    for (int row = 0; row < soupSize; ++row) {
+        for (int col = 0; col < soupSize; ++col) {
+            grid.setCell(offset + row, offset + col, soup.getCell(row, col));
+        }
+    }
+    return grid;
+}
+
+Grid placeCells(int rows, int cols, std::initializer_list<std::pair<int, int>> cells) {
+    Grid grid(rows, cols);
+    for (auto [row, col] : cells) {
+        grid.setCell(row, col, true);
+    }
+    return grid;
+}
+
+} // namespace
+
+TEST_CASE("HashLife round-trips a grid", "[hashlife]") {
+    Grid start = centredSoup(100, 70, 3u);
+    HashLifeEngine engine(start);
+
+    REQUIRE(engine.toGrid() == start);
+    REQUIRE(engine.getPopulation() == static_cast<std::uint64_t>(start.countLiving()));
+    REQUIRE(engine.getCell(50, 50) == start.getCell(50, 50));
+    REQUIRE_FALSE(engine.getCell(-5, 1000));
+}
+
+TEST_CASE("HashLife matches the grid engine away from the edges", "[hashlife]") {
+    // 48 generations cannot reach the border of the 256x256 grid from the
+    // 64x64 soup, so bounded and unbounded evolution agree exactly
+    Grid start = centredSoup(256, 64, 11u);
+
+    SECTION("Single steps") {
+        GameEngine reference(start, false);
+        HashLifeEngine hashlife(start);
+        for (int gen = 0; gen < 48; ++gen) {
+            reference.step();
+            hashlife.step();
+            REQUIRE(hashlife.toGrid() == reference.getCurrentGrid());
+        }
+        REQUIRE(hashlife.getGeneration() == 48);
+    }
+
+    SECTION("Power-of-two and mixed jumps") {
+        GameEngine reference(start, false);
+        HashLifeEngine hashlife(start);
+        for (int gen = 0; gen < 32; ++gen) {
+            reference.step();
+        }
+        hashlife.stepPow2(5);
+        REQUIRE(hashlife.toGrid() == reference.getCurrentGrid());
+
+        for (int gen = 0; gen < 13; ++gen) {
+            reference.step();
+        }
+        hashlife.stepBy(13);
+        REQUIRE(hashlife.getGeneration() == 45);
+        REQUIRE(hashlife.toGrid() == reference.getCurrentGrid());
+    }
+}
+
+TEST_CASE("HashLife fast-forwards methuselahs", "[hashlife]") {
+    SECTION("R-pentomino settles to 116 cells") {
+        HashLifeEngine engine(placeCells(8, 8, {{2, 3}, {2, 4}, {3, 2}, {3, 3}, {4, 3}}));
+        engine.stepBy(2000);
+        REQUIRE(engine.getGeneration() == 2000);
+        REQUIRE(engine.getPopulation() == 116);
+    }
+
+    SECTION("Acorn settles to 633 cells with a tiny node budget") {
+        HashLifeEngine engine(placeCells(8, 8, {{1, 2}, {2, 4}, {3, 1}, {3, 2}, {3, 5}, {3, 6}, {3, 7}}));
+        engine.setNodeLimit(20000);  // Forces repeated garbage collection
+        engine.stepBy(5206);
+        REQUIRE(engine.getPopulation() == 633);
+
+        std::size_t before = engine.getNodeCount();
+        engine.collectGarbage();
+        REQUIRE(engine.getNodeCount() <= before);
+        engine.stepPow2(10);
+        REQUIRE(engine.getPopulation() == 633);
+    }
+}
+
+TEST_CASE("HashLife jumps far ahead in few node operations", "[hashlife]") {
+    // A glider returns to its shape every 4 generations, shifted by (1, 1)
+    Grid start = placeCells(8, 8, {{0, 1}, {1, 2}, {2, 0}, {2, 1}, {2, 2}});
+    HashLifeEngine engine(start);
+    engine.stepPow2(40);
+
+    std::int64_t shift = (std::int64_t{1} << 40) / 4;
+    REQUIRE(engine.getPopulation() == 5);
+    REQUIRE(engine.toGrid(8, 8, shift, shift) == start);
+    REQUIRE(engine.getNodeCount() < 10000);
+}
+
+TEST_CASE("HashLife handles empty universes and bad arguments", "[hashlife]") {
+    HashLifeEngine engine(Grid(16, 16));
+    engine.stepBy(1000);
+    REQUIRE(engine.getGeneration() == 1000);
+    REQUIRE(engine.getPopulation() == 0);
+    REQUIRE(engine.toGrid().countLiving() == 0);
+
+    REQUIRE_THROWS_AS(engine.stepPow2(-1), std::invalid_argument);
+    REQUIRE_THROWS_AS(engine.stepPow2(100), std::invalid_argument);
+    REQUIRE_THROWS_AS(HashLifeEngine().toGrid(), std::logic_error);
+}
+
+TEST_CASE("HashLife reads Golly macrocell files centred on the origin", "[hashlife][io]") {
+    std::istringstream file("[M2] (golly 4.2)\r\n#R B3/S23\r\n#G 12\r\n#C a glider\r\n.*$..*$***$\r\n4 1 0 0 0\r\n");
+    HashLifeEngine engine;
+    REQUIRE(engine.readMacrocell(file) == "B3/S23");
+    REQUIRE(engine.getGeneration() == 12);
+    REQUIRE(engine.getPopulation() == 5);
+
+    // The 16x16 root spans [-8, 8), so the leaf in its north-west quadrant starts at -8
+    HashLifeEngine::Bounds bounds = engine.getBounds();
+    REQUIRE(bounds.top == -8);
+    REQUIRE(bounds.left == -8);
+    REQUIRE(bounds.rows == 3);
+    REQUIRE(bounds.cols == 3);
+    REQUIRE(engine.toGrid(3, 3, -8, -8) == placeCells(3, 3, {{0, 1}, {1, 2}, {2, 0}, {2, 1}, {2, 2}}));
+
+    engine.stepBy(4);
+    REQUIRE(engine.getBounds().top == -7);
+    REQUIRE(engine.getBounds().left == -7);
+}
+
+TEST_CASE("Macrocell files round-trip positions, generations and grids", "[hashlife][io]") {
+    Grid start = centredSoup(200, 90, 5u);
+    HashLifeEngine engine(start);
+    engine.stepPow2(6);
+
+    std::stringstream file;
+    engine.writeMacrocell(file, "B3/S23");
+    HashLifeEngine loaded;
+    REQUIRE(loaded.readMacrocell(file) == "B3/S23");
+    REQUIRE(loaded.getGeneration() == 64);
+    REQUIRE(loaded.getPopulation() == engine.getPopulation());
+    HashLifeEngine::Bounds bounds = engine.getBounds();
+    REQUIRE(loaded.getBounds().top == bounds.top);
+    REQUIRE(loaded.getBounds().left == bounds.left);
+    REQUIRE(loaded.toGrid(300, 300, -50, -50) == engine.toGrid(300, 300, -50, -50));
+
+    // Through TextFileIO: the grid keeps its place, loadGrid() cuts the live rectangle
+    const std::string path = "test_hashlife.mc";
+    TextFileIO fileIO;
+    fileIO.saveGrid(start, path, Rule::parse("highlife"));
+    REQUIRE(fileIO.loadRule(path) == "B36/S23");
+    REQUIRE(fileIO.loadMacrocell(path)->toGrid(200, 200, 0, 0) == start);
+    std::unique_ptr<Grid> window = fileIO.loadGrid(path);
+    REQUIRE(window->getRows() <= 90);
+    REQUIRE(window->countLiving() == start.countLiving());
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Macrocell files keep shared structure shared", "[hashlife][io]") {
+    // A diagonal line of blocks 2^40 cells long, written in 38 lines
+    std::string text = "[M2]\n**$**$\n";
+    for (int level = 4; level <= 40; ++level) {
+        text += std::to_string(level) + " " + std::to_string(level - 3) + " 0 0 " + std::to_string(level - 3) + "\n";
+    }
+    std::istringstream file(text);
+    HashLifeEngine engine;
+    engine.readMacrocell(file);
+    REQUIRE(engine.getPopulation() == (std::uint64_t{1} << 39));
+    REQUIRE(engine.getNodeCount() < 1000);
+    HashLifeEngine::Bounds bounds = engine.getBounds();
+    REQUIRE(bounds.top == -(std::int64_t{1} << 39));
+    REQUIRE(bounds.rows == (std::int64_t{1} << 40) - 6);
+    REQUIRE(engine.getCell(0, 0));
+    REQUIRE_FALSE(engine.getCell(0, 2));
+
+    std::stringstream copy;
+    engine.writeMacrocell(copy, "");
+    REQUIRE(copy.str().size() < 1000);
+
+    const std::string path = "test_hashlife.mc";
+    std::ofstream(path) << text;
+    REQUIRE(TextFileIO().loadMacrocell(path)->getPopulation() == (std::uint64_t{1} << 39));
+    REQUIRE_THROWS_AS(TextFileIO().loadGrid(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Malformed macrocell files are rejected", "[hashlife][io]") {
+    for (const char* text : {"x = 3, y = 3\n", "[M2]\n4 1 0 0 0\n", "[M2]\n.*$\n5 1 0 0 0\n",
+                             "[M2]\n.........$\n", "[M2]\n1 0 2 0 1\n", "[M2]\n.*$\n4 1 0 0\n",
+                             "[M2]\n#G soon\n", "[M2]\n99 0 0 0 0\n", "[M2]\n.x$\n"}) {
+        std::istringstream file(text);
+        HashLifeEngine engine;
+        REQUIRE_THROWS_AS(engine.readMacrocell(file), std::runtime_error);
+    }
+
+    // An empty universe writes just the header and reads back empty
+    HashLifeEngine empty;
+    std::stringstream file;
+    empty.writeMacrocell(file, "B3/S23");
+    HashLifeEngine loaded;
+    loaded.readMacrocell(file);
+    REQUIRE(loaded.getPopulation() == 0);
+    REQUIRE(loaded.getBounds().rows == 0);
+}
@@ -0,0 +1,331 @@
+/**
+ * @file test_kernels.cpp
+ * @brief Cross-checks the optimized generation kernels against the reference engine
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "../Grid.hpp"
+#include "../GameEngine.hpp"
+#include "../include/LifeKernels.hpp"
+#include "TestHelpers.hpp"
+
+namespace {
+
+// Runs both engines side by side and requires identical grids every generation
+void requireSameAsReference(const Grid& start, bool toroidal,
+                            GameEngine::Backend backend, int generations,
+                            const Rule& rule = Rule()) {
+    GameEngine reference(start, toroidal);
+    reference.setBackend(GameEngine::Backend::Reference);
+    reference.setRule(rule);
+    GameEngine candidate(start, toroidal);
+    candidate.setBackend(backend);
+    candidate.setRule(rule);
+
+    for (int gen = 0; gen < generations; ++gen) {
+        reference.step();
+        candidate.step();
+        REQUIRE(candidate.getCurrentGrid() == reference.getCurrentGrid());
+        REQUIRE(candidate.isStable() == reference.isStable());
+    }
+}
+
+} // namespace
+
+TEST_CASE("Bit-parallel kernel matches reference", "[kernels][bitparallel]") {
+    // Widths around word boundaries exercise the wrap and padding logic
+    const int widths[] = {1, 2, 3, 63, 64, 65, 127, 128, 130};
+
+    for (int cols : widths) {
+        for (bool toroidal : {false, true}) {
+            Grid start = randomGrid(17, cols, 0.35, 1000u + cols);
+            requireSameAsReference(start, toroidal, GameEngine::Backend::BitParallel, 12);
+        }
+    }
+}
+
+TEST_CASE("Bit-parallel kernel handles degenerate heights", "[kernels][bitparallel]") {
+    for (int rows : {1, 2, 3}) {
+        for (bool toroidal : {false, true}) {
+            Grid start = randomGrid(rows, 70, 0.5, 7u + rows);
+            requireSameAsReference(start, toroidal, GameEngine::Backend::BitParallel, 6);
+        }
+    }
+}
+
+TEST_CASE("Glider wraps around a toroidal word boundary", "[kernels][toroidal]") {
+    Grid start(8, 64);
+    start.setCell(0, 62, true);
+    start.setCell(1, 63, true);
+    start.setCell(2, 61, true);
+    start.setCell(2, 62, true);
+    start.setCell(2, 63, true);
+
+    GameEngine engine(start, true);
+    engine.setBackend(GameEngine::Backend::BitParallel);
+    // A glider moves (1, 1) every 4 generations, so 4 * 64 generations
+    // carry it exactly around the 8x64 torus in both directions
+    for (int gen = 0; gen < 4 * 64; ++gen) {
+        engine.step();
+    }
+    REQUIRE(engine.getCurrentGrid() == start);
+}
+
+TEST_CASE("Every supported SIMD kernel matches reference", "[kernels][simd]") {
+    std::string report;
+    REQUIRE(LifeKernels::selfCheck(&report));
+    INFO(report);
+
+    LifeKernels::Isa detected = LifeKernels::activeIsa();
+    for (auto isa : {LifeKernels::Isa::Scalar, LifeKernels::Isa::Avx2, LifeKernels::Isa::Avx512}) {
+        if (!LifeKernels::setActiveIsa(isa)) {
+            continue;
+        }
+        for (bool toroidal : {false, true}) {
+            Grid start = randomGrid(24, 1000, 0.3, 99u);
+            requireSameAsReference(start, toroidal, GameEngine::Backend::BitParallel, 4);
+        }
+    }
+    LifeKernels::setActiveIsa(detected);
+}
+
+TEST_CASE("Multi-threaded step is bit-identical to serial", "[kernels][threads]") {
+    for (int threads : {2, 3, 8}) {
+        for (bool toroidal : {false, true}) {
+            Grid start = randomGrid(203, 333, 0.4, 31u + threads);
+            GameEngine serial(start, toroidal);
+            GameEngine parallel(start, toroidal);
+            parallel.setThreadCount(threads);
+            REQUIRE(parallel.getThreadCount() == threads);
+            
+            for (int gen = 0; gen < 20; ++gen) {
+                serial.step();
+                parallel.step();
+                REQUIRE(parallel.getCurrentGrid() == serial.getCurrentGrid());
+            }
+        }
+    }
+}
+
+TEST_CASE("Every backend follows B/S rules", "[kernels][rules]") {
+    // Specialised kernels, generic table kernels, and B0 rules whose
+    // background flips every generation
+    const char* rules[] = {"B36/S23", "B3678/S34678", "B2/S", "B1357/S1357",
+                           "B35/S236", "B0/S8", "B013/S0124568"};
+    for (const char* text : rules) {
+        Rule rule = Rule::parse(text);
+        INFO(text << (LifeKernels::isSpecialized(rule) ? " (specialised)" : " (generic)"));
+        for (bool toroidal : {false, true}) {
+            Grid start = randomGrid(70, 150, 0.3, 77u);
+            requireSameAsReference(start, toroidal, GameEngine::Backend::BitParallel, 8, rule);
+            requireSameAsReference(start, toroidal, GameEngine::Backend::Tiled, 8, rule);
+            requireSameAsReference(start, toroidal, GameEngine::Backend::Lookup, 8, rule);
+            requireSameAsReference(start, toroidal, GameEngine::Backend::Incremental, 8, rule);
+        }
+    }
+    
+    REQUIRE(LifeKernels::isSpecialized(Rule()));
+    REQUIRE(LifeKernels::isSpecialized(Rule::parse("highlife")));
+    REQUIRE_FALSE(LifeKernels::isSpecialized(Rule::parse("B35/S236")));
+}
+
+TEST_CASE("Lookup-table kernel matches reference", "[kernels][lookup]") {
+    // Odd heights leave a final row without a partner in its 2x2 blocks
+    const int widths[] = {1, 2, 3, 63, 64, 65, 127, 128, 130};
+    for (int cols : widths) {
+        for (int rows : {1, 2, 3, 17}) {
+            for (bool toroidal : {false, true}) {
+                Grid start = randomGrid(rows, cols, 0.35, 500u + cols * 7 + rows);
+                requireSameAsReference(start, toroidal, GameEngine::Backend::Lookup, 10);
+            }
+        }
+    }
+    
+    SECTION("Multi-threaded bands of odd height") {
+        Grid start = randomGrid(203, 333, 0.4, 91u);
+        GameEngine serial(start, true);
+        GameEngine parallel(start, true);
+        parallel.setBackend(GameEngine::Backend::Lookup);
+        parallel.setThreadCount(3);
+        for (int gen = 0; gen < 20; ++gen) {
+            serial.step();
+            parallel.step();
+            REQUIRE(parallel.getCurrentGrid() == serial.getCurrentGrid());
+        }
+    }
+    
+    SECTION("Table entries") {
+        const LifeKernels::BlockTable& table = LifeKernels::blockTable(Rule());
+        REQUIRE(table[0] == 0);
+        REQUIRE(table[0xFFFF] == 0);           // Every centre cell is overcrowded
+        REQUIRE(table[0x0660] == 0xF);         // Block still life
+        REQUIRE(table[0x0070] == 0x5);         // Blinker turning vertical in the left centre column
+        REQUIRE(&LifeKernels::blockTable(Rule::parse("highlife")) ==
+                &LifeKernels::blockTable(Rule::parse("B36/S23")));
+    }
+}
+
+TEST_CASE("Tiled backend matches reference", "[kernels][tiled]") {
+    for (bool toroidal : {false, true}) {
+        SECTION(toroidal ? "Toroidal soup" : "Bounded soup") {
+            Grid start = randomGrid(150, 200, 0.3, 5u);
+            requireSameAsReference(start, toroidal, GameEngine::Backend::Tiled, 60);
+        }
+    }
+    
+    SECTION("Multi-threaded with external edits between steps") {
+        Grid start = randomGrid(130, 260, 0.05, 8u);
+        GameEngine reference(start, true);
+        reference.setBackend(GameEngine::Backend::Reference);
+        GameEngine tiled(start, true);
+        tiled.setBackend(GameEngine::Backend::Tiled);
+        tiled.setThreadCount(4);
+        
+        for (int gen = 0; gen < 40; ++gen) {
+            if (gen % 10 == 5) {
+                // Edits outside the engine must re-activate the affected tiles
+                reference.getCurrentGridMutable().toggleCell(gen, 3 * gen);
+                tiled.getCurrentGridMutable().toggleCell(gen, 3 * gen);
+            }
+            reference.step();
+            tiled.step();
+            REQUIRE(tiled.getCurrentGrid() == reference.getCurrentGrid());
+        }
+    }
+}
+
+TEST_CASE("Tiled backend only visits active regions", "[kernels][tiled]") {
+    Grid start(512, 512);
+    // Lone blinker far from everything else
+    start.setCell(200, 199, true);
+    start.setCell(200, 200, true);
+    start.setCell(200, 201, true);
+    
+    GameEngine engine(start);
+    engine.setBackend(GameEngine::Backend::Tiled);
+    engine.step();
+    REQUIRE(engine.getActiveTileCount() == 64);  // First step sees every tile
+    
+    for (int gen = 0; gen < 3; ++gen) {
+        engine.step();
+        REQUIRE(engine.getActiveTileCount() <= 9);
+    }
+    REQUIRE(engine.getCurrentGrid() == start);
+}
+
+TEST_CASE("Incremental backend matches reference", "[kernels][incremental]") {
+    // Narrow grids wrap a changed edge word onto itself
+    for (int cols : {1, 63, 64, 65, 130, 200}) {
+        for (int rows : {1, 2, 37}) {
+            for (bool toroidal : {false, true}) {
+                Grid start = randomGrid(rows, cols, 0.3, 700u + cols + rows);
+                requireSameAsReference(start, toroidal, GameEngine::Backend::Incremental, 40);
+            }
+        }
+    }
+    
+    SECTION("Multi-threaded with external edits between steps") {
+        Grid start = randomGrid(300, 700, 0.3, 9u);
+        GameEngine reference(start, true);
+        reference.setBackend(GameEngine::Backend::Reference);
+        GameEngine incremental(start, true);
+        incremental.setBackend(GameEngine::Backend::Incremental);
+        incremental.setThreadCount(4);
+        
+        for (int gen = 0; gen < 40; ++gen) {
+            if (gen % 10 == 5) {
+                // Edits outside the engine must force a full pass
+                reference.getCurrentGridMutable().toggleCell(gen, 3 * gen);
+                incremental.getCurrentGridMutable().toggleCell(gen, 3 * gen);
+            }
+            reference.step();
+            incremental.step();
+            REQUIRE(incremental.getCurrentGrid() == reference.getCurrentGrid());
+        }
+    }
+}
+
+TEST_CASE("Change list holds exactly the flipped cells", "[kernels][incremental]") {
+    Grid start(300, 200);
+    // Blinker across a word boundary, block still life, glider near a corner
+    start.setCell(10, 63, true);
+    start.setCell(10, 64, true);
+    start.setCell(10, 65, true);
+    start.setCell(100, 100, true);
+    start.setCell(100, 101, true);
+    start.setCell(101, 100, true);
+    start.setCell(101, 101, true);
+    start.setCell(290, 190, true);
+    start.setCell(291, 191, true);
+    start.setCell(292, 189, true);
+    start.setCell(292, 190, true);
+    start.setCell(292, 191, true);
+    
+    for (auto backend : {GameEngine::Backend::Incremental, GameEngine::Backend::BitParallel}) {
+        for (bool toroidal : {false, true}) {
+            GameEngine engine(start, toroidal);
+            engine.setBackend(backend);
+            engine.setChangeTracking(backend != GameEngine::Backend::Incremental);
+            for (int gen = 0; gen < 30; ++gen) {
+                Grid before = engine.getCurrentGrid();
+                engine.step();
+                const Grid& after = engine.getCurrentGrid();
+                
+                // Rebuild the new generation from the deltas alone, checking order and direction
+                const auto& changes = engine.getChanges();
+                for (std::size_t i = 0; i < changes.size(); ++i) {
+                    const GameEngine::CellChange& change = changes[i];
+                    REQUIRE(before.getCell(change.row, change.col) != change.alive);
+                    before.setCell(change.row, change.col, change.alive);
+                    if (i > 0) {
+                        REQUIRE(std::pair(changes[i - 1].row, changes[i - 1].col) <
+                                std::pair(change.row, change.col));
+                    }
+                }
+                REQUIRE(before == after);
+                REQUIRE(engine.hasCompleteChanges() == (gen > 0));  // The first step follows construction
+                REQUIRE(engine.isStable() == changes.empty());
+            }
+        }
+    }
+    
+    SECTION("Edits make the next change list incomplete") {
+        GameEngine engine(start, false);
+        engine.setBackend(GameEngine::Backend::Incremental);
+        engine.step();
+        engine.step();
+        REQUIRE(engine.hasCompleteChanges());
+        engine.getCurrentGridMutable().setCell(50, 50, true);
+        REQUIRE_FALSE(engine.hasCompleteChanges());
+        engine.step();
+        REQUIRE_FALSE(engine.hasCompleteChanges());
+        engine.step();
+        REQUIRE(engine.hasCompleteChanges());
+        
+        GameEngine untracked(start, false);
+        untracked.step();
+        untracked.step();
+        REQUIRE(untracked.getChanges().empty());
+        REQUIRE_FALSE(untracked.hasCompleteChanges());
+    }
+}
+
+TEST_CASE("Incremental backend only visits words around changes", "[kernels][incremental]") {
+    Grid start(512, 512);
+    // Lone blinker far from everything else
+    start.setCell(200, 199, true);
+    start.setCell(200, 200, true);
+    start.setCell(200, 201, true);
+    
+    GameEngine engine(start);
+    engine.setBackend(GameEngine::Backend::Incremental);
+    engine.step();
+    REQUIRE(engine.getActiveWordCount() == 512 * 8);  // First step sees every word
+    
+    for (int gen = 0; gen < 3; ++gen) {
+        engine.step();
+        REQUIRE(engine.getActiveWordCount() <= 5);  // Rows 199-201 (or 198-202) of one word
+        REQUIRE(engine.getChanges().size() == 4);
+    }
+    REQUIRE(engine.getCurrentGrid() == start);
+}
@@ -0,0 +1,114 @@
+/**
+ * @file test_ltl.cpp
+ * @brief Tests for Larger-than-Life rules and the radius-R engine
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "../Grid.hpp"
+#include "../GameEngine.hpp"
+#include "../include/LargerThanLife.hpp"
+#include "TestHelpers.hpp"
+
+namespace {
+
+// Next generation with every count summed directly, O(R^2) per cell
+Grid directStep(const LargerThanLifeEngine& engine) {
+    const Grid& current = engine.getCurrentGrid();
+    Grid next(current.getRows(), current.getCols());
+    for (int row = 0; row < current.getRows(); ++row) {
+        for (int col = 0; col < current.getCols(); ++col) {
+            next.setCell(row, col, engine.getRule().nextState(current.getCell(row, col),
+                                                              engine.countNeighbors(row, col)));
+        }
+    }
+    return next;
+}
+
+} // namespace
+
+TEST_CASE("Larger-than-Life rule notation", "[ltl][rules]") {
+    LargerThanLifeRule bosco = LargerThanLifeRule::parse("R5,C0,M1,S34..58,B34..45,NM");
+    REQUIRE(bosco.getRadius() == 5);
+    REQUIRE(bosco.countsMiddle());
+    REQUIRE(bosco.getNeighborhood() == LargerThanLifeRule::Neighborhood::Moore);
+    REQUIRE(bosco.getSurvivalMin() == 34);
+    REQUIRE(bosco.getBirthMax() == 45);
+    REQUIRE(bosco.getNeighborhoodSize() == 121);
+    REQUIRE(bosco.toString() == "R5,C0,M1,S34..58,B34..45,NM");
+    REQUIRE(LargerThanLifeRule::parse("Bosco") == bosco);
+
+    LargerThanLifeRule diamond = LargerThanLifeRule::parse("r3, s4..9, b5, nn");
+    REQUIRE(diamond.getNeighborhood() == LargerThanLifeRule::Neighborhood::VonNeumann);
+    REQUIRE_FALSE(diamond.countsMiddle());
+    REQUIRE(diamond.getNeighborhoodSize() == 24);
+    REQUIRE(diamond.toString() == "R3,C0,M0,S4..9,B5..5,NN");
+    REQUIRE(LargerThanLifeRule::parse("R1,C0,M0,S2..3,B3..3,NM") == LargerThanLifeRule());
+
+    REQUIRE_THROWS_AS(LargerThanLifeRule::parse("R11,C0,M0,S2..3,B3..3,NM"), std::invalid_argument);
+    REQUIRE_THROWS_AS(LargerThanLifeRule::parse("R0,S2..3,B3"), std::invalid_argument);
+    REQUIRE_THROWS_AS(LargerThanLifeRule::parse("R2,C3,S2..3,B3"), std::invalid_argument);
+    REQUIRE_THROWS_AS(LargerThanLifeRule::parse("R1,S2..9,B3"), std::invalid_argument);  // Only 8 neighbours
+    REQUIRE_THROWS_AS(LargerThanLifeRule::parse("R1,S5..3,B3"), std::invalid_argument);
+    REQUIRE_THROWS_AS(LargerThanLifeRule::parse("R1,S2..3"), std::invalid_argument);
+    REQUIRE_THROWS_AS(LargerThanLifeRule::parse("R1,R2,S2..3,B3"), std::invalid_argument);
+    REQUIRE_THROWS_AS(LargerThanLifeRule::parse("R1,S2..3,B3,NX"), std::invalid_argument);
+}
+
+TEST_CASE("Radius 1 Moore rule is Conway's Life", "[ltl]") {
+    for (bool toroidal : {false, true}) {
+        Grid start = randomGrid(40, 70, 0.35, 12u);
+        GameEngine life(start, toroidal);
+        LargerThanLifeEngine ltl(start, LargerThanLifeRule(), toroidal);
+        for (int gen = 0; gen < 20; ++gen) {
+            life.step();
+            ltl.step();
+            REQUIRE(ltl.getCurrentGrid() == life.getCurrentGrid());
+            REQUIRE(ltl.isStable() == life.isStable());
+        }
+    }
+}
+
+TEST_CASE("Sliding counts match direct sums for every radius", "[ltl]") {
+    const char* rules[] = {
+        "R2,C0,M0,S5..10,B6..9,NM",
+        "R5,C0,M1,S34..58,B34..45,NM",
+        "R10,C0,M1,S150..260,B140..210,NM",
+        "R1,C0,M1,S2..3,B2..3,NN",
+        "R3,C0,M0,S4..9,B5..8,NN",
+        "R10,C0,M0,S60..130,B70..110,NN",
+    };
+    for (const char* text : rules) {
+        LargerThanLifeRule rule = LargerThanLifeRule::parse(text);
+        // Small grids make the toroidal halo wrap more than once
+        for (auto [rows, cols] : {std::pair{37, 45}, std::pair{6, 9}}) {
+            for (bool toroidal : {false, true}) {
+                INFO(text << " on " << rows << "x" << cols << (toroidal ? ", toroidal" : ""));
+                LargerThanLifeEngine engine(randomGrid(rows, cols, 0.45, 3u + cols), rule, toroidal);
+                for (int gen = 0; gen < 6; ++gen) {
+                    Grid expected = directStep(engine);
+                    engine.step();
+                    REQUIRE(engine.getCurrentGrid() == expected);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Larger-than-Life row bands run in parallel", "[ltl][threads]") {
+    for (const char* text : {"bosco", "R4,C0,M1,S10..25,B12..20,NN"}) {
+        LargerThanLifeRule rule = LargerThanLifeRule::parse(text);
+        Grid start = randomGrid(203, 150, 0.4, 8u);
+        LargerThanLifeEngine serial(start, rule, true);
+        LargerThanLifeEngine parallel(start, rule, true);
+        parallel.setThreadCount(3);
+        REQUIRE(parallel.getThreadCount() == 3);
+        for (int gen = 0; gen < 10; ++gen) {
+            serial.step();
+            parallel.step();
+            REQUIRE(parallel.getCurrentGrid() == serial.getCurrentGrid());
+        }
+    }
+
+    LargerThanLifeEngine engine(Grid(10, 10), LargerThanLifeRule(), false);
+    REQUIRE_THROWS_AS(engine.setCurrentGrid(Grid(10, 11)), std::invalid_argument);
+}
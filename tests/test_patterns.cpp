@@ -0,0 +1,272 @@
+/**
+ * @file test_patterns.cpp
+ * @brief Tests for the engine's state hash and PatternDetector
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "../Grid.hpp"
+#include "../GameEngine.hpp"
+#include "../include/GridHash.hpp"
+#include "../include/PatternCensus.hpp"
+#include "../include/PatternDetector.hpp"
+#include "../include/PatternLibrary.hpp"
+#include "TestHelpers.hpp"
+#include <random>
+#include <vector>
+
+namespace {
+
+// Runs the detector on a library pattern centred in a bounded grid
+PatternDetector runPattern(const std::string& name, int generations, bool verify, bool tracking = true) {
+    PatternLibrary library;
+    Grid grid(40, 40);
+    library.insertPattern(grid, name, 14, 14);
+    GameEngine engine(grid);
+    engine.setChangeTracking(tracking);
+    PatternDetector detector;
+    detector.setVerifyMatches(verify);
+    detector.update(engine);
+    for (int gen = 0; gen < generations; ++gen) {
+        engine.step();
+        detector.update(engine);
+    }
+    return detector;
+}
+
+// Islands of live cells within two cells of each other by flood fill
+int floodFillIslands(const Grid& grid) {
+    int rows = grid.getRows();
+    int cols = grid.getCols();
+    std::vector<char> seen(static_cast<std::size_t>(rows) * cols, 0);
+    std::vector<std::pair<int, int>> stack;
+    int islands = 0;
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            if (!grid.getCell(row, col) || seen[row * cols + col]) {
+                continue;
+            }
+            ++islands;
+            seen[row * cols + col] = 1;
+            stack.push_back({row, col});
+            while (!stack.empty()) {
+                auto [r, c] = stack.back();
+                stack.pop_back();
+                for (int dr = -2; dr <= 2; ++dr) {
+                    for (int dc = -2; dc <= 2; ++dc) {
+                        int nr = r + dr;
+                        int nc = c + dc;
+                        if (nr >= 0 && nr < rows && nc >= 0 && nc < cols &&
+                            grid.getCell(nr, nc) && !seen[nr * cols + nc]) {
+                            seen[nr * cols + nc] = 1;
+                            stack.push_back({nr, nc});
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return islands;
+}
+
+// Stamps rows of '#' / '.' with the top-left corner at (row, col)
+void stamp(Grid& grid, int row, int col, const std::vector<std::string>& cells) {
+    for (std::size_t r = 0; r < cells.size(); ++r) {
+        for (std::size_t c = 0; c < cells[r].size(); ++c) {
+            grid.setCell(row + static_cast<int>(r), col + static_cast<int>(c), cells[r][c] == '#');
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("GridHash follows word replacements", "[patterns][hash]") {
+    Grid grid = randomGrid(37, 150, 0.3, 3u);
+    GridHash hash = GridHash::of(grid);
+    REQUIRE(GridHash::of(Grid(37, 150)) == GridHash{});
+
+    std::mt19937 rng(9);
+    for (int edit = 0; edit < 200; ++edit) {
+        int row = static_cast<int>(rng() % 37);
+        int col = static_cast<int>(rng() % 150);
+        std::size_t index = static_cast<std::size_t>(row) * grid.getWordsPerRow() + col / Grid::kWordBits;
+        Grid::Word before = grid.data()[index];
+        grid.toggleCell(row, col);
+        hash.replaceWord(index, before, grid.data()[index]);
+        REQUIRE(hash == GridHash::of(grid));
+    }
+
+    // The same cells in another word hash differently
+    Grid shifted(37, 150);
+    shifted.setCell(0, 0, true);
+    Grid moved(37, 150);
+    moved.setCell(1, 0, true);
+    REQUIRE_FALSE(GridHash::of(shifted) == GridHash::of(moved));
+}
+
+TEST_CASE("Engine state hash matches a rehash after every step", "[patterns][hash]") {
+    const GameEngine::Backend backends[] = {
+        GameEngine::Backend::Reference,
+        GameEngine::Backend::BitParallel,
+        GameEngine::Backend::Tiled,
+        GameEngine::Backend::Lookup,
+        GameEngine::Backend::Incremental
+    };
+    Grid start = randomGrid(90, 130, 0.3, 5u);
+    for (auto backend : backends) {
+        for (bool tracking : {false, true}) {
+            INFO("backend " << GameEngine::backendName(backend) << ", tracking " << tracking);
+            GameEngine engine(start, true);
+            engine.setBackend(backend);
+            engine.setChangeTracking(tracking);
+            for (int gen = 0; gen < 20; ++gen) {
+                if (gen == 8) {
+                    engine.getCurrentGridMutable().toggleCell(3, 100);
+                }
+                REQUIRE(engine.getStateHash() == GridHash::of(engine.getCurrentGrid()));
+                engine.step();
+            }
+            REQUIRE(engine.getStateHash() == GridHash::of(engine.getCurrentGrid()));
+        }
+    }
+}
+
+TEST_CASE("PatternDetector finds still lifes and oscillator periods", "[patterns]") {
+    for (bool verify : {false, true}) {
+        INFO("verify " << verify);
+        PatternDetector block = runPattern("block", 5, verify);
+        REQUIRE(block.getPatternType() == PatternDetector::PatternType::STILL_LIFE);
+
+        PatternDetector blinker = runPattern("blinker", 6, verify);
+        REQUIRE(blinker.getPatternType() == PatternDetector::PatternType::OSCILLATOR);
+        REQUIRE(blinker.getOscillatorPeriod() == 2);
+
+        PatternDetector pulsar = runPattern("pulsar", 9, verify);
+        REQUIRE(pulsar.getPatternType() == PatternDetector::PatternType::OSCILLATOR);
+        REQUIRE(pulsar.getOscillatorPeriod() == 3);
+    }
+}
+
+TEST_CASE("PatternDetector reports spaceship period and velocity", "[patterns][spaceship]") {
+    for (bool tracking : {false, true}) {
+        INFO("tracking " << tracking);
+        PatternDetector glider = runPattern("glider", 12, false, tracking);
+        REQUIRE(glider.getPatternType() == PatternDetector::PatternType::SPACESHIP);
+        REQUIRE(glider.getOscillatorPeriod() == 4);
+        REQUIRE(glider.getSpaceshipDx() == 1);
+        REQUIRE(glider.getSpaceshipDy() == 1);
+
+        PatternDetector lwss = runPattern("lwss", 12, false, tracking);
+        REQUIRE(lwss.getPatternType() == PatternDetector::PatternType::SPACESHIP);
+        REQUIRE(lwss.getOscillatorPeriod() == 4);
+        REQUIRE(lwss.getSpaceshipDx() == -2);
+        REQUIRE(lwss.getSpaceshipDy() == 0);
+
+        // Translation alone must not make an oscillator look like a spaceship
+        PatternDetector blinker = runPattern("blinker", 6, false, tracking);
+        REQUIRE(blinker.getPatternType() == PatternDetector::PatternType::OSCILLATOR);
+    }
+}
+
+TEST_CASE("Glider keeps its velocity across a toroidal wrap", "[patterns][spaceship]") {
+    PatternLibrary library;
+    Grid grid(24, 70);
+    library.insertPattern(grid, "glider", 2, 2);
+    GameEngine engine(grid, true);
+    engine.setBackend(GameEngine::Backend::Incremental);
+    PatternDetector detector;
+    for (int gen = 0; gen < 200; ++gen) {
+        engine.step();
+        detector.update(engine);
+        if (detector.getPatternType() == PatternDetector::PatternType::SPACESHIP) {
+            // Matches around the seam span several periods: c/4 either way
+            int period = detector.getOscillatorPeriod();
+            REQUIRE(period % 4 == 0);
+            REQUIRE(detector.getSpaceshipDx() * 4 == period);
+            REQUIRE(detector.getSpaceshipDy() * 4 == period);
+        }
+    }
+    REQUIRE(detector.getPatternType() == PatternDetector::PatternType::SPACESHIP);
+}
+
+TEST_CASE("PatternDetector grid and engine updates agree", "[patterns]") {
+    for (bool tracking : {false, true}) {
+        INFO("tracking " << tracking);
+        GameEngine engine(randomGrid(64, 64, 0.3, 11u), true);
+        engine.setChangeTracking(tracking);
+        PatternDetector fromEngine;
+        PatternDetector fromGrid;
+        // Runs well past the point where the seen-state table starts over
+        for (int gen = 0; gen < 1500; ++gen) {
+            engine.step();
+            fromEngine.update(engine);
+            fromGrid.update(engine.getCurrentGrid(), engine.getGeneration(), true);
+            REQUIRE(fromEngine.getPatternType() == fromGrid.getPatternType());
+            REQUIRE(fromEngine.getOscillatorPeriod() == fromGrid.getOscillatorPeriod());
+            REQUIRE(fromEngine.getSpaceshipDx() == fromGrid.getSpaceshipDx());
+            REQUIRE(fromEngine.getSpaceshipDy() == fromGrid.getSpaceshipDy());
+        }
+    }
+}
+
+TEST_CASE("PatternCensus names objects in any orientation and phase", "[patterns][census]") {
+    Grid grid(64, 200);
+    stamp(grid, 2, 2, {"##", "##"});                       // block
+    stamp(grid, 2, 10, {"##", "##"});                      // block across no word edge
+    stamp(grid, 2, 62, {"##", "##"});                      // block across a word edge
+    stamp(grid, 10, 2, {"###"});                           // blinker
+    stamp(grid, 10, 10, {"#", "#", "#"});                  // blinker, other phase
+    stamp(grid, 20, 2, {".#.", "..#", "###"});             // glider
+    stamp(grid, 20, 10, {"#.#", ".##", ".#."});            // glider, next phase
+    stamp(grid, 20, 20, {"##.", "#.#", "#.."});            // glider, rotated
+    stamp(grid, 30, 2, {".#.", "#.#", "#.#", ".#."});      // beehive, upright
+    stamp(grid, 30, 10, {".##.", "#..#", "#.#.", ".#.."}); // loaf, mirrored
+    stamp(grid, 40, 2, {".#..#", "#....", "#...#", "####."}); // lwss
+    stamp(grid, 40, 120, {"#...#", ".....", ".....", ".....", "#...#"}); // four lone cells
+    stamp(grid, 50, 20, {"#", ".", "#"});                  // two cells, one island
+    stamp(grid, 50, 2, {"##", "#."});                      // pre-block: unknown
+
+    for (int threads : {1, 4}) {
+        INFO("threads " << threads);
+        PatternCensus census(PatternLibrary(), threads);
+        Census result = census.take(grid);
+        REQUIRE(result.islands == 17);
+        REQUIRE(result.count("block") == 3);
+        REQUIRE(result.count("blinker") == 2);
+        REQUIRE(result.count("glider") == 3);
+        REQUIRE(result.count("beehive") == 1);
+        REQUIRE(result.count("loaf") == 1);
+        REQUIRE(result.count("lwss") == 1);
+        REQUIRE(result.count("unknown") == 6);
+        REQUIRE(result.summary() == "6 unknown, 3 blocks, 3 gliders, 2 blinkers, 1 beehive, 1 loaf, 1 lwss");
+    }
+    REQUIRE(PatternCensus().take(Grid(8, 8)).summary() == "empty");
+}
+
+TEST_CASE("PatternCensus islands match a flood fill", "[patterns][census]") {
+    PatternCensus serial;
+    PatternCensus threaded(PatternLibrary(), 4);
+    for (unsigned seed = 1; seed <= 6; ++seed) {
+        // Sparse to dense: many small islands down to a few sprawling ones
+        Grid grid = randomGrid(97, 140 + seed, seed * seed / 40.0, seed);
+        INFO("seed " << seed);
+        int expected = floodFillIslands(grid);
+        REQUIRE(serial.take(grid).islands == expected);
+        REQUIRE(threaded.take(grid).islands == expected);
+    }
+}
+
+TEST_CASE("PatternCensus counts a million islands", "[patterns][census]") {
+    // Blocks every 4 cells in both directions: 1024 * 1024 islands
+    Grid grid(4096, 4096);
+    for (int row = 0; row < 4096; row += 4) {
+        Grid::Word* top = grid.rowWords(row);
+        Grid::Word* bottom = grid.rowWords(row + 1);
+        for (int w = 0; w < grid.getWordsPerRow(); ++w) {
+            top[w] = bottom[w] = 0x3333333333333333ull;
+        }
+    }
+    PatternCensus census(PatternLibrary(), 0);
+    Census result = census.take(grid);
+    REQUIRE(result.islands == 1024 * 1024);
+    REQUIRE(result.count("block") == 1024 * 1024);
+}
@@ -0,0 +1,120 @@
+/**
+ * @file test_rle.cpp
+ * @brief Tests for reading and writing RLE pattern files
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "../Grid.hpp"
+#include "../TextFileIO.hpp"
+#include "TestHelpers.hpp"
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+TEST_CASE("RLE reader parses headers, comments and runs", "[io][rle]") {
+    const std::string path = "test_rle.rle";
+    writeFile(path, "#N Glider\r\n#C A comment line\r\nx = 5, y = 4, rule = B3/S23\r\nbo$2bo$3o!\r\n");
+
+    TextFileIO fileIO;
+    std::unique_ptr<Grid> grid = fileIO.loadGrid(path);
+    REQUIRE(grid->getRows() == 4);
+    REQUIRE(grid->getCols() == 5);
+    REQUIRE(grid->countLiving() == 5);
+    REQUIRE(grid->getCell(0, 1));
+    REQUIRE(grid->getCell(1, 2));
+    REQUIRE(grid->getCell(2, 0));
+    REQUIRE(grid->getCell(2, 1));
+    REQUIRE(grid->getCell(2, 2));
+    REQUIRE(fileIO.loadRule(path) == "B3/S23");
+
+    // Runs spanning several words, line breaks inside the body, blank rows
+    writeFile(path, "x = 300, y = 5\n10b190o$\n3$299b\no!");
+    grid = fileIO.loadGrid(path);
+    REQUIRE(grid->countLiving() == 191);
+    REQUIRE_FALSE(grid->getCell(0, 9));
+    REQUIRE(grid->getCell(0, 10));
+    REQUIRE(grid->getCell(0, 199));
+    REQUIRE_FALSE(grid->getCell(0, 200));
+    REQUIRE(grid->getCell(4, 299));
+    REQUIRE(fileIO.loadRule(path).empty());
+
+    // Legacy "#r" rule lines and Golly's topology suffix
+    writeFile(path, "#r 23/36\nx = 2, y = 2\n2o$2o!");
+    REQUIRE(fileIO.loadRule(path) == "23/36");
+    writeFile(path, "x = 2, y = 2, rule = B36/S23:T2,2\n2o$2o!");
+    REQUIRE(fileIO.loadRule(path) == "B36/S23");
+    std::remove(path.c_str());
+}
+
+TEST_CASE("RLE reader rejects malformed files", "[io][rle]") {
+    const std::string path = "test_rle.rle";
+    TextFileIO fileIO;
+
+    writeFile(path, "x = 3, y = 3\n4o!");
+    REQUIRE_THROWS_AS(fileIO.loadGrid(path), std::runtime_error);
+    writeFile(path, "x = 3, y = 3\n$$$o!");
+    REQUIRE_THROWS_AS(fileIO.loadGrid(path), std::runtime_error);
+    writeFile(path, "x = 3\n3o!");
+    REQUIRE_THROWS_AS(fileIO.loadGrid(path), std::runtime_error);
+    writeFile(path, "x = 3, y = 3\n3z!");
+    REQUIRE_THROWS_AS(fileIO.loadGrid(path), std::runtime_error);
+    writeFile(path, "#C only a comment\n");
+    REQUIRE_THROWS_AS(fileIO.loadGrid(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("RLE writer round-trips grids", "[io][rle]") {
+    const std::string path = "test_rle.rle";
+    TextFileIO fileIO;
+
+    for (int cols : {1, 63, 64, 65, 200}) {
+        Grid grid = randomGrid(37, cols, 0.3, static_cast<unsigned>(cols));
+        grid.setCell(0, cols - 1, true);
+        for (int col = 0; col < cols; ++col) {
+            grid.setCell(20, col, true);   // A run as wide as the grid
+            grid.setCell(36, col, false);  // Trailing blank row kept by the header
+        }
+        fileIO.saveGrid(grid, path, Rule::parse("highlife"));
+        REQUIRE(*fileIO.loadGrid(path) == grid);
+        REQUIRE(fileIO.loadRule(path) == "B36/S23");
+
+        std::istringstream lines(readFile(path));
+        std::string line;
+        while (std::getline(lines, line)) {
+            REQUIRE(line.size() <= 70);
+        }
+    }
+
+    Grid glider(3, 3);
+    glider.setCell(0, 1, true);
+    glider.setCell(1, 2, true);
+    glider.setCell(2, 0, true);
+    glider.setCell(2, 1, true);
+    glider.setCell(2, 2, true);
+    fileIO.saveGrid(glider, path);
+    REQUIRE(readFile(path) == "x = 3, y = 3, rule = B3/S23\nbo$2bo$3o!\n");
+
+    Grid empty(4, 4);
+    fileIO.saveGrid(empty, path);
+    REQUIRE(readFile(path) == "x = 4, y = 4, rule = B3/S23\n!\n");
+    REQUIRE(*fileIO.loadGrid(path) == empty);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Grid file methods keep to the matrix format", "[io][rle][grid]") {
+    const std::string path = "test_grid.txt";
+    Grid grid = randomGrid(50, 90, 0.3, 7u);
+    REQUIRE(grid.saveToFile(path));
+    REQUIRE(readFile(path).rfind("50 90\n", 0) == 0);
+    REQUIRE(*TextFileIO().loadGrid(path) == grid);
+
+    // RLE goes through TextFileIO; the grid is left untouched
+    TextFileIO().saveGrid(randomGrid(5, 5, 0.3, 8u), path + ".rle");
+    Grid loaded(3, 3);
+    REQUIRE(loaded.loadFromFile(path));
+    REQUIRE(loaded == grid);
+    REQUIRE_FALSE(loaded.loadFromFile(path + ".rle"));
+    REQUIRE(loaded == grid);
+    std::remove(path.c_str());
+    std::remove((path + ".rle").c_str());
+}
@@ -232,6 +232,60 @@ TEST_CASE("GameEngine generation counter", "[engine]") {
     }
 }
 
+TEST_CASE("B/S rule notation", "[rules][notation]") {
+    SECTION("Conway is the default") {
+        REQUIRE(Rule().toString() == "B3/S23");
+        REQUIRE(Rule().isConway());
+        REQUIRE(GameEngine(4, 4).getRule() == Rule());
+    }
+    
+    SECTION("Accepted spellings") {
+        REQUIRE(Rule::parse("B36/S23").toString() == "B36/S23");
+        REQUIRE(Rule::parse("b36/s23") == Rule::parse("B36/S23"));
+        REQUIRE(Rule::parse("S23/B36") == Rule::parse("B36/S23"));
+        REQUIRE(Rule::parse("23/36") == Rule::parse("B36/S23"));  // Legacy survival/birth
+        REQUIRE(Rule::parse("B2/S").toString() == "B2/S");
+        REQUIRE(Rule::parse("HighLife") == Rule::parse("B36/S23"));
+        REQUIRE(Rule::parse("daynight").toString() == "B3678/S34678");
+    }
+    
+    SECTION("Every named rule parses") {
+        for (const std::string& name : Rule::namedRules()) {
+            REQUIRE_NOTHROW(Rule::parse(name));
+        }
+    }
+    
+    SECTION("Invalid rules are rejected") {
+        REQUIRE_THROWS_AS(Rule::parse("B9/S23"), std::invalid_argument);
+        REQUIRE_THROWS_AS(Rule::parse("B33/S23"), std::invalid_argument);
+        REQUIRE_THROWS_AS(Rule::parse("B3S23"), std::invalid_argument);
+        REQUIRE_THROWS_AS(Rule::parse("X3/S23"), std::invalid_argument);
+        REQUIRE_THROWS_AS(Rule::parse("nosuchrule"), std::invalid_argument);
+    }
+}
+
+TEST_CASE("HighLife replicator", "[rules][highlife]") {
+    // The replicator makes two copies of itself every 12 generations
+    Grid start(64, 64);
+    const int cells[][2] = {{30, 31}, {30, 32}, {30, 33}, {31, 30}, {31, 33},
+                            {32, 29}, {32, 33}, {33, 29}, {33, 32}, {34, 29}, {34, 30}, {34, 31}};
+    for (const auto& cell : cells) {
+        start.setCell(cell[0], cell[1], true);
+    }
+    
+    GameEngine highlife(start);
+    highlife.setRule(Rule::parse("B36/S23"));
+    GameEngine reference(start);
+    reference.setRule(Rule::parse("B36/S23"));
+    reference.setBackend(GameEngine::Backend::Reference);
+    for (int gen = 0; gen < 12; ++gen) {
+        highlife.step();
+        reference.step();
+    }
+    REQUIRE(highlife.getCurrentGrid() == reference.getCurrentGrid());
+    REQUIRE(highlife.getCurrentGrid().countLiving() == 24);  // Two copies
+}
+
 TEST_CASE("Edge cases", "[edge-cases]") {
     SECTION("Empty grid stays empty") {
         GameEngine engine(10, 10);
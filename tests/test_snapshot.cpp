@@ -0,0 +1,149 @@
+/**
+ * @file test_snapshot.cpp
+ * @brief Tests for binary snapshots and memory-mapped grid storage
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "../Grid.hpp"
+#include "../GameEngine.hpp"
+#include "../TextFileIO.hpp"
+#include "../include/BinarySnapshot.hpp"
+#include "TestHelpers.hpp"
+#include <cstdio>
+#include <string>
+
+TEST_CASE("Binary snapshots round-trip grid, rule, generation and topology", "[snapshot][io]") {
+    const std::string path = "test_snapshot.golb";
+    for (int cols : {1, 64, 130}) {
+        Grid grid = randomGrid(37, cols, 0.3, static_cast<unsigned>(cols));
+        BinarySnapshot::save(grid, path, Rule::parse("highlife"), 1234567890123ull, true);
+        REQUIRE(BinarySnapshot::isSnapshot(path));
+
+        // 64-byte aligned payload of rows + 1 rows, the last one the zero row
+        std::size_t payloadBytes = static_cast<std::size_t>(38) * grid.getWordsPerRow() * sizeof(Grid::Word);
+        std::string bytes = readFile(path);
+        REQUIRE((bytes.size() - payloadBytes) % 64 == 0);
+        REQUIRE(bytes.compare(0, 4, "GOLB") == 0);
+
+        Snapshot snapshot = BinarySnapshot::load(path);
+        REQUIRE(snapshot.grid.hasExternalStorage());
+        REQUIRE(snapshot.grid == grid);
+        REQUIRE(snapshot.grid.countLiving() == grid.countLiving());
+        REQUIRE(snapshot.rule == Rule::parse("B36/S23"));
+        REQUIRE(snapshot.generation == 1234567890123ull);
+        REQUIRE(snapshot.toroidal);
+    }
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Mapped grids are private copy-on-write views", "[snapshot][io]") {
+    const std::string path = "test_snapshot.golb";
+    Grid original = randomGrid(50, 200, 0.3, 3u);
+    BinarySnapshot::save(original, path);
+
+    Snapshot snapshot = BinarySnapshot::load(path);
+    snapshot.grid.toggleCell(10, 100);
+    Grid copy = snapshot.grid;  // Copies are owned and keep the edit
+    REQUIRE_FALSE(copy.hasExternalStorage());
+    REQUIRE(copy == snapshot.grid);
+    REQUIRE_FALSE(copy == original);
+
+    snapshot.grid.clear();
+    REQUIRE(snapshot.grid.countLiving() == 0);
+    REQUIRE(copy.countLiving() > 0);
+    REQUIRE(BinarySnapshot::load(path).grid == original);  // The file is untouched
+
+    Grid moved = std::move(snapshot.grid);
+    REQUIRE(moved.hasExternalStorage());
+    Grid owned(2, 2);
+    owned = moved;
+    REQUIRE_FALSE(owned.hasExternalStorage());
+    REQUIRE(owned == moved);
+
+#ifndef _WIN32
+    // Saving over a mapped snapshot replaces the file instead of truncating it under the grid
+    Grid mapped = BinarySnapshot::load(path).grid;
+    BinarySnapshot::save(Grid(3, 3), path);
+    REQUIRE(mapped == original);
+    REQUIRE(BinarySnapshot::load(path).grid == Grid(3, 3));
+#endif
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Engines step mapped grids like owned ones", "[snapshot][engine]") {
+    const std::string path = "test_snapshot.golb";
+    Grid soup = randomGrid(96, 150, 0.3, 11u);
+    BinarySnapshot::save(soup, path);
+
+    for (auto backend : {GameEngine::Backend::BitParallel, GameEngine::Backend::Incremental}) {
+        GameEngine fromFile(std::move(BinarySnapshot::load(path).grid), true);
+        // Stepped in place, with a second mapping to reset to
+        REQUIRE(fromFile.getCurrentGrid().hasExternalStorage());
+        REQUIRE(fromFile.getInitialGrid().hasExternalStorage());
+        GameEngine inMemory(soup, true);
+        fromFile.setBackend(backend);
+        inMemory.setBackend(backend);
+        for (int gen = 0; gen < 40; ++gen) {
+            fromFile.step();
+            inMemory.step();
+        }
+        REQUIRE(fromFile.getCurrentGrid() == inMemory.getCurrentGrid());
+        fromFile.reset();
+        REQUIRE(fromFile.getCurrentGrid() == soup);
+        fromFile.step();
+        fromFile.reset();
+        REQUIRE(fromFile.getCurrentGrid() == soup);
+    }
+
+    // Engine snapshots keep the generation and topology for resuming
+    GameEngine engine(soup, true);
+    engine.setRule(Rule::parse("B36/S23"));
+    for (int gen = 0; gen < 7; ++gen) {
+        engine.step();
+    }
+    BinarySnapshot::save(engine, path);
+    Snapshot resumed = BinarySnapshot::load(path);
+    REQUIRE(resumed.generation == 7);
+    REQUIRE(resumed.toroidal);
+    REQUIRE(resumed.rule == engine.getRule());
+    REQUIRE(resumed.grid == engine.getCurrentGrid());
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Binary snapshot loading rejects damaged files", "[snapshot][io]") {
+    const std::string path = "test_snapshot.golb";
+    BinarySnapshot::save(randomGrid(20, 70, 0.3, 5u), path);
+    std::string bytes = readFile(path);
+
+    writeFile(path, bytes.substr(0, bytes.size() - 8));
+    REQUIRE_THROWS_AS(BinarySnapshot::load(path), std::runtime_error);
+
+    std::string newer = bytes;
+    newer[4] = 2;  // Version
+    writeFile(path, newer);
+    REQUIRE_THROWS_AS(BinarySnapshot::load(path), std::runtime_error);
+
+    std::string wrongMagic = bytes;
+    wrongMagic[0] = 'X';
+    writeFile(path, wrongMagic);
+    REQUIRE_FALSE(BinarySnapshot::isSnapshot(path));
+    REQUIRE_THROWS_AS(BinarySnapshot::load(path), std::runtime_error);
+
+    writeFile(path, "GOLB");
+    REQUIRE_THROWS_AS(BinarySnapshot::load(path), std::runtime_error);
+    REQUIRE_THROWS_AS(BinarySnapshot::load("missing_snapshot.golb"), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("File loaders recognise binary snapshots", "[snapshot][io]") {
+    const std::string path = "test_snapshot.GOLB";
+    Grid grid = randomGrid(30, 90, 0.3, 9u);
+    TextFileIO fileIO;
+    fileIO.saveGrid(grid, path, Rule::parse("daynight"));
+    REQUIRE(BinarySnapshot::isSnapshot(path));
+    REQUIRE(*fileIO.loadGrid(path) == grid);
+    REQUIRE(fileIO.loadGrid(path)->hasExternalStorage());
+    REQUIRE(fileIO.loadRule(path) == Rule::parse("daynight").toString());
+    REQUIRE(fileIO.loadStates(path)->toGrid() == grid);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,125 @@
+/**
+ * @file test_sparse.cpp
+ * @brief Tests for the unbounded chunked SparseUniverse
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "../Grid.hpp"
+#include "../GameEngine.hpp"
+#include "../include/SparseUniverse.hpp"
+#include "TestHelpers.hpp"
+
+namespace {
+
+// Glider heading south-east, top-left of its bounding box at (top, left)
+void placeGlider(SparseUniverse& universe, std::int64_t top, std::int64_t left) {
+    universe.setCell(top, left + 1, true);
+    universe.setCell(top + 1, left + 2, true);
+    universe.setCell(top + 2, left, true);
+    universe.setCell(top + 2, left + 1, true);
+    universe.setCell(top + 2, left + 2, true);
+}
+
+} // namespace
+
+TEST_CASE("SparseUniverse cell access", "[sparse]") {
+    SparseUniverse universe;
+    REQUIRE(universe.getChunkCount() == 0);
+
+    universe.setCell(-1, -1, true);
+    universe.setCell(10000000000LL, -20000000000LL, true);
+    REQUIRE(universe.getCell(-1, -1));
+    REQUIRE(universe.getCell(10000000000LL, -20000000000LL));
+    REQUIRE_FALSE(universe.getCell(0, 0));
+    REQUIRE(universe.getChunkCount() == 2);
+    REQUIRE(universe.getPopulation() == 2);
+
+    // Emptied chunks are released immediately
+    universe.setCell(-1, -1, false);
+    REQUIRE(universe.getChunkCount() == 1);
+    REQUIRE_THROWS_AS(universe.setCell(SparseUniverse::kCoordinateLimit, 0, true), std::out_of_range);
+}
+
+TEST_CASE("SparseUniverse matches the grid engine away from the edges", "[sparse]") {
+    // The soup straddles chunk boundaries at a negative offset and cannot
+    // reach the grid border within 40 generations
+    Grid start(200, 200);
+    Grid soup = randomGrid(80, 80, 0.4, 17u);
+    for (int row = 60; row < 140; ++row) {
+        for (int col = 60; col < 140; ++col) {
+            start.setCell(row, col, soup.getCell(row - 60, col - 60));
+        }
+    }
+
+    const std::int64_t top = -100;
+    const std::int64_t left = -37;
+    SparseUniverse universe(start, top, left);
+    GameEngine reference(start, false);
+    REQUIRE(universe.toGrid(200, 200, top, left) == start);
+
+    for (int gen = 0; gen < 40; ++gen) {
+        universe.step();
+        reference.step();
+        REQUIRE(universe.toGrid(200, 200, top, left) == reference.getCurrentGrid());
+        REQUIRE(universe.getPopulation() == static_cast<std::uint64_t>(reference.getCurrentGrid().countLiving()));
+    }
+}
+
+TEST_CASE("SparseUniverse follows a glider with constant memory", "[sparse]") {
+    SparseUniverse universe;
+    placeGlider(universe, -200, -200);
+
+    // 4000 generations move the glider (1000, 1000) across the origin
+    for (int gen = 0; gen < 4000; ++gen) {
+        universe.step();
+        REQUIRE(universe.getChunkCount() <= 4);
+    }
+    REQUIRE(universe.getGeneration() == 4000);
+    REQUIRE(universe.getPopulation() == 5);
+
+    std::int64_t top, left, bottom, right;
+    REQUIRE(universe.getBounds(top, left, bottom, right));
+    REQUIRE(top == 800);
+    REQUIRE(left == 800);
+    REQUIRE(bottom == 802);
+    REQUIRE(right == 802);
+}
+
+TEST_CASE("SparseUniverse drops chunks that die out", "[sparse]") {
+    SparseUniverse universe;
+    universe.setCell(63, 63, true);  // Lone cell at a chunk corner
+    universe.setCell(64, 64, true);
+    universe.step();
+    REQUIRE(universe.getPopulation() == 0);
+    REQUIRE(universe.getChunkCount() == 0);
+
+    std::int64_t top, left, bottom, right;
+    REQUIRE_FALSE(universe.getBounds(top, left, bottom, right));
+}
+
+TEST_CASE("SparseUniverse does not wrap around its edges", "[sparse]") {
+    const std::int64_t limit = SparseUniverse::kCoordinateLimit;
+    SparseUniverse universe;
+    // An L tromino split across the bottom and top edges (it would become
+    // a block if they touched), and one split across the right and left
+    universe.setCell(limit - 1, 0, true);
+    universe.setCell(limit - 1, 1, true);
+    universe.setCell(-limit, 0, true);
+    universe.setCell(0, limit - 1, true);
+    universe.setCell(1, limit - 1, true);
+    universe.setCell(0, -limit, true);
+    // A block in the far corner only sees dead cells past the edges
+    universe.setCell(-limit, -limit, true);
+    universe.setCell(-limit, -limit + 1, true);
+    universe.setCell(-limit + 1, -limit, true);
+    universe.setCell(-limit + 1, -limit + 1, true);
+
+    universe.step();
+    REQUIRE(universe.getPopulation() == 4);
+    REQUIRE(universe.getCell(-limit, -limit));
+    REQUIRE(universe.getCell(-limit + 1, -limit + 1));
+    REQUIRE_FALSE(universe.getCell(limit - 1, 0));
+    REQUIRE_FALSE(universe.getCell(-limit, 1));
+    REQUIRE_FALSE(universe.getCell(1, -limit));
+    REQUIRE(universe.getChunkCount() == 1);
+}